@@ -191,118 +191,156 @@ UENet6NetworkSubsystem::Tick(float DeltaTime)
 
   if (Host == nullptr)
     return;
-  auto Event = ENetEvent();
-  if (enet_host_service(Host, &Event, NET_TIMEOUT) > 0) {
-    do {
-      switch (Event.type) {
-        case ENetEventType::ENET_EVENT_TYPE_CONNECT: {
-          UE_LOG(ENet6,
-                 Log,
-                 TEXT("Peer %u connected!"),
-                 enet_peer_get_id(Event.peer));
-        } break;
-        case ENetEventType::ENET_EVENT_TYPE_DISCONNECT: {
-          UE_LOG(ENet6,
-                 Log,
-                 TEXT("Peer %u disconnected!"),
-                 enet_peer_get_id(Event.peer));
-        } break;
-        case ENetEventType::ENET_EVENT_TYPE_RECEIVE: {
-          UE_LOG(ENet6,
-                 Log,
-                 TEXT("Peer %u sent data (%u bytes)"),
-                 enet_peer_get_id(Event.peer),
-                 enet_packet_get_length(Event.packet));
-          auto len = Event.packet->dataLength;
-          auto bytes = std::vector<uint8_t>(len);
-          memcpy(bytes.data(), Event.packet->data, len);
-          HandleMessage(bytes);
-          enet_packet_dispose(Event.packet);
-        } break;
-      }
-    } while (enet_host_check_events(Host, &Event) > 0);
-  }
+  auto event = ReceivedEvent();
+  while (Received.Pop(event))
+    switch (event.Type) {
+      case ENetEventType::ENET_EVENT_TYPE_CONNECT: {
+        UE_LOG(ENet6, Log, TEXT("Server connected!"));
+      } break;
+      case ENetEventType::ENET_EVENT_TYPE_DISCONNECT: {
+        UE_LOG(ENet6, Log, TEXT("Server disconnected!"));
+      } break;
+      case ENetEventType::ENET_EVENT_TYPE_RECEIVE: {
+        UE_LOG(ENet6,
+               Log,
+               TEXT("Server sent data (%u bytes)"),
+               enet_packet_get_length(event.Packet));
+        HandleMessage(event.Packet, event.ArrivalTime);
+        enet_packet_dispose(event.Packet);
+      } break;
+    }
 
   {
     gameData.Input.Pitch = _planeData._currPitchValue;
     gameData.Input.Yaw = _planeData._currYawValue;
     gameData.Input.Roll = _planeData._currRollValue;
   }
-  {
-    auto packet = PlayerInputPacket();
-    packet.Input = gameData.Input;
-    packet.Input.Index = gameData.InputIndex++;
-    enet_peer_send(
-      ServerPeer, 0, BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE));
+  // Inputs are sampled and predicted at the server tick rate, a long hitch
+  // only sends the inputs the redundancy window can still carry
+  gameData.InputAccumulator = std::min(gameData.InputAccumulator +
+                                         DeltaTime * 1000.f,
+                                       float(NET_TICK * INPUT_REDUNDANCY));
+  while (gameData.InputAccumulator >= NET_TICK) {
+    gameData.InputAccumulator -= NET_TICK;
 
+    auto input = QuantizeInput(gameData.Input);
+    input.Index = gameData.InputIndex++;
+
+    auto predictedInput = PredictedInput();
+    predictedInput.Input = input;
     auto it = std::find_if(
       gameData.Players.begin(), gameData.Players.end(), [&](const auto& p) {
         return p.Index == gameData.OwnPlayerIndex;
       });
     if (it != gameData.Players.end()) {
-      auto& player = *it;
-      ComputePhysics(player, packet.Input, DeltaTime);
-      auto position = player.Position;
-      _planePawn->SetActorLocation(FVector(position.x, position.y, position.z));
+      ComputePhysics(*it, input, NET_TICK);
+      predictedInput.Position = it->Position;
     }
+    gameData.PredictedInputs.Push(predictedInput);
 
-    auto predictedInput = PredictedInput();
-    predictedInput.Input = packet.Input;
-    gameData.PredictedInputs.push_back(predictedInput);
+    // Every input the server hasn't acknowledged yet, up to the window size
+    auto& predicted = gameData.PredictedInputs;
+    auto count = std::min<size_t>(predicted.Size(), INPUT_REDUNDANCY);
+    auto packet = PlayerInputPacket();
+    for (auto i = predicted.Size() - count; i < predicted.Size(); i++)
+      packet.Inputs.push_back(predicted[i].Input);
+    packet.AckTickIndex = gameData.LastSnapshotTickIndex;
+    Send(BuildPacket(packet, ENET_PACKET_FLAG_UNSEQUENCED));
+
+    if (input.Index % CLOCK_PING_INTERVAL_TICKS == 1) {
+      auto ping = PingPacket();
+      ping.ClientTime = ClockStamp(FPlatformTime::Seconds());
+      Send(BuildPacket(ping, ENET_PACKET_FLAG_UNSEQUENCED));
+    }
   }
 
   {
-    if (gameData.InterpolationBuffer.size() >= 2) {
-      auto& from = gameData.InterpolationBuffer[0];
-      auto& to = gameData.InterpolationBuffer[1];
-
-      auto packetDiff = to.TickIndex - from.TickIndex;
-
-      auto interpolationIncr = DeltaTime / NET_TICK;
-      interpolationIncr /= packetDiff;
-
-      if (gameData.InterpolationBuffer.size() >= TargetInterpolationBufferSize)
-        interpolationIncr *= 1.f + 0.2f * (gameData.InterpolationBuffer.size() -
-                                           TargetInterpolationBufferSize);
-      else
-        interpolationIncr *=
-          std::fmaxf(1.f - 0.2f * (TargetInterpolationBufferSize -
-                                   gameData.InterpolationBuffer.size()),
-                     0.f);
-
-      for (const auto& fromPlayer : from.Players) {
-        auto playerIt = std::find_if(
-          gameData.Players.begin(), gameData.Players.end(), [&](const auto& p) {
-            return p.Index == fromPlayer.PlayerIndex;
-          });
-        if (playerIt == gameData.Players.end())
-          continue;
-        auto& player = *playerIt;
-
-        if (fromPlayer.PlayerIndex == gameData.OwnPlayerIndex)
-          continue;
+    auto& correction = gameData.Correction;
+    correction = correction * std::exp(-DeltaTime / CORRECTION_TIME);
+    auto it = std::find_if(
+      gameData.Players.begin(), gameData.Players.end(), [&](const auto& p) {
+        return p.Index == gameData.OwnPlayerIndex;
+      });
+    if (it != gameData.Players.end() && _planePawn != nullptr) {
+      auto position = it->Position + correction;
+      _planePawn->SetActorLocation(FVector(position.x, position.y, position.z));
+    }
+  }
 
-        auto toIt = std::find_if(
-          to.Players.begin(), to.Players.end(), [&](const auto& p) {
-            return p.PlayerIndex == fromPlayer.PlayerIndex;
-          });
-        if (toIt == to.Players.end())
+  // Nothing is drawn until the first pong, snapshots are buffered meanwhile.
+  // The render tick never goes back, a clock correction that would pull it
+  // back holds it instead
+  auto& buffer = gameData.InterpolationBuffer;
+  if (gameData.Clock.IsSynchronized() && !buffer.Empty()) {
+    auto delay = gameData.Delay.Advance(DeltaTime * CLOCK_TICKS_PER_SECOND);
+    auto renderTick =
+      gameData.Clock.ServerTick(FPlatformTime::Seconds()) - delay;
+    gameData.RenderTick = std::max(gameData.RenderTick, renderTick);
+    while (buffer.Size() >= 2 && buffer[1].TickIndex <= gameData.RenderTick)
+      buffer.Pop();
+
+    // Past the newest snapshot the players are dead reckoned from it, for a
+    // bounded time so that a long gap doesn't fly them off course
+    const auto& from = buffer[0];
+    const auto* to = buffer.Size() >= 2 ? &buffer[1] : nullptr;
+    auto elapsed = gameData.RenderTick - from.TickIndex;
+    auto span = to ? static_cast<double>(to->TickIndex - from.TickIndex) : 0.;
+    auto alpha = 0.f;
+    auto extrapolated = 0.f;
+    if (to != nullptr)
+      alpha = static_cast<float>(std::clamp(elapsed / span, 0., 1.));
+    else
+      extrapolated = std::clamp(
+        static_cast<float>(elapsed), 0.f, EXTRAPOLATION_MAX_TICKS);
+    gameData.ViewTick = from.TickIndex + alpha * span + extrapolated;
+
+    for (const auto& fromPlayer : from.Players) {
+      auto playerIt = std::find_if(
+        gameData.Players.begin(), gameData.Players.end(), [&](const auto& p) {
+          return p.Index == fromPlayer.PlayerIndex;
+        });
+      if (playerIt == gameData.Players.end())
+        continue;
+      auto& player = *playerIt;
+
+      if (fromPlayer.PlayerIndex == gameData.OwnPlayerIndex)
+        continue;
+
+      auto fromRotation = fromPlayer.Rotation.ToVector3();
+      auto rotation = FRotator(fromRotation.y, fromRotation.z, fromRotation.x);
+      if (to != nullptr) {
+        auto toPlayer = to->Find(fromPlayer.PlayerIndex);
+        if (toPlayer == nullptr)
           continue;
-        auto& toPlayer = *toIt;
-
-        player.Position = FMath::Lerp(
-          fromPlayer.Position, toPlayer.Position, gameData.InterpolationTime);
-        PlayerPositionReceived.Broadcast(
-          player.Index,
-          FVector(player.Position.x, player.Position.y, player.Position.z));
-      }
+        player.Position = HermitePosition(
+          fromPlayer, *toPlayer, static_cast<float>(span), alpha);
+        auto toRotation = toPlayer->Rotation.ToVector3();
+        rotation = FMath::Lerp(
+          rotation, FRotator(toRotation.y, toRotation.z, toRotation.x), alpha);
+      } else
+        player.Position = ExtrapolatePosition(fromPlayer, extrapolated);
+
+      PlayerPositionReceived.Broadcast(
+        player.Index,
+        FVector(player.Position.x, player.Position.y, player.Position.z));
+      player.Rotation = Vector3(rotation.Roll, rotation.Pitch, rotation.Yaw);
+      PlayerRotationReceived.Broadcast(player.Index, rotation);
+    }
 
-      gameData.InterpolationTime += interpolationIncr;
-      if (gameData.InterpolationTime >= 1.f) {
-        gameData.InterpolationBuffer.erase(
-          gameData.InterpolationBuffer.begin());
-        gameData.InterpolationTime -= 1.f;
+    // Projectiles are drawn at the same point in time as remote players,
+    // their position only depends on the spawn and the elapsed ticks
+    auto& projectiles = gameData.Projectiles;
+    for (auto it = projectiles.begin(); it != projectiles.end();) {
+      auto ticks = static_cast<float>(gameData.ViewTick - it->TickIndex);
+      if (ticks > PROJECTILE_LIFETIME_TICKS) {
+        ProjectileDestroyed.Broadcast(it->Spawn.Id);
+        it = projectiles.erase(it);
+        continue;
       }
+      auto position = ProjectilePosition(it->Spawn, std::max(ticks, 0.f));
+      ProjectileMoved.Broadcast(it->Spawn.Id,
+                                FVector(position.x, position.y, position.z));
+      ++it;
     }
   }
 }
@@ -312,6 +350,13 @@ UENet6NetworkSubsystem::Connect(FString AddrStr)
 {
   Disconnect();
 
+  // Tick indices, the clock offset and the buffers all belong to the previous
+  // session, a restarted server, a relay or a replay counts from elsewhere
+  for (const auto& player : gameData.Players)
+    if (player.Index != gameData.OwnPlayerIndex)
+      PlayerLeft.Broadcast(player.Index);
+  gameData = GameData();
+
   auto Address = ENetAddress();
   if (enet_address_set_host(
         &Address, ENET_ADDRESS_TYPE_ANY, TCHAR_TO_UTF8(*AddrStr)) < 0) {
@@ -325,6 +370,8 @@ UENet6NetworkSubsystem::Connect(FString AddrStr)
     UE_LOG(ENet6, Error, TEXT("Failed to initialize host"));
     return false;
   }
+  auto compressor = DatagramCompressor::Make();
+  enet_host_compress(Host, &compressor);
 
   ServerPeer = enet_host_connect(Host, &Address, 0, 0);
   check(ServerPeer);
@@ -342,12 +389,26 @@ UENet6NetworkSubsystem::Connect(FString AddrStr)
   }
 
   UE_LOG(ENet6, Log, TEXT("Connected to %s"), *AddrStr);
+  NetworkRunning.store(true, std::memory_order_release);
+  NetworkThread = std::thread([this] { RunNetwork(); });
   return true;
 }
 
 void
 UENet6NetworkSubsystem::Disconnect()
 {
+  if (NetworkThread.joinable()) {
+    NetworkRunning.store(false, std::memory_order_release);
+    NetworkThread.join();
+  }
+  auto event = ReceivedEvent();
+  while (Received.Pop(event))
+    if (event.Packet != nullptr)
+      enet_packet_dispose(event.Packet);
+  auto packet = static_cast<ENetPacket*>(nullptr);
+  while (Outgoing.Pop(packet))
+    enet_packet_dispose(packet);
+
   if (ServerPeer != nullptr) {
     check(Host);
     enet_peer_disconnect(ServerPeer, 0);
@@ -361,6 +422,78 @@ UENet6NetworkSubsystem::Disconnect()
   }
 }
 
+void
+UENet6NetworkSubsystem::Fire(FVector Direction)
+{
+  if (ServerPeer == nullptr || Direction.IsNearlyZero())
+    return;
+
+  // The server rewinds its hit capsules to the point in time remote players
+  // are drawn at
+  auto packet = FirePacket();
+  packet.ViewTickIndex = gameData.LastSnapshotTickIndex;
+  if (gameData.ViewTick != 0) {
+    auto viewTick = std::floor(gameData.ViewTick);
+    packet.ViewTickIndex = static_cast<uint32_t>(viewTick);
+    packet.ViewFraction = static_cast<float>(gameData.ViewTick - viewTick);
+  }
+  auto direction = Direction.GetSafeNormal();
+  packet.Direction = Vector3(direction.X, direction.Y, direction.Z);
+  Send(BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE));
+}
+
+void
+UENet6NetworkSubsystem::Launch(FVector Direction)
+{
+  if (ServerPeer == nullptr || Direction.IsNearlyZero())
+    return;
+
+  auto packet = LaunchPacket();
+  auto direction = Direction.GetSafeNormal();
+  packet.Direction = Vector3(direction.X, direction.Y, direction.Z);
+  Send(BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE));
+}
+
+// Arrivals are stamped here rather than when the game thread gets to them,
+// and acks go out without waiting for the next frame. While the game thread
+// is too far behind to take more, ENet keeps the events queued
+void
+UENet6NetworkSubsystem::RunNetwork()
+{
+  auto packet = static_cast<ENetPacket*>(nullptr);
+  while (NetworkRunning.load(std::memory_order_acquire)) {
+    auto sent = false;
+    while (Outgoing.Pop(packet)) {
+      if (enet_peer_send(ServerPeer, 0, packet) < 0)
+        enet_packet_dispose(packet);
+      sent = true;
+    }
+    if (sent)
+      enet_host_flush(Host);
+
+    if (Received.Size() >= CLIENT_QUEUE_CAPACITY) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(NET_TIMEOUT));
+      continue;
+    }
+    auto event = ENetEvent();
+    if (enet_host_service(Host, &event, NET_TIMEOUT) <= 0)
+      continue;
+    do
+      Received.Push({ event.type, event.packet, FPlatformTime::Seconds() });
+    while (Received.Size() < CLIENT_QUEUE_CAPACITY &&
+           enet_host_check_events(Host, &event) > 0);
+  }
+}
+
+// Packets are queued for the network thread, dropped once disconnected
+void
+UENet6NetworkSubsystem::Send(ENetPacket* packet)
+{
+  if (!NetworkRunning.load(std::memory_order_relaxed) ||
+      !Outgoing.Push(packet))
+    enet_packet_dispose(packet);
+}
+
 void
 UENet6NetworkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
@@ -373,23 +506,29 @@ UENet6NetworkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 void
 UENet6NetworkSubsystem::Deinitialize()
 {
+  Disconnect();
   enet_deinitialize();
 }
 
 void
-UENet6NetworkSubsystem::HandleMessage(const std::vector<uint8_t>& message)
+UENet6NetworkSubsystem::HandleMessage(const ENetPacket* message,
+                                      double arrivalTime)
 {
-  auto offset = size_t();
-  auto opcode = static_cast<Opcode>(Unserialize_u8(message, offset));
+  auto reader = BitReader(message->data, message->dataLength);
+  auto opcode = static_cast<Opcode>(reader.ReadU8());
 
   switch (opcode) {
     case Opcode::S_GAMEDATA: {
-      auto packet = GameDataPacket::Unserialize(message, offset);
+      auto packet = GameDataPacket::Unserialize(reader);
+      if (reader.Overflowed())
+        break;
       gameData.OwnPlayerIndex = packet.PlayerIndex;
     } break;
 
     case Opcode::S_PLAYERLIST: {
-      auto packet = PlayerListPacket::Unserialize(message, offset);
+      auto packet = PlayerListPacket::Unserialize(reader);
+      if (reader.Overflowed())
+        break;
       for (auto it = gameData.Players.begin(); it != gameData.Players.end();) {
         auto playerIt =
           std::find_if(packet.Players.begin(),
@@ -418,43 +557,117 @@ UENet6NetworkSubsystem::HandleMessage(const std::vector<uint8_t>& message)
     } break;
 
     case Opcode::S_PLAYERPOSITION: {
-      auto packet = PlayersPositionPacket::Unserialize(message, offset);
+      auto packet = PlayersPositionPacket::Unserialize(reader);
+      if (reader.Overflowed() ||
+          packet.TickIndex <= gameData.LastSnapshotTickIndex)
+        break;
       {
-        if (gameData.InterpolationBuffer.empty()) {
-          auto tickIndex = packet.TickIndex;
-          for (auto i = 0; i < TargetInterpolationBufferSize; i++) {
-            packet.TickIndex =
-              tickIndex - (TargetInterpolationBufferSize - i - 1);
-            gameData.InterpolationBuffer.push_back(packet);
-          }
-        } else
-          gameData.InterpolationBuffer.push_back(packet);
-      }
-      {
-        while (!gameData.PredictedInputs.empty() &&
-               gameData.PredictedInputs.front().Input.Index <=
-                 packet.LastInputIndex)
-          gameData.PredictedInputs.erase(gameData.PredictedInputs.begin());
+        auto baseline = gameData.Snapshots.Find(packet.BaselineTickIndex);
+        if (packet.BaselineTickIndex != 0 && baseline == nullptr) {
+          UE_LOG(ENet6,
+                 Warning,
+                 TEXT("Dropping snapshot %u: unknown baseline %u"),
+                 packet.TickIndex,
+                 packet.BaselineTickIndex);
+          break;
+        }
+        auto& snapshot = gameData.Snapshots.Push(packet.TickIndex);
+        ApplySnapshotDelta(
+          baseline, packet.Players, packet.RemovedPlayers, snapshot);
+        gameData.LastSnapshotTickIndex = packet.TickIndex;
+        gameData.InterpolationBuffer.Push(snapshot);
+        if (gameData.Clock.IsSynchronized())
+          gameData.Delay.AddArrival(packet.TickIndex,
+                                    gameData.Clock.ServerTick(arrivalTime));
       }
-      {
-        auto ownPlayerIt = std::find_if(
-          gameData.Players.begin(), gameData.Players.end(), [&](const auto& p) {
-            return p.Index == gameData.OwnPlayerIndex;
+    } break;
+
+    case Opcode::S_PONG: {
+      auto packet = PongPacket::Unserialize(reader);
+      if (reader.Overflowed())
+        break;
+      gameData.Clock.AddSample(ClockStampTime(packet.ClientTime, arrivalTime),
+                               packet.ReceiveTick,
+                               packet.SendTick,
+                               arrivalTime);
+    } break;
+
+    case Opcode::S_HIT: {
+      auto packet = HitPacket::Unserialize(reader);
+      if (reader.Overflowed())
+        break;
+      PlayerHit.Broadcast(packet.ShooterIndex, packet.TargetIndex);
+      if (packet.ProjectileId != 0) {
+        auto& projectiles = gameData.Projectiles;
+        auto it = std::find_if(
+          projectiles.begin(), projectiles.end(), [&](const auto& p) {
+            return p.Spawn.Id == packet.ProjectileId;
           });
-        assert(ownPlayerIt != gameData.Players.end());
-        auto& ownPlayer = *ownPlayerIt;
-
-        if (packet.CurrentPlayerData.has_value()) {
-          auto predictedPosition = ownPlayer.Position;
-          ownPlayer.Position = packet.CurrentPlayerData->Position;
-          for (auto& predictedInput : gameData.PredictedInputs)
-            ComputePhysics(ownPlayer, predictedInput.Input, NET_TICK);
-          auto reconciliatedPosition = ownPlayer.Position;
-          _planePawn->SetActorLocation(FVector(reconciliatedPosition.x,
-                                               reconciliatedPosition.y,
-                                               reconciliatedPosition.z));
+        if (it != projectiles.end()) {
+          projectiles.erase(it);
+          ProjectileDestroyed.Broadcast(packet.ProjectileId);
         }
       }
     } break;
+
+    case Opcode::S_PROJECTILESPAWN: {
+      auto packet = ProjectileSpawnPacket::Unserialize(reader);
+      if (reader.Overflowed())
+        break;
+      for (const auto& spawn : packet.Spawns)
+        gameData.Projectiles.push_back({ spawn, packet.TickIndex });
+    } break;
+
+    case Opcode::S_PLAYERSTATE: {
+      auto packet = PlayerStatePacket::Unserialize(reader);
+      if (reader.Overflowed() ||
+          packet.TickIndex <= gameData.LastStateTickIndex)
+        break;
+      gameData.LastStateTickIndex = packet.TickIndex;
+
+      // The prediction made for the last input the server applied is
+      // compared with the server state. Only a misprediction rewinds to the
+      // server state and replays the inputs it hasn't applied yet
+      auto& predicted = gameData.PredictedInputs;
+      while (!predicted.Empty() &&
+             predicted.Front().Input.Index < packet.LastInputIndex)
+        predicted.Pop();
+      auto mispredicted = true;
+      if (!predicted.Empty() &&
+          predicted.Front().Input.Index == packet.LastInputIndex) {
+        if (packet.CurrentPlayerData.has_value())
+          mispredicted = (predicted.Front().Position -
+                          packet.CurrentPlayerData->Position)
+                           .Length() > RECONCILE_THRESHOLD;
+        predicted.Pop();
+      }
+
+      auto ownPlayerIt = std::find_if(
+        gameData.Players.begin(), gameData.Players.end(), [&](const auto& p) {
+          return p.Index == gameData.OwnPlayerIndex;
+        });
+      if (ownPlayerIt == gameData.Players.end() ||
+          !packet.CurrentPlayerData.has_value())
+        break;
+      auto& ownPlayer = *ownPlayerIt;
+
+      // The client physics doesn't predict the rotation, it is taken as is
+      auto rotation = packet.CurrentPlayerData->Rotation;
+      ownPlayer.Rotation = rotation;
+      _planePawn->SetActorRotation(
+        FRotator(rotation.y, rotation.z, rotation.x));
+      if (!mispredicted)
+        break;
+
+      auto drawnPosition = ownPlayer.Position + gameData.Correction;
+      ownPlayer.Position = packet.CurrentPlayerData->Position;
+      for (auto i = size_t(); i < predicted.Size(); i++) {
+        ComputePhysics(ownPlayer, predicted[i].Input, NET_TICK);
+        predicted[i].Position = ownPlayer.Position;
+      }
+      gameData.Correction = drawnPosition - ownPlayer.Position;
+      if (gameData.Correction.Length() > CORRECTION_MAX_DISTANCE)
+        gameData.Correction = Vector3();
+    } break;
   }
 }
\ No newline at end of file
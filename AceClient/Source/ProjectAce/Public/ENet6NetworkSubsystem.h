@@ -1,15 +1,47 @@
 #pragma once
 
+#include "../../../../AceServer/src/include/ClockSync.h"
+#include "../../../../AceServer/src/include/Compressor.h"
 #include "../../../../AceServer/src/include/Protocol.h"
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include <atomic>
+#include <chrono>
 #include <enet6/enet.h>
+#include <thread>
 
 #include "ENet6NetworkSubsystem.generated.h"
 
+// Packets in flight between the network thread and the game thread, several
+// seconds of traffic so that a hitch doesn't stall the network thread
+constexpr auto CLIENT_QUEUE_CAPACITY = 1024;
+
+// Predictions within RECONCILE_THRESHOLD units of the server state are kept,
+// quantization alone puts them up to 0.87 units off. A correction is then
+// drawn away over CORRECTION_TIME seconds, unless it is a teleport
+constexpr auto RECONCILE_THRESHOLD = 1.f;
+constexpr auto CORRECTION_TIME = .1f;
+constexpr auto CORRECTION_MAX_DISTANCE = 1000.f;
+
+struct ReceivedEvent
+{
+  ENetEventType Type = ENET_EVENT_TYPE_NONE;
+  ENetPacket* Packet = nullptr;
+  // FPlatformTime::Seconds() when the network thread got it
+  double ArrivalTime = 0;
+};
+
+// An input and the position predicted once it was applied
 struct PredictedInput
 {
   PlayerInput Input;
+  Vector3 Position;
+};
+
+struct ClientProjectile
+{
+  ProjectileSpawn Spawn;
+  uint32_t TickIndex = 0;
 };
 
 struct GameData
@@ -21,10 +53,29 @@ struct GameData
 
   PlayerInput Input;
   uint32_t InputIndex = 1;
-  std::vector<PredictedInput> PredictedInputs;
-
-  std::vector<PlayersPositionPacket> InterpolationBuffer;
-  float InterpolationTime = 0.f;
+  float InputAccumulator = 0.f;
+  RingBuffer<PredictedInput, PREDICTED_INPUT_CAPACITY, RingOverflow::DropOldest>
+    PredictedInputs;
+  // Drawn position minus predicted position
+  Vector3 Correction;
+
+  SnapshotHistory Snapshots;
+  uint32_t LastSnapshotTickIndex = 0;
+  uint32_t LastStateTickIndex = 0;
+
+  // Remote entities are drawn at RenderTick, RenderDelay behind the server
+  // tick estimated by Clock. ViewTick is the point in time actually drawn,
+  // it only differs while the buffer runs dry
+  ClockSync Clock;
+  RenderDelay Delay;
+  RingBuffer<WorldSnapshot,
+             INTERPOLATION_BUFFER_CAPACITY,
+             RingOverflow::DropOldest>
+    InterpolationBuffer;
+  double RenderTick = 0;
+  double ViewTick = 0;
+
+  std::vector<ClientProjectile> Projectiles;
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPlayerJoined, int, PlayerIndex);
@@ -36,6 +87,27 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FPlayerPositionReceived,
                                              FVector,
                                              PlayerPosition);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FPlayerRotationReceived,
+                                             int,
+                                             PlayerIndex,
+                                             FRotator,
+                                             PlayerRotation);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FPlayerHit,
+                                             int,
+                                             ShooterIndex,
+                                             int,
+                                             TargetIndex);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FProjectileMoved,
+                                             int,
+                                             ProjectileId,
+                                             FVector,
+                                             ProjectilePosition);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FProjectileDestroyed,
+                                            int,
+                                            ProjectileId);
+
 UCLASS()
 class PROJECTACE_API UENet6NetworkSubsystem
   : public UGameInstanceSubsystem
@@ -143,10 +215,15 @@ public:
   UFUNCTION(BlueprintCallable)
   void Disconnect();
 
+  UFUNCTION(BlueprintCallable)
+  void Fire(FVector Direction);
+  UFUNCTION(BlueprintCallable)
+  void Launch(FVector Direction);
+
   void Initialize(FSubsystemCollectionBase& Collection) override;
   void Deinitialize() override;
 
-  void HandleMessage(const std::vector<uint8_t>& message);
+  void HandleMessage(const ENetPacket* message, double arrivalTime);
 
   UPROPERTY(BlueprintAssignable)
   FPlayerJoined PlayerJoined;
@@ -157,12 +234,34 @@ public:
   UPROPERTY(BlueprintAssignable)
   FPlayerPositionReceived PlayerPositionReceived;
 
+  UPROPERTY(BlueprintAssignable)
+  FPlayerRotationReceived PlayerRotationReceived;
+
+  UPROPERTY(BlueprintAssignable)
+  FPlayerHit PlayerHit;
+
+  UPROPERTY(BlueprintAssignable)
+  FProjectileMoved ProjectileMoved;
+
+  UPROPERTY(BlueprintAssignable)
+  FProjectileDestroyed ProjectileDestroyed;
+
 private:
+  // Services the host from Connect() to Disconnect(), the game thread only
+  // touches it before and after
+  void RunNetwork();
+  void Send(ENetPacket* packet);
+
   ENetHost* Host = nullptr;
   ENetPeer* ServerPeer = nullptr;
   APawn* _planePawn;
   GameData gameData;
 
+  std::thread NetworkThread;
+  std::atomic<bool> NetworkRunning = false;
+  RingBuffer<ReceivedEvent, CLIENT_QUEUE_CAPACITY> Received;
+  RingBuffer<ENetPacket*, CLIENT_QUEUE_CAPACITY> Outgoing;
+
   void ProcessRoll();
   void ProcessPitch();
   void ProcessYaw();
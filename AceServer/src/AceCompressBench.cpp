@@ -0,0 +1,280 @@
+#include "include/Compressor.h"
+#include "include/Protocol.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Server side load the compressor is sized for
+constexpr auto BENCH_PEERS = 64;
+
+struct BenchOptions
+{
+  std::string Input;
+  std::string Train;
+  unsigned Repeats = 5;
+};
+
+struct BenchResult
+{
+  double Ratio = 0;
+  double CompressUs = 0;
+  double DecompressUs = 0;
+  size_t Uncompressed = 0;
+  size_t Mismatches = 0;
+};
+
+using Datagram = std::vector<uint8_t>;
+
+bool
+ParseOptions(int argc, char** argv, BenchOptions& options);
+
+bool
+ReadCapture(const std::string& path, std::vector<Datagram>& datagrams);
+
+void
+TrainModel(const std::vector<Datagram>& datagrams,
+           std::vector<uint16_t>& model);
+
+bool
+WriteModel(const std::string& path,
+           const std::string& input,
+           const std::vector<uint16_t>& model);
+
+BenchResult
+Run(const BenchOptions& options,
+    const std::vector<Datagram>& datagrams,
+    const std::vector<uint16_t>& model);
+
+void
+PrintResult(const char* model, const BenchResult& result);
+
+// Replays datagrams recorded with AceServer --capture through the compressor,
+// checks that each one decompresses to itself and reports the ratio and the
+// time per datagram. --train fits the initial probabilities to the capture
+// and writes them as CompressorModel.h
+int
+main(int argc, char** argv)
+{
+  auto options = BenchOptions();
+  if (!ParseOptions(argc, argv, options))
+    return EXIT_FAILURE;
+
+  auto datagrams = std::vector<Datagram>();
+  if (!ReadCapture(options.Input, datagrams) || datagrams.empty()) {
+    std::cerr << "No datagrams in " << options.Input << "\n";
+    return EXIT_FAILURE;
+  }
+
+  auto trained = std::vector<uint16_t>(std::begin(COMPRESSOR_MODEL),
+                                       std::end(COMPRESSOR_MODEL));
+  if (!options.Train.empty()) {
+    TrainModel(datagrams, trained);
+    if (!WriteModel(options.Train, options.Input, trained)) {
+      std::cerr << "Failed to write " << options.Train << "\n";
+      return EXIT_FAILURE;
+    }
+    std::cout << "Wrote " << options.Train
+              << ", measured on the training set\n";
+  }
+  auto uniform = std::vector<uint16_t>(COMPRESSOR_MODEL_SIZE, 2048);
+
+  auto bytes = size_t();
+  for (const auto& datagram : datagrams)
+    bytes += datagram.size();
+  std::printf("%zu datagrams, %.1f bytes mean, %u repeats\n",
+              datagrams.size(),
+              static_cast<double>(bytes) / datagrams.size(),
+              options.Repeats);
+  std::printf("%-10s %8s %14s %16s %12s %11s\n",
+              "model",
+              "ratio",
+              "compress us",
+              "decompress us",
+              "uncompressed",
+              "mismatches");
+  auto result = Run(options, datagrams, trained);
+  PrintResult("trained", result);
+  PrintResult("uniform", Run(options, datagrams, uniform));
+
+  std::printf("%d peers at %dHz: %.2f%% of a core to compress\n",
+              BENCH_PEERS,
+              TICK_RATE,
+              result.CompressUs * BENCH_PEERS * TICK_RATE / 1e4);
+  return result.Mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool
+ParseOptions(int argc, char** argv, BenchOptions& options)
+{
+  for (auto i = 1; i < argc; i++) {
+    auto arg = std::string(argv[i]);
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return false;
+    }
+    if (arg == "--input")
+      options.Input = argv[++i];
+    else if (arg == "--train")
+      options.Train = argv[++i];
+    else if (arg == "--repeats")
+      options.Repeats = std::max(std::atoi(argv[++i]), 1);
+    else {
+      options.Input.clear();
+      break;
+    }
+  }
+  if (options.Input.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " --input <capture> [--train <CompressorModel.h>]"
+                 " [--repeats N]\n";
+    return false;
+  }
+  return true;
+}
+
+bool
+ReadCapture(const std::string& path, std::vector<Datagram>& datagrams)
+{
+  auto file = std::ifstream(path, std::ios::binary);
+  if (!file)
+    return false;
+  uint8_t header[4];
+  while (file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+    auto length = header[0] | header[1] << 8 | header[2] << 16 |
+                  static_cast<uint32_t>(header[3]) << 24;
+    auto& datagram = datagrams.emplace_back(length);
+    if (!file.read(reinterpret_cast<char*>(datagram.data()), length)) {
+      datagrams.pop_back();
+      break;
+    }
+  }
+  return true;
+}
+
+// Frequency of a 0 bit at each node of each context, the same walk as the
+// compressor but without adaptation
+void
+TrainModel(const std::vector<Datagram>& datagrams,
+           std::vector<uint16_t>& model)
+{
+  auto zeros = std::vector<uint32_t>(COMPRESSOR_MODEL_SIZE);
+  auto totals = std::vector<uint32_t>(COMPRESSOR_MODEL_SIZE);
+  for (const auto& datagram : datagrams) {
+    auto previous = uint8_t();
+    for (auto byte : datagram) {
+      auto context = (previous >> COMPRESSOR_CONTEXT_SHIFT) * 256;
+      auto node = 1u;
+      for (auto bit = 7; bit >= 0; bit--) {
+        auto value = (byte >> bit) & 1u;
+        zeros[context + node] += value == 0;
+        totals[context + node]++;
+        node = node * 2 + value;
+      }
+      previous = byte;
+    }
+  }
+
+  constexpr auto one = 1 << COMPRESSOR_PROBABILITY_BITS;
+  for (auto i = 0; i < COMPRESSOR_MODEL_SIZE; i++) {
+    auto probability = (zeros[i] + .5) / (totals[i] + 1.) * one;
+    model[i] = static_cast<uint16_t>(
+      std::clamp(static_cast<int>(probability), 31, one - 31));
+  }
+}
+
+bool
+WriteModel(const std::string& path,
+           const std::string& input,
+           const std::vector<uint16_t>& model)
+{
+  auto file = std::ofstream(path);
+  file << "#pragma once\n\n#include <cstdint>\n\n"
+       << "// Generated by AceCompressBench --train from " << input << "\n"
+       << "// Initial probability of a 0 bit, on COMPRESSOR_PROBABILITY_BITS, "
+          "at each\n// bit tree node of each previous byte context\n"
+       << "inline constexpr uint16_t COMPRESSOR_MODEL["
+       << COMPRESSOR_CONTEXTS << " * 256] = {\n";
+  for (auto i = 0; i < COMPRESSOR_MODEL_SIZE; i++)
+    file << (i % 12 == 0 ? "  " : " ") << model[i] << ","
+         << (i % 12 == 11 || i + 1 == COMPRESSOR_MODEL_SIZE ? "\n" : "");
+  file << "};\n";
+  return static_cast<bool>(file);
+}
+
+// Datagrams the compressor can't shrink are counted at their own size, ENet
+// sends those uncompressed
+BenchResult
+Run(const BenchOptions& options,
+    const std::vector<Datagram>& datagrams,
+    const std::vector<uint16_t>& model)
+{
+  auto compressor = DatagramCompressor(model.data());
+  auto compressed = std::vector<Datagram>(datagrams.size());
+  auto sizes = std::vector<size_t>(datagrams.size());
+  auto output = Datagram(ENET_PROTOCOL_MAXIMUM_MTU);
+  using Clock = std::chrono::steady_clock;
+  auto elapsed = [](Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+  };
+
+  auto result = BenchResult();
+  auto start = Clock::now();
+  for (unsigned r = 0; r < options.Repeats; r++)
+    for (auto i = size_t(); i < datagrams.size(); i++) {
+      auto& out = compressed[i];
+      out.resize(datagrams[i].size());
+      auto buffer = ENetBuffer();
+      buffer.data = const_cast<uint8_t*>(datagrams[i].data());
+      buffer.dataLength = datagrams[i].size();
+      sizes[i] = compressor.Compress(
+        &buffer, 1, buffer.dataLength, out.data(), out.size());
+    }
+  result.CompressUs =
+    elapsed(start) / (static_cast<double>(options.Repeats) * datagrams.size());
+
+  start = Clock::now();
+  for (unsigned r = 0; r < options.Repeats; r++)
+    for (auto i = size_t(); i < datagrams.size(); i++)
+      if (sizes[i] != 0)
+        compressor.Decompress(
+          compressed[i].data(), sizes[i], output.data(), output.size());
+  result.DecompressUs =
+    elapsed(start) / (static_cast<double>(options.Repeats) * datagrams.size());
+
+  auto original = size_t();
+  auto total = size_t();
+  for (auto i = size_t(); i < datagrams.size(); i++) {
+    original += datagrams[i].size();
+    if (sizes[i] == 0) {
+      total += datagrams[i].size();
+      result.Uncompressed++;
+      continue;
+    }
+    total += sizes[i];
+    auto length = compressor.Decompress(
+      compressed[i].data(), sizes[i], output.data(), output.size());
+    if (length != datagrams[i].size() ||
+        !std::equal(datagrams[i].begin(), datagrams[i].end(), output.begin()))
+      result.Mismatches++;
+  }
+  result.Ratio = static_cast<double>(total) / original;
+  return result;
+}
+
+void
+PrintResult(const char* model, const BenchResult& result)
+{
+  std::printf("%-10s %8.3f %14.2f %16.2f %12zu %11zu\n",
+              model,
+              result.Ratio,
+              result.CompressUs,
+              result.DecompressUs,
+              result.Uncompressed,
+              result.Mismatches);
+}
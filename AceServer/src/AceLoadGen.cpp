@@ -0,0 +1,450 @@
+#define _WINSOCK_DEPRECATED_NO_WARNINGS
+#define ENET_IMPLEMENTATION
+
+#include "include/ClockSync.h"
+#include "include/Compressor.h"
+#include "include/LagCompensation.h"
+#include "include/Metrics.h"
+#include "include/Protocol.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+
+struct LoadGenOptions
+{
+  std::string Host = "127.0.0.1";
+  uint16_t Port = NET_PORT;
+  unsigned Clients = 100;
+  unsigned Spectators = 0;
+  unsigned Duration = 30;
+  unsigned ConnectRate = 50;
+  unsigned FireInterval = 0;
+  unsigned LaunchInterval = 0;
+  std::string OutputPrefix = "loadgen";
+};
+
+struct SimClient
+{
+  ENetHost* Host = nullptr;
+  ENetPeer* Peer = nullptr;
+  bool Connected = false;
+  // Only receives, as a viewer on a match server or relay
+  bool Spectator = false;
+  uint16_t PlayerIndex = 0;
+  float Phase = 0;
+  uint32_t InputIndex = 1;
+  RingBuffer<PlayerInput, INPUT_REDUNDANCY, RingOverflow::DropOldest>
+    SentInputs;
+  SnapshotHistory Snapshots;
+  uint32_t LastSnapshotTickIndex = 0;
+  uint64_t LastArrival = 0;
+  ClockSync Clock;
+  RenderDelay Delay;
+};
+
+struct LoadGenStats
+{
+  LatencyHistogram ArrivalJitter;
+  LatencyHistogram WindowJitter;
+  LatencyHistogram InterpolationDelay;
+  LatencyHistogram RoundTrip;
+  uint64_t SnapshotsReceived = 0;
+  uint64_t SnapshotsDropped = 0;
+  uint64_t BytesReceived = 0;
+  uint64_t InputsSent = 0;
+  uint64_t ShotsFired = 0;
+  uint64_t Hits = 0;
+  uint64_t ProjectilesLaunched = 0;
+  uint64_t ProjectilesSpawned = 0;
+  uint64_t ProjectileHits = 0;
+};
+
+bool
+ParseOptions(int argc, char** argv, LoadGenOptions& options);
+
+void
+HandleMessage(SimClient& client, LoadGenStats& stats, const ENetPacket* packet);
+
+void
+SendInput(SimClient& client, LoadGenStats& stats, float time);
+
+void
+SendPing(SimClient& client);
+
+bool
+AimAtClosest(const SimClient& client, Vector3& direction, uint32_t& tickIndex);
+
+void
+Fire(SimClient& client, LoadGenStats& stats);
+
+void
+Launch(SimClient& client, LoadGenStats& stats);
+
+int
+main(int argc, char** argv)
+{
+  auto options = LoadGenOptions();
+  if (!ParseOptions(argc, argv, options))
+    return EXIT_FAILURE;
+
+  if (enet_initialize() < 0) {
+    std::cerr << "An error occurred while initializing ENet.\n";
+    return EXIT_FAILURE;
+  }
+  atexit(enet_deinitialize);
+
+  auto address = ENetAddress();
+  if (enet_address_set_host(&address, options.Host.c_str()) < 0) {
+    std::cerr << "Failed to resolve " << options.Host << "\n";
+    return EXIT_FAILURE;
+  }
+  address.port = options.Port;
+
+  auto csv = std::ofstream(options.OutputPrefix + ".csv");
+  csv << "time_s,connected,snapshots,dropped,bytes_received,inputs_sent,"
+         "jitter_p50_us,jitter_p99_us\n";
+
+  auto clients = std::vector<SimClient>(options.Clients + options.Spectators);
+  auto stats = LoadGenStats();
+  auto start = GetMicroseconds();
+  auto end = start + options.Duration * 1000000ull;
+  auto nextInput = start;
+  auto inputTick = 0u;
+  auto nextReport = start + 1000000;
+  auto created = size_t();
+
+  for (auto now = start; now < end; now = GetMicroseconds()) {
+    auto elapsed = (now - start) / 1e6f;
+
+    auto target = std::min<size_t>(clients.size(),
+                                   1 + elapsed * options.ConnectRate);
+    for (; created < target; created++) {
+      auto& client = clients[created];
+      client.Host = enet_host_create(nullptr, 1, NET_CHANNELS, 0, 0);
+      if (client.Host == nullptr) {
+        std::cerr << "Failed to create client host " << created << "\n";
+        continue;
+      }
+      auto compressor = DatagramCompressor::Make();
+      enet_host_compress(client.Host, &compressor);
+      client.Spectator = created >= options.Clients;
+      client.Peer = enet_host_connect(client.Host,
+                                      &address,
+                                      NET_CHANNELS,
+                                      client.Spectator ? NET_CONNECT_SPECTATOR
+                                                       : 0);
+      client.Phase = created * 0.37f;
+    }
+
+    for (auto& client : clients) {
+      if (client.Host == nullptr)
+        continue;
+      auto event = ENetEvent();
+      while (enet_host_service(client.Host, &event, 0) > 0)
+        switch (event.type) {
+          case ENetEventType::ENET_EVENT_TYPE_CONNECT:
+            client.Connected = true;
+            break;
+          case ENetEventType::ENET_EVENT_TYPE_DISCONNECT:
+          case ENetEventType::ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
+            client.Connected = false;
+            break;
+          case ENetEventType::ENET_EVENT_TYPE_RECEIVE:
+            HandleMessage(client, stats, event.packet);
+            enet_packet_destroy(event.packet);
+            break;
+          default:
+            break;
+        }
+    }
+
+    if (now >= nextInput) {
+      // Spectators render on the tick clock as well and ping like players
+      for (auto& client : clients)
+        if (client.Connected && client.Spectator &&
+            inputTick % CLOCK_PING_INTERVAL_TICKS == 0) {
+          SendPing(client);
+          enet_host_flush(client.Host);
+        }
+      for (auto& client : clients)
+        if (client.Connected && !client.Spectator) {
+          SendInput(client, stats, elapsed);
+          if (client.InputIndex % CLOCK_PING_INTERVAL_TICKS == 0)
+            SendPing(client);
+          if (options.FireInterval != 0 &&
+              client.InputIndex % options.FireInterval == 0)
+            Fire(client, stats);
+          if (options.LaunchInterval != 0 &&
+              client.InputIndex % options.LaunchInterval == 0)
+            Launch(client, stats);
+          enet_host_flush(client.Host);
+        }
+      nextInput += NET_TICK * 1000;
+      inputTick++;
+    }
+
+    if (now >= nextReport) {
+      auto connected = std::count_if(clients.begin(),
+                                     clients.end(),
+                                     [](const auto& c) { return c.Connected; });
+      csv << static_cast<int>(elapsed) << ',' << connected << ','
+          << stats.SnapshotsReceived << ',' << stats.SnapshotsDropped << ','
+          << stats.BytesReceived << ',' << stats.InputsSent << ','
+          << stats.WindowJitter.Percentile(50) << ','
+          << stats.WindowJitter.Percentile(99) << '\n';
+      std::cout << static_cast<int>(elapsed) << "s - " << connected
+                << " clients, jitter p50 " << stats.WindowJitter.Percentile(50)
+                << "us p99 " << stats.WindowJitter.Percentile(99)
+                << "us, render delay p50 "
+                << stats.InterpolationDelay.Percentile(50) << "us\n";
+      stats.WindowJitter = LatencyHistogram();
+      nextReport += 1000000;
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+
+  for (auto& client : clients)
+    if (client.Host != nullptr) {
+      if (client.Peer != nullptr)
+        enet_peer_disconnect_now(client.Peer, 0);
+      enet_host_destroy(client.Host);
+    }
+
+  auto summary = nlohmann::json{
+    { "clients", options.Clients },
+    { "spectators", options.Spectators },
+    { "duration_s", options.Duration },
+    { "snapshots_received", stats.SnapshotsReceived },
+    { "snapshots_dropped", stats.SnapshotsDropped },
+    { "bytes_received", stats.BytesReceived },
+    { "inputs_sent", stats.InputsSent },
+    { "shots_fired", stats.ShotsFired },
+    { "hits", stats.Hits },
+    { "projectiles_launched", stats.ProjectilesLaunched },
+    { "projectiles_spawned", stats.ProjectilesSpawned },
+    { "projectile_hits", stats.ProjectileHits },
+    { "arrival_jitter_us", stats.ArrivalJitter.ToJson() },
+    { "render_delay_us", stats.InterpolationDelay.ToJson() },
+    { "round_trip_us", stats.RoundTrip.ToJson() }
+  };
+  auto json = std::ofstream(options.OutputPrefix + ".json");
+  json << summary.dump(2) << '\n';
+  std::cout << summary.dump(2) << '\n';
+
+  return EXIT_SUCCESS;
+}
+
+void
+HandleMessage(SimClient& client, LoadGenStats& stats, const ENetPacket* packet)
+{
+  stats.BytesReceived += packet->dataLength;
+
+  auto reader = BitReader(packet->data, packet->dataLength);
+  auto opcode = static_cast<Opcode>(reader.ReadU8());
+  if (opcode == Opcode::S_GAMEDATA) {
+    auto gameDataPacket = GameDataPacket::Unserialize(reader);
+    if (!reader.Overflowed())
+      client.PlayerIndex = gameDataPacket.PlayerIndex;
+    return;
+  }
+  if (opcode == Opcode::S_HIT) {
+    auto hitPacket = HitPacket::Unserialize(reader);
+    if (reader.Overflowed() || hitPacket.ShooterIndex != client.PlayerIndex)
+      return;
+    if (hitPacket.ProjectileId != 0)
+      stats.ProjectileHits++;
+    else
+      stats.Hits++;
+    return;
+  }
+  if (opcode == Opcode::S_PONG) {
+    auto pongPacket = PongPacket::Unserialize(reader);
+    if (reader.Overflowed())
+      return;
+    auto now = GetMicroseconds() / 1e6;
+    client.Clock.AddSample(ClockStampTime(pongPacket.ClientTime, now),
+                           pongPacket.ReceiveTick,
+                           pongPacket.SendTick,
+                           now);
+    stats.RoundTrip.Record(
+      static_cast<uint64_t>(client.Clock.GetRoundTrip() * 1e6));
+    return;
+  }
+  if (opcode == Opcode::S_PROJECTILESPAWN) {
+    auto spawnPacket = ProjectileSpawnPacket::Unserialize(reader);
+    if (reader.Overflowed())
+      return;
+    for (const auto& spawn : spawnPacket.Spawns)
+      stats.ProjectilesSpawned += spawn.OwnerIndex == client.PlayerIndex;
+    return;
+  }
+  if (opcode != Opcode::S_PLAYERPOSITION)
+    return;
+
+  auto positionPacket = PlayersPositionPacket::Unserialize(reader);
+  if (reader.Overflowed() ||
+      positionPacket.TickIndex <= client.LastSnapshotTickIndex)
+    return;
+
+  auto baseline = client.Snapshots.Find(positionPacket.BaselineTickIndex);
+  if (positionPacket.BaselineTickIndex != 0 && baseline == nullptr) {
+    stats.SnapshotsDropped++;
+    return;
+  }
+  auto& snapshot = client.Snapshots.Push(positionPacket.TickIndex);
+  ApplySnapshotDelta(baseline,
+                     positionPacket.Players,
+                     positionPacket.RemovedPlayers,
+                     snapshot);
+  auto ticks = positionPacket.TickIndex - client.LastSnapshotTickIndex;
+  client.LastSnapshotTickIndex = positionPacket.TickIndex;
+  stats.SnapshotsReceived++;
+
+  // Against the interval the snapshots were sent at
+  auto now = GetMicroseconds();
+  if (client.LastArrival != 0) {
+    auto interval = static_cast<int64_t>(now - client.LastArrival);
+    auto jitter = std::abs(interval - int64_t(ticks) * NET_TICK * 1000);
+    stats.ArrivalJitter.Record(jitter);
+    stats.WindowJitter.Record(jitter);
+  }
+  client.LastArrival = now;
+
+  // Delay a client would draw remote players with
+  if (client.Clock.IsSynchronized()) {
+    client.Delay.AddArrival(positionPacket.TickIndex,
+                            client.Clock.ServerTick(now / 1e6));
+    stats.InterpolationDelay.Record(static_cast<uint64_t>(
+      client.Delay.GetTarget() * NET_TICK * 1000));
+  }
+}
+
+void
+SendInput(SimClient& client, LoadGenStats& stats, float time)
+{
+  constexpr auto TwoPi = 6.2831853f;
+
+  auto input = PlayerInput();
+  input.Index = client.InputIndex++;
+  input.Pitch = std::sin(TwoPi * time / 4.f + client.Phase);
+  input.Roll = std::cos(TwoPi * time / 4.f + client.Phase);
+  input.Yaw = std::sin(TwoPi * time / 10.f + client.Phase) * .5f;
+  input.Throttle = 1.f;
+  client.SentInputs.Push(input);
+
+  auto packet = PlayerInputPacket();
+  for (auto i = size_t(); i < client.SentInputs.Size(); i++)
+    packet.Inputs.push_back(client.SentInputs[i]);
+  packet.AckTickIndex = client.LastSnapshotTickIndex;
+  enet_peer_send(
+    client.Peer, 0, BuildPacket(packet, ENET_PACKET_FLAG_UNSEQUENCED));
+  stats.InputsSent++;
+}
+
+void
+SendPing(SimClient& client)
+{
+  auto packet = PingPacket();
+  packet.ClientTime = ClockStamp(GetMicroseconds() / 1e6);
+  enet_peer_send(
+    client.Peer, 0, BuildPacket(packet, ENET_PACKET_FLAG_UNSEQUENCED));
+}
+
+// Direction to the closest other player of the last snapshot
+bool
+AimAtClosest(const SimClient& client, Vector3& direction, uint32_t& tickIndex)
+{
+  auto snapshot = client.Snapshots.Find(client.LastSnapshotTickIndex);
+  auto self = snapshot ? snapshot->Find(client.PlayerIndex) : nullptr;
+  if (self == nullptr)
+    return false;
+
+  auto origin = self->Position.ToVector3();
+  auto target = Vector3();
+  auto closest = WEAPON_RANGE * WEAPON_RANGE;
+  for (const auto& entity : snapshot->Players) {
+    auto offset = entity.Position.ToVector3() - origin;
+    auto distSq = offset.SquaredLength();
+    if (entity.PlayerIndex != client.PlayerIndex && distSq > 0 &&
+        distSq < closest) {
+      closest = distSq;
+      target = offset;
+    }
+  }
+  if (target == Vector3())
+    return false;
+
+  direction = Vector3::Normalize(target);
+  tickIndex = snapshot->TickIndex;
+  return true;
+}
+
+void
+Fire(SimClient& client, LoadGenStats& stats)
+{
+  auto packet = FirePacket();
+  if (!AimAtClosest(client, packet.Direction, packet.ViewTickIndex))
+    return;
+  enet_peer_send(
+    client.Peer, 0, BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE));
+  stats.ShotsFired++;
+}
+
+void
+Launch(SimClient& client, LoadGenStats& stats)
+{
+  auto packet = LaunchPacket();
+  auto tickIndex = uint32_t();
+  if (!AimAtClosest(client, packet.Direction, tickIndex))
+    return;
+  enet_peer_send(
+    client.Peer, 0, BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE));
+  stats.ProjectilesLaunched++;
+}
+
+bool
+ParseOptions(int argc, char** argv, LoadGenOptions& options)
+{
+  for (auto i = 1; i < argc; i++) {
+    auto arg = std::string(argv[i]);
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return false;
+    }
+    if (arg == "--host")
+      options.Host = argv[++i];
+    else if (arg == "--port")
+      options.Port =
+        static_cast<uint16_t>(std::clamp(std::atoi(argv[++i]), 1, 0xFFFF));
+    else if (arg == "--clients")
+      options.Clients = std::max(std::atoi(argv[++i]), 0);
+    else if (arg == "--spectators")
+      options.Spectators = std::max(std::atoi(argv[++i]), 0);
+    else if (arg == "--duration")
+      options.Duration = std::max(std::atoi(argv[++i]), 1);
+    else if (arg == "--connect-rate")
+      options.ConnectRate = std::max(std::atoi(argv[++i]), 1);
+    else if (arg == "--fire-interval")
+      options.FireInterval = std::max(std::atoi(argv[++i]), 0);
+    else if (arg == "--launch-interval")
+      options.LaunchInterval = std::max(std::atoi(argv[++i]), 0);
+    else if (arg == "--out")
+      options.OutputPrefix = argv[++i];
+    else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--host H] [--port N] [--clients N] [--spectators N]"
+                   " [--duration S]"
+                   " [--connect-rate N] [--fire-interval N]"
+                   " [--launch-interval N] [--out <prefix>]\n";
+      return false;
+    }
+  }
+  if (options.Clients + options.Spectators == 0) {
+    std::cerr << "Nothing to run without clients or spectators\n";
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,317 @@
+#include "include/math/batch.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct BenchOptions
+{
+  unsigned Targets = 4096;
+  unsigned Queries = 64;
+  unsigned Repeats = 20;
+};
+
+// Same targets in both layouts, queries aim roughly at a target so that a
+// fair share of the tests hit
+struct BenchData
+{
+  std::vector<Ray> Rays;
+  std::vector<Box> QueryBoxes;
+  std::vector<std::pair<Vector3, Vector3>> QuerySegments;
+
+  std::vector<Sphere> Spheres;
+  std::vector<Capsule> Capsules;
+  std::vector<Box> Boxes;
+  SphereSoA SphereLanes;
+  CapsuleSoA CapsuleLanes;
+  BoxSoA BoxLanes;
+};
+
+struct BenchResult
+{
+  double NsPerTarget = 0;
+  size_t Mismatches = 0;
+};
+
+bool
+ParseOptions(int argc, char** argv, BenchOptions& options);
+
+BenchData
+GenerateData(const BenchOptions& options);
+
+template<typename F>
+double
+Measure(const BenchOptions& options, F&& body);
+
+bool
+SameDistance(float a, float b);
+
+template<typename P>
+void
+RunBatch(const BenchOptions& options,
+         const BenchData& data,
+         const char* name,
+         const std::vector<double>& scalar,
+         const std::vector<std::vector<float>>& expected);
+
+void
+PrintResult(const char* kernel,
+            const char* path,
+            const BenchResult& result,
+            double scalarNs);
+
+int
+main(int argc, char** argv)
+{
+  auto options = BenchOptions();
+  if (!ParseOptions(argc, argv, options))
+    return EXIT_FAILURE;
+
+  auto data = GenerateData(options);
+  auto targets = static_cast<size_t>(options.Targets);
+  auto queries = static_cast<size_t>(options.Queries);
+
+  // Scalar AoS references, one result vector per kernel with every query
+  // laid out back to back
+  auto expected = std::vector<std::vector<float>>(
+    4, std::vector<float>(queries * targets));
+  auto scalar = std::vector<double>(4);
+
+  scalar[0] = Measure(options, [&] {
+    for (size_t q = 0; q < queries; q++) {
+      const auto& ray = data.Rays[q];
+      for (size_t i = 0; i < targets; i++) {
+        auto hit = Vector3();
+        expected[0][q * targets + i] =
+          Ray::Intersects(ray, data.Spheres[i], &hit)
+            ? Vector3::DotProduct(hit - ray.origin, ray.direction)
+            : Batch::Infinity;
+      }
+    }
+  });
+
+  scalar[1] = Measure(options, [&] {
+    for (size_t q = 0; q < queries; q++) {
+      const auto& ray = data.Rays[q];
+      for (size_t i = 0; i < targets; i++) {
+        Vector3 p1, p2, n1, n2;
+        auto t = Batch::Infinity;
+        if (Ray::Intersects(ray, data.Capsules[i], p1, p2, n1, n2))
+          t = Vector3::DotProduct(p1 - ray.origin, ray.direction);
+        expected[1][q * targets + i] = t >= 0 ? t : Batch::Infinity;
+      }
+    }
+  });
+
+  scalar[2] = Measure(options, [&] {
+    for (size_t q = 0; q < queries; q++)
+      for (size_t i = 0; i < targets; i++)
+        expected[2][q * targets + i] =
+          Box::Intersects(data.QueryBoxes[q], data.Boxes[i]) ? 1.f : 0.f;
+  });
+
+  scalar[3] = Measure(options, [&] {
+    for (size_t q = 0; q < queries; q++) {
+      const auto& [start, end] = data.QuerySegments[q];
+      for (size_t i = 0; i < targets; i++) {
+        float d1, d2;
+        Vector3 p1, p2;
+        expected[3][q * targets + i] =
+          Vector3::ClosestPoint(start,
+                                end,
+                                data.Capsules[i].start,
+                                data.Capsules[i].end,
+                                d1,
+                                d2,
+                                p1,
+                                p2);
+      }
+    }
+  });
+
+  std::printf("%u targets, %u queries, %u repeats\n",
+              options.Targets,
+              options.Queries,
+              options.Repeats);
+  std::printf("%-14s %-8s %12s %9s %11s\n",
+              "kernel",
+              "path",
+              "ns/target",
+              "speedup",
+              "mismatches");
+  const char* kernels[] = { "ray-sphere", "ray-capsule", "box-box", "segment" };
+  for (auto k = 0; k < 4; k++)
+    PrintResult(kernels[k], "aos", { scalar[k], 0 }, scalar[k]);
+
+  RunBatch<FloatX1>(options, data, "x1", scalar, expected);
+#ifdef ACE_SIMD_SSE
+  RunBatch<FloatX4>(options, data, "sse", scalar, expected);
+#endif
+#ifdef ACE_SIMD_AVX2
+  RunBatch<FloatX8>(options, data, "avx2", scalar, expected);
+#endif
+  return EXIT_SUCCESS;
+}
+
+bool
+ParseOptions(int argc, char** argv, BenchOptions& options)
+{
+  for (auto i = 1; i < argc; i++) {
+    auto arg = std::string(argv[i]);
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return false;
+    }
+    if (arg == "--targets")
+      options.Targets = std::max(std::atoi(argv[++i]), 1);
+    else if (arg == "--queries")
+      options.Queries = std::max(std::atoi(argv[++i]), 1);
+    else if (arg == "--repeats")
+      options.Repeats = std::max(std::atoi(argv[++i]), 1);
+    else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--targets N] [--queries N] [--repeats N]\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+BenchData
+GenerateData(const BenchOptions& options)
+{
+  auto data = BenchData();
+  auto random = std::mt19937(1234);
+  auto unit = std::uniform_real_distribution<float>(-1.f, 1.f);
+  auto distance = std::uniform_real_distribution<float>(5000.f, 100000.f);
+  auto size = std::uniform_real_distribution<float>(200.f, 3000.f);
+  auto direction = [&] {
+    auto v = Vector3(unit(random), unit(random), unit(random));
+    return Vector3::Normalize(v + Vector3(0.f, 0.f, 0.001f));
+  };
+
+  // Targets stay away from the origin of the rays so that the AoS capsule
+  // test, which does not handle a ray starting inside, remains a reference
+  for (unsigned i = 0; i < options.Targets; i++) {
+    auto center = direction() * distance(random);
+    auto radius = size(random) * .5f;
+    auto axis = direction() * size(random);
+    data.Spheres.emplace_back(center, radius);
+    data.Capsules.emplace_back(center - axis, center + axis, radius);
+    data.Boxes.emplace_back(
+      center, Vector3(size(random), size(random), size(random)) * 4.f);
+    data.SphereLanes.Push(data.Spheres.back());
+    data.CapsuleLanes.Push(data.Capsules.back());
+    data.BoxLanes.Push(data.Boxes.back());
+  }
+
+  for (unsigned q = 0; q < options.Queries; q++) {
+    const auto& target = data.Spheres[q * 7 % options.Targets].center;
+    data.Rays.emplace_back(Vector3(),
+                           Vector3::Normalize(target + direction() * 2000.f));
+    data.QueryBoxes.emplace_back(
+      target, Vector3(size(random), size(random), size(random)) * 20.f);
+    data.QuerySegments.emplace_back(target,
+                                    target + direction() * distance(random));
+  }
+  return data;
+}
+
+template<typename F>
+double
+Measure(const BenchOptions& options, F&& body)
+{
+  body();
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < options.Repeats; i++)
+    body();
+  auto elapsed = std::chrono::duration<double, std::nano>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+  return elapsed / (static_cast<double>(options.Repeats) * options.Queries *
+                    options.Targets);
+}
+
+// Relative tolerance, the batch kernels reorder the float operations
+bool
+SameDistance(float a, float b)
+{
+  if (std::isinf(a) || std::isinf(b))
+    return std::isinf(a) && std::isinf(b);
+  return std::abs(a - b) <= 1e-3f * std::max(1.f, std::abs(b));
+}
+
+template<typename P>
+void
+RunBatch(const BenchOptions& options,
+         const BenchData& data,
+         const char* name,
+         const std::vector<double>& scalar,
+         const std::vector<std::vector<float>>& expected)
+{
+  auto targets = static_cast<size_t>(options.Targets);
+  auto queries = static_cast<size_t>(options.Queries);
+  auto results = std::vector<float>(queries * targets);
+  auto hits = std::vector<uint8_t>(queries * targets);
+  auto mismatches = [&](size_t k) {
+    auto count = size_t(0);
+    for (size_t i = 0; i < results.size(); i++)
+      count += !SameDistance(results[i], expected[k][i]);
+    return count;
+  };
+
+  auto result = BenchResult();
+  result.NsPerTarget = Measure(options, [&] {
+    for (size_t q = 0; q < queries; q++)
+      Batch::Intersects<P>(
+        data.Rays[q], data.SphereLanes, &results[q * targets]);
+  });
+  result.Mismatches = mismatches(0);
+  PrintResult("ray-sphere", name, result, scalar[0]);
+
+  result.NsPerTarget = Measure(options, [&] {
+    for (size_t q = 0; q < queries; q++)
+      Batch::Intersects<P>(
+        data.Rays[q], data.CapsuleLanes, &results[q * targets]);
+  });
+  result.Mismatches = mismatches(1);
+  PrintResult("ray-capsule", name, result, scalar[1]);
+
+  result.NsPerTarget = Measure(options, [&] {
+    for (size_t q = 0; q < queries; q++)
+      Batch::Intersects<P>(
+        data.QueryBoxes[q], data.BoxLanes, &hits[q * targets]);
+  });
+  for (size_t i = 0; i < hits.size(); i++)
+    results[i] = hits[i];
+  result.Mismatches = mismatches(2);
+  PrintResult("box-box", name, result, scalar[2]);
+
+  result.NsPerTarget = Measure(options, [&] {
+    for (size_t q = 0; q < queries; q++)
+      Batch::ClosestPoint<P>(data.QuerySegments[q].first,
+                             data.QuerySegments[q].second,
+                             data.CapsuleLanes,
+                             &results[q * targets]);
+  });
+  result.Mismatches = mismatches(3);
+  PrintResult("segment", name, result, scalar[3]);
+}
+
+void
+PrintResult(const char* kernel,
+            const char* path,
+            const BenchResult& result,
+            double scalarNs)
+{
+  std::printf("%-14s %-8s %12.3f %8.2fx %11zu\n",
+              kernel,
+              path,
+              result.NsPerTarget,
+              scalarNs / result.NsPerTarget,
+              result.Mismatches);
+}
@@ -0,0 +1,132 @@
+#include "include/Metrics.h"
+#include "include/Projectiles.h"
+
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct BenchOptions
+{
+  unsigned Projectiles = 10000;
+  unsigned Players = 256;
+  unsigned Ticks = 600;
+  float Extent = 200000.f;
+};
+
+bool
+ParseOptions(int argc, char** argv, BenchOptions& options);
+
+// Players circle inside the extent, every player keeps launching at a random
+// other one so that the live count stays at the target and part of the
+// projectiles actually hit. Only ProjectileSystem::Step is timed
+int
+main(int argc, char** argv)
+{
+  auto options = BenchOptions();
+  if (!ParseOptions(argc, argv, options))
+    return EXIT_FAILURE;
+
+  auto random = std::mt19937(1234);
+  auto coordinate =
+    std::uniform_real_distribution<float>(-options.Extent, options.Extent);
+  auto altitude = std::uniform_real_distribution<float>(2000.f, 20000.f);
+  auto angle = std::uniform_real_distribution<float>(0.f, 6.2831853f);
+  auto spread = std::uniform_real_distribution<float>(-.05f, .05f);
+  auto pick = std::uniform_int_distribution<unsigned>(0, options.Players - 1);
+
+  auto centers = std::vector<Vector3>();
+  auto phases = std::vector<float>();
+  for (unsigned i = 0; i < options.Players; i++) {
+    centers.emplace_back(coordinate(random), coordinate(random), 0.f);
+    centers.back().z = altitude(random);
+    phases.push_back(angle(random));
+  }
+
+  auto capsules = std::vector<HitCapsule>(options.Players);
+  auto positions = std::vector<Vector3>(options.Players);
+  auto projectiles = ProjectileSystem();
+  auto step = LatencyHistogram();
+  auto hits = uint64_t();
+  auto spawned = uint64_t();
+
+  for (unsigned tick = 0; tick < options.Ticks; tick++) {
+    for (unsigned i = 0; i < options.Players; i++) {
+      auto phase = phases[i] + tick * 0.01f;
+      positions[i] = centers[i] + Vector3(std::cos(phase) * 30000.f,
+                                          std::sin(phase) * 30000.f,
+                                          0.f);
+      capsules[i].PlayerIndex = static_cast<uint16_t>(i);
+      capsules[i].Shape =
+        MakeHitCapsule(positions[i], Vector3(0.f, 0.f, phase * 57.29578f));
+    }
+
+    while (projectiles.Size() < options.Projectiles) {
+      auto owner = pick(random);
+      auto target = pick(random);
+      auto offset = positions[target] - positions[owner];
+      if (owner == target || offset.Length() > WEAPON_RANGE * 2)
+        offset = Vector3(std::cos(angle(random)), std::sin(angle(random)), 0);
+      auto direction = Vector3::Normalize(offset) +
+                       Vector3(spread(random), spread(random), spread(random));
+      direction = Vector3::Normalize(direction);
+      projectiles.Spawn(static_cast<uint16_t>(owner),
+                        positions[owner] + direction * PROJECTILE_SPAWN_OFFSET,
+                        direction * PROJECTILE_SPEED);
+      spawned++;
+    }
+    projectiles.Spawns.clear();
+
+    auto start = GetMicroseconds();
+    projectiles.Step(capsules);
+    step.Record(GetMicroseconds() - start);
+    hits += projectiles.Hits.size();
+  }
+
+  auto budget = NET_TICK * 1000.;
+  std::printf("%u live projectiles, %u players, %u ticks\n",
+              options.Projectiles,
+              options.Players,
+              options.Ticks);
+  std::printf("step mean %.1fus p50 %lluus p99 %lluus max %lluus, "
+              "%.2f%% of the %dms tick at p99\n",
+              step.Mean(),
+              static_cast<unsigned long long>(step.Percentile(50)),
+              static_cast<unsigned long long>(step.Percentile(99)),
+              static_cast<unsigned long long>(step.Max),
+              step.Percentile(99) / budget * 100.,
+              NET_TICK);
+  std::printf("%.1f ns per projectile, %llu spawned, %llu hits\n",
+              step.Mean() * 1000. / options.Projectiles,
+              static_cast<unsigned long long>(spawned),
+              static_cast<unsigned long long>(hits));
+  return EXIT_SUCCESS;
+}
+
+bool
+ParseOptions(int argc, char** argv, BenchOptions& options)
+{
+  for (auto i = 1; i < argc; i++) {
+    auto arg = std::string(argv[i]);
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return false;
+    }
+    if (arg == "--projectiles")
+      options.Projectiles = std::max(std::atoi(argv[++i]), 1);
+    else if (arg == "--players")
+      options.Players = std::max(std::atoi(argv[++i]), 2);
+    else if (arg == "--ticks")
+      options.Ticks = std::max(std::atoi(argv[++i]), 1);
+    else if (arg == "--extent")
+      options.Extent = std::max<float>(std::atof(argv[++i]), 1000.f);
+    else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--projectiles N] [--players N] [--ticks N]"
+                   " [--extent <units>]\n";
+      return false;
+    }
+  }
+  return true;
+}
@@ -1,143 +1,329 @@
 ﻿#define _WINSOCK_DEPRECATED_NO_WARNINGS
 #define ENET_IMPLEMENTATION
 
+#include "include/Interest.h"
+#include "include/LagCompensation.h"
+#include "include/Metrics.h"
+#include "include/NetShards.h"
+#include "include/PlayerStore.h"
+#include "include/Projectiles.h"
 #include "include/Protocol.h"
+#include "include/Relay.h"
+#include "include/Replay.h"
+#include "include/TickScheduler.h"
+#include "include/utils/job_system.hpp"
+#ifdef ACE_WITH_JSBSIM
+#include "include/FlightModel.h"
+#endif
 
+#include <algorithm>
 #include <iostream>
+#include <string>
+#include <thread>
 
+constexpr auto PLAYERS_PER_JOB = 8;
+// Datagrams per recvmmsg/sendmmsg call where batched socket I/O is available
+constexpr auto NET_IO_BATCH = 64;
+// Room left under the MTU for the ENet headers and the player state packet
+// that shares the datagram with the world packet
+constexpr auto SNAPSHOT_HEADROOM = 128;
+constexpr auto SNAPSHOT_MIN_BUDGET = 256;
+constexpr auto SNAPSHOT_BUDGET_STEP = 64;
+constexpr auto SNAPSHOT_RATE_INTERVAL = TICK_RATE;
+// World packets per second and per client, clients interpolate between them
+// with the replicated velocities
+constexpr auto SNAPSHOT_DEFAULT_RATE = 30;
+constexpr auto SNAPSHOT_MAX_LOSS = .05f;
+// Round trip time above the lowest seen, in ms, taken as queuing
+constexpr auto SNAPSHOT_RTT_SLACK = 100u;
+// Spectators are mostly relays, the feed restarts from a keyframe this often
+// so that their late peers get in sync
+constexpr auto SPECTATOR_MAX_PEERS = 16u;
+constexpr auto SPECTATOR_KEYFRAME_INTERVAL = 10 * TICK_RATE;
+
+struct ServerOptions
+{
+  unsigned Threads = std::max(std::thread::hardware_concurrency(), 1u);
+  unsigned NetThreads = 0;
+  std::string StatsPrefix;
+  bool Verbose = false;
+  size_t IoBatch = NET_IO_BATCH;
+  size_t SnapshotBudget = 0;
+  unsigned SnapshotRate = SNAPSHOT_DEFAULT_RATE;
+  std::string Capture;
+  uint16_t Port = NET_PORT;
+  std::string Upstream;
+  double RelayDelay = 0;
+  std::string Record;
+  std::string Replay;
+  uint32_t ReplayFrom = 0;
+#ifdef ACE_WITH_JSBSIM
+  std::string Aircraft;
+  std::string JSBSimRoot = ACE_JSBSIM_ROOT;
+  size_t FlightModels = NET_MAX_CLIENTS;
+#endif
+};
+
+// Handles rather than indices, a shooter that left before the tick must not
+// fire from whoever reused its index
+struct PendingShot
+{
+  PlayerHandle Shooter;
+  uint32_t ViewTickIndex = 0;
+  float ViewFraction = 0;
+  Vector3 Direction;
+};
+
+struct PendingLaunch
+{
+  PlayerHandle Shooter;
+  Vector3 Direction;
+};
+
+// A peer on the spectator feed, it only ever sends pings
+struct SpectatorConnection
+{
+  NetPeerId Peer;
+  uint32_t PingClientTime = 0;
+  double PingReceiveTick = 0;
+  bool PingPending = false;
+};
+
+// The tick clock counts ticks from the start of TickIndex
 struct GameData
 {
   uint32_t TickIndex = 0;
-  std::vector<Player> Players;
+  uint64_t TickStart = 0;
+  PlayerStore Players;
+  SnapshotHistory Snapshots;
+  InterestGrid Grid;
+  HitHistory Hits;
+  std::vector<PendingShot> Shots;
+  ProjectileSystem Projectiles;
+  std::vector<PendingLaunch> Launches;
+  // Peers on the spectator feed and the ticks of its last packet and of its
+  // last keyframe, a feed tick of 0 makes the next packet a keyframe
+  std::vector<SpectatorConnection> Spectators;
+  uint32_t FeedTickIndex = 0;
+  uint32_t FeedKeyframeTickIndex = 0;
+};
+
+// What a client is sent this tick, clients with equal views and baselines are
+// grouped so that their world packet is only serialized once. A packet only
+// goes to the peers of one network shard
+struct ClientView
+{
+  const WorldSnapshot* baseline = nullptr;
+  const WorldSnapshot* view = nullptr;
+  uint64_t hash = 0;
+  size_t shard = 0;
+  size_t group = 0;
 };
 
 struct ServerData
 {
-  ENetHost* host;
+  NetShards* net;
+  JobSystem* jobs;
+  std::vector<ENetPacket*> outgoingPackets;
+  std::vector<ClientView> views;
+  std::vector<size_t> viewOrder;
+  std::vector<size_t> groupLeaders;
+  std::vector<ENetPacket*> worldPackets;
+  size_t snapshotBudget = 0;
+  uint32_t snapshotInterval = 1;
+  MatchRecorder* recorder = nullptr;
+  TickMetrics metrics;
+#ifdef ACE_WITH_JSBSIM
+  FlightModelPool* flightModels = nullptr;
+#endif
 };
 
+bool
+ParseOptions(int argc, char** argv, ServerOptions& options);
+
 void
 ServerTick(ServerData& serverData, GameData& gameData);
 
 void
-HandleMessage(Player& player,
+ConsumeInput(PlayerConnection& connection, PlayerInput& lastInput);
+
+void
+SimulatePlayer(PlayerStore& players, size_t dense);
+
+void
+RecordTick(ServerData& serverData,
+           const GameData& gameData,
+           uint64_t start,
+           const TickScheduler& scheduler);
+
+void
+HandleEvent(ServerData& serverData,
+            GameData& gameData,
+            const ServerOptions& options,
+            const NetEvent& event);
+
+void
+HandleMessage(PlayerHandle handle,
               GameData& gameData,
-              const std::vector<uint8_t>& message);
+              const ENetPacket* message);
+
+SpectatorConnection*
+FindSpectator(GameData& gameData, NetPeerId peer);
+
+void
+HandleSpectatorMessage(SpectatorConnection& spectator,
+                       const GameData& gameData,
+                       const ENetPacket* message);
+
+void
+BroadcastPlayerList(ServerData& serverData, const GameData& gameData);
 
 ENetPacket*
 BuidPlayerListPacket(const GameData& gameData);
 
+void
+CaptureSnapshot(GameData& gameData);
+
+void
+ResolveShots(ServerData& serverData, GameData& gameData);
+
+void
+SimulateProjectiles(ServerData& serverData, GameData& gameData);
+
+double
+TickClock(const GameData& gameData);
+
+void
+AnswerPings(ServerData& serverData, GameData& gameData);
+
+void
+SendSpectatorFeed(ServerData& serverData, GameData& gameData);
+
+int
+RunRelay(const ServerOptions& options);
+
+int
+RunReplay(const ServerOptions& options);
+
+void
+UpdateSnapshotBudget(PlayerConnection& connection,
+                     const NetPeerStats& stats,
+                     size_t maxBudget,
+                     uint32_t tickIndex);
+
+void
+BuildClientView(const ServerData& serverData,
+                GameData& gameData,
+                size_t dense,
+                const WorldSnapshot* baseline,
+                WorldSnapshot& view);
+
+ClientView
+PrepareClientView(const ServerData& serverData,
+                  GameData& gameData,
+                  size_t dense);
+
+void
+GroupClientViews(ServerData& serverData);
+
+ENetPacket*
+BuildPlayerPositionPacket(const GameData& gameData, const ClientView& view);
+
 ENetPacket*
-BuildPlayerPositionPacket(GameData& gameData, const Player& player);
+BuildPlayerStatePacket(const GameData& gameData, size_t dense);
 
 int
-main()
+main(int argc, char** argv)
 {
+  auto options = ServerOptions();
+  if (!ParseOptions(argc, argv, options))
+    return EXIT_FAILURE;
+
   if (enet_initialize() < 0) {
     std::cerr << "An error occurred while initializing ENet.\n";
     return EXIT_FAILURE;
   }
   atexit(enet_deinitialize);
+  if (!options.Upstream.empty())
+    return RunRelay(options);
+  if (!options.Replay.empty())
+    return RunReplay(options);
 
-  auto address = ENetAddress{ ENET_HOST_ANY, NET_PORT };
-  auto server = enet_host_create(&address, NET_MAX_CLIENTS, NET_CHANNELS, 0, 0);
-  if (server == nullptr) {
+  auto capture = static_cast<std::FILE*>(nullptr);
+  if (!options.Capture.empty() &&
+      (capture = std::fopen(options.Capture.c_str(), "wb")) == nullptr) {
+    std::cerr << "Failed to open " << options.Capture << "\n";
+    return EXIT_FAILURE;
+  }
+  auto address = ENetAddress{ ENET_HOST_ANY, options.Port };
+  auto net = NetShards();
+  if (!net.Create(address, options.NetThreads, options.IoBatch, capture)) {
     std::cerr
       << "An error occurred while trying to create an ENet server host.\n";
     return EXIT_FAILURE;
   }
+  if (options.NetThreads > 0)
+    std::cout << "Servicing the network on " << net.GetShardCount()
+              << " shard thread(s)\n";
+  if (!net.IsBatched())
+    std::cout << "Batched socket I/O unavailable, using one call per packet\n";
+  auto maxBudget = net.GetMtu() - SNAPSHOT_HEADROOM;
+  if (options.SnapshotBudget == 0 || options.SnapshotBudget > maxBudget)
+    options.SnapshotBudget = maxBudget;
+  std::cout << "Snapshot budget " << options.SnapshotBudget << " bytes\n";
+
+  auto jobs = JobSystem(options.Threads);
+  std::cout << "Running on " << jobs.GetThreadCount() << " thread(s)\n";
 
   auto gameData = GameData();
-  auto serverData = ServerData{ server };
-  auto nextTick = enet_time_get();
+  gameData.TickStart = GetMicroseconds();
+  auto serverData = ServerData{ &net, &jobs };
+  serverData.snapshotBudget = options.SnapshotBudget;
+  serverData.snapshotInterval = std::max(TICK_RATE / options.SnapshotRate, 1u);
+  if (!options.StatsPrefix.empty() &&
+      !serverData.metrics.Open(options.StatsPrefix)) {
+    std::cerr << "Failed to open " << options.StatsPrefix << ".csv\n";
+    return EXIT_FAILURE;
+  }
+  auto recorder = MatchRecorder();
+  if (!options.Record.empty()) {
+    if (!recorder.Create(options.Record)) {
+      std::cerr << "Failed to create the recording " << options.Record << "\n";
+      return EXIT_FAILURE;
+    }
+    std::cout << "Recording to " << options.Record << "\n";
+    serverData.recorder = &recorder;
+  }
+
+#ifdef ACE_WITH_JSBSIM
+  auto flightModels = FlightModelPool(options.JSBSimRoot, options.Aircraft);
+  if (!options.Aircraft.empty()) {
+    auto start = GetMicroseconds();
+    if (!flightModels.Prewarm(options.FlightModels, jobs)) {
+      std::cerr << "Failed to load aircraft " << options.Aircraft << " from "
+                << options.JSBSimRoot << "\n";
+      return EXIT_FAILURE;
+    }
+    std::cout << "Loaded " << options.FlightModels << " " << options.Aircraft
+              << " flight model(s) in " << (GetMicroseconds() - start) / 1000
+              << "ms\n";
+    serverData.flightModels = &flightModels;
+  }
+#endif
+  auto scheduler = TickScheduler(net.GetWaitSocket(), NET_TICK * 1000);
+  if (!scheduler.UsesEpoll())
+    std::cout << "epoll unavailable, waiting with enet_socket_wait\n";
 
   while (true) {
-    auto now = enet_time_get();
-    auto event = ENetEvent();
-    while (enet_host_service(serverData.host, &event, NET_TIMEOUT) > 0)
-      do
-        switch (event.type) {
-          case ENetEventType::ENET_EVENT_TYPE_CONNECT: {
-            std::cout << enet_peer_get_id(event.peer) << " - Peer Connected\n";
-            {
-              auto it =
-                find_if(gameData.Players.begin(),
-                        gameData.Players.end(),
-                        [&](const auto& p) { return p.Peer == nullptr; });
-              if (it == gameData.Players.end()) {
-                auto& player = gameData.Players.emplace_back();
-                player.Index = gameData.Players.size() - 1;
-                it = gameData.Players.end() - 1;
-              }
-              auto& player = *it;
-              player.Peer = event.peer;
-              player.Name.clear();
-              player.Position = StartPos;
-              {
-                auto gameDataPacket = GameDataPacket();
-                gameDataPacket.PlayerIndex = player.Index;
-                enet_peer_send(
-                  player.Peer,
-                  0,
-                  BuildPacket(gameDataPacket, ENET_PACKET_FLAG_RELIABLE));
-              }
-            }
-            {
-              auto playerListPacket = BuidPlayerListPacket(gameData);
-              for (const auto& player : gameData.Players)
-                if (player.Peer != nullptr)
-                  enet_peer_send(player.Peer, 0, playerListPacket);
-            }
-          } break;
-
-          case ENetEventType::ENET_EVENT_TYPE_DISCONNECT_TIMEOUT: {
-            std::cout << enet_peer_get_id(event.peer)
-                      << " - Peer Disconnected (timeout)\n";
-          }
-
-          case ENetEventType::ENET_EVENT_TYPE_DISCONNECT: {
-            std::cout << enet_peer_get_id(event.peer)
-                      << " - Peer Disconnected\n";
-
-            auto it =
-              find_if(gameData.Players.begin(),
-                      gameData.Players.end(),
-                      [&](const auto& p) { return p.Peer == event.peer; });
-
-            auto& player = *it;
-            player.Peer = nullptr;
-
-            auto playerListPacket = BuidPlayerListPacket(gameData);
-            for (const auto& player : gameData.Players)
-              if (player.Peer != nullptr)
-                enet_peer_send(player.Peer, 0, playerListPacket);
-          } break;
-
-          case ENetEventType::ENET_EVENT_TYPE_RECEIVE: {
-            std::cout << enet_peer_get_id(event.peer) << " - Packet Received: "
-                      << enet_packet_get_length(event.packet) << " bytes\n";
-
-            auto it =
-              find_if(gameData.Players.begin(),
-                      gameData.Players.end(),
-                      [&](const auto& p) { return p.Peer == event.peer; });
-
-            auto& player = *it;
-
-            auto len = event.packet->dataLength;
-            auto bytes = std::vector<uint8_t>(len);
-            memcpy(bytes.data(), event.packet->data, len);
-
-            HandleMessage(player, gameData, bytes);
-
-            enet_packet_destroy(event.packet);
-          } break;
-        }
-      while (enet_host_check_events(serverData.host, &event) > 0);
+    scheduler.Wait();
+    net.Poll([&](const NetEvent& event) {
+      HandleEvent(serverData, gameData, options, event);
+    });
 
-    if (now >= nextTick) {
+    while (scheduler.NextTick()) {
+      auto tickStart = GetMicroseconds();
       ServerTick(serverData, gameData);
-      nextTick += NET_TICK;
+      RecordTick(serverData, gameData, tickStart, scheduler);
     }
   }
 
@@ -148,85 +334,863 @@ void
 ServerTick(ServerData& serverData, GameData& gameData)
 {
   gameData.TickIndex++;
+  gameData.TickStart = GetMicroseconds();
 
-  for (auto& player : gameData.Players) {
-    if (!player.InputBuffer.empty()) {
-      auto inc = 1.f;
-      if (player.InputBuffer.size() < TargetInputBufferSize)
-        inc *= 1.f - (TargetInputBufferSize - player.InputBuffer.size()) * .05f;
-      else if (player.InputBuffer.size() > TargetInputBufferSize)
-        inc *= 1.f + (player.InputBuffer.size() - TargetInputBufferSize) * .05f;
-      player.InputBufferAdvancement += inc;
-      if (player.InputBufferAdvancement >= 1.f)
-        while (player.InputBufferAdvancement >= 1.f) {
-          auto& currentInput = player.InputBuffer.front();
-          player.LastInput.Index = currentInput.Index;
-          player.LastInput.Yaw = currentInput.Yaw;
-          player.LastInput.Pitch = currentInput.Pitch;
-          player.LastInput.Roll = currentInput.Roll;
-          player.LastInput.Throttle = currentInput.Throttle;
-          player.InputBuffer.erase(player.InputBuffer.begin());
-          player.InputBufferAdvancement -= 1.f;
-        }
+  // Inputs coalesced while the buffers were full are published by the
+  // producer, the simulation thread, before the workers consume
+  auto& players = gameData.Players;
+  for (auto i = size_t(); i < players.Size(); i++)
+    players.Connection(i).InputBuffer.Flush();
+  serverData.jobs->ParallelFor(
+    players.Size(), PLAYERS_PER_JOB, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++) {
+        ConsumeInput(players.Connection(i), players.LastInputs[i]);
+        SimulatePlayer(players, i);
+      }
+    });
+
+  CaptureSnapshot(gameData);
+  if (serverData.recorder != nullptr)
+    serverData.recorder->RecordWorld(
+      gameData.Snapshots.Find(gameData.TickIndex - 1),
+      *gameData.Snapshots.Find(gameData.TickIndex));
+  gameData.Hits.Record(gameData.TickIndex, players);
+  ResolveShots(serverData, gameData);
+  SimulateProjectiles(serverData, gameData);
+
+  // The player state still goes out every tick for the prediction
+  auto sendWorld = gameData.TickIndex % serverData.snapshotInterval == 0;
+  auto& packets = serverData.outgoingPackets;
+  auto& views = serverData.views;
+  packets.assign(players.Size(), nullptr);
+  views.assign(players.Size(), ClientView());
+  serverData.jobs->ParallelFor(
+    players.Size(), PLAYERS_PER_JOB, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++) {
+        if (sendWorld)
+          views[i] = PrepareClientView(serverData, gameData, i);
+        packets[i] = BuildPlayerStatePacket(gameData, i);
+      }
+    });
+
+  GroupClientViews(serverData);
+  const auto& leaders = serverData.groupLeaders;
+  auto& worldPackets = serverData.worldPackets;
+  worldPackets.assign(leaders.size(), nullptr);
+  serverData.jobs->ParallelFor(
+    leaders.size(), PLAYERS_PER_JOB, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++)
+        worldPackets[i] = NetShards::Share(
+          BuildPlayerPositionPacket(gameData, views[leaders[i]]));
+    });
+
+  // ENet reference counts the shared packets and frees them once sent
+  auto& net = *serverData.net;
+  for (auto i = size_t(); i < players.Size(); i++) {
+    auto peer = players.Connection(i).Peer;
+    if (sendWorld)
+      net.Send(peer, worldPackets[views[i].group]);
+    net.Send(peer, packets[i]);
+  }
+  for (auto i = size_t(); i < leaders.size(); i++)
+    net.Release(players.Connection(leaders[i]).Peer, worldPackets[i]);
+  if (sendWorld)
+    SendSpectatorFeed(serverData, gameData);
+  AnswerPings(serverData, gameData);
+  net.Flush();
+}
+
+void
+RecordTick(ServerData& serverData,
+           const GameData& gameData,
+           uint64_t start,
+           const TickScheduler& scheduler)
+{
+  auto& metrics = serverData.metrics;
+  auto sample = metrics.Sample(gameData.TickIndex,
+                               GetMicroseconds() - start,
+                               scheduler.Lateness,
+                               serverData.net->GetBytesSent(),
+                               serverData.net->GetPacketsSent(),
+                               serverData.net->GetPeersCount());
+  metrics.Record(sample);
+
+  if (gameData.TickIndex % METRICS_SUMMARY_TICKS == 0) {
+    const auto& duration = metrics.TickDuration;
+    std::cout << "Tick " << gameData.TickIndex << " - " << sample.Peers
+              << " peers, tick p50 " << duration.Percentile(50) << "us p99 "
+              << duration.Percentile(99) << "us max " << duration.Max
+              << "us, " << metrics.BytesPerTick.Mean() << " bytes/tick, "
+              << serverData.groupLeaders.size() << " world packet(s), "
+              << gameData.Projectiles.Size() << " projectile(s), start "
+              << "jitter p99 " << metrics.TickStartJitter.Percentile(99)
+              << "us, " << scheduler.SkippedTicks << " skipped tick(s)\n";
+    metrics.WriteSummary();
+  }
+}
+
+void
+ConsumeInput(PlayerConnection& connection, PlayerInput& lastInput)
+{
+  auto& buffer = connection.InputBuffer;
+  if (!buffer.Empty()) {
+    auto size = static_cast<int>(buffer.Size());
+    auto inc = 1.f;
+    if (size < TargetInputBufferSize)
+      inc *= 1.f - (TargetInputBufferSize - size) * .05f;
+    else if (size > TargetInputBufferSize)
+      inc *= 1.f + (size - TargetInputBufferSize) * .05f;
+    connection.InputBufferAdvancement += inc;
+    while (connection.InputBufferAdvancement >= 1.f && buffer.Pop(lastInput))
+      connection.InputBufferAdvancement -= 1.f;
+  }
+}
+
+void
+SimulatePlayer(PlayerStore& players, size_t dense)
+{
+  auto& position = players.Positions[dense];
+  auto& rotation = players.Rotations[dense];
+  const auto& input = players.LastInputs[dense];
+  auto previous = position;
+#ifdef ACE_WITH_JSBSIM
+  if (players.Aircraft[dense] != nullptr)
+    StepFlightModel(
+      *players.Aircraft[dense], input, NET_TICK, position, rotation);
+  else
+#endif
+    ComputePhysics(position, rotation, input, NET_TICK);
+  players.Velocities[dense] = position - previous;
+}
+
+bool
+ParseOptions(int argc, char** argv, ServerOptions& options)
+{
+  for (auto i = 1; i < argc; i++) {
+    auto arg = std::string(argv[i]);
+    if (arg == "--threads" && i + 1 < argc) {
+      auto threads = std::atoi(argv[++i]);
+      if (threads <= 0) {
+        std::cerr << "--threads expects a positive number\n";
+        return false;
+      }
+      options.Threads = threads;
+    } else if (arg == "--stats" && i + 1 < argc)
+      options.StatsPrefix = argv[++i];
+    else if (arg == "--net-threads" && i + 1 < argc)
+      options.NetThreads =
+        std::clamp(std::atoi(argv[++i]), 0, NET_MAX_SHARDS);
+    else if (arg == "--verbose")
+      options.Verbose = true;
+    else if (arg == "--io-batch" && i + 1 < argc)
+      options.IoBatch = std::max(std::atoi(argv[++i]), 0);
+    else if (arg == "--capture" && i + 1 < argc)
+      options.Capture = argv[++i];
+    else if (arg == "--snapshot-budget" && i + 1 < argc)
+      options.SnapshotBudget =
+        std::max(std::atoi(argv[++i]), SNAPSHOT_MIN_BUDGET);
+    else if (arg == "--snapshot-rate" && i + 1 < argc)
+      options.SnapshotRate = std::clamp(std::atoi(argv[++i]), 1, TICK_RATE);
+    else if (arg == "--port" && i + 1 < argc)
+      options.Port =
+        static_cast<uint16_t>(std::clamp(std::atoi(argv[++i]), 1, 0xFFFF));
+    else if (arg == "--relay" && i + 1 < argc)
+      options.Upstream = argv[++i];
+    else if (arg == "--relay-delay" && i + 1 < argc)
+      options.RelayDelay = std::max(std::atof(argv[++i]), 0.);
+    else if (arg == "--record" && i + 1 < argc)
+      options.Record = argv[++i];
+    else if (arg == "--replay" && i + 1 < argc)
+      options.Replay = argv[++i];
+    else if (arg == "--replay-from" && i + 1 < argc)
+      options.ReplayFrom = static_cast<uint32_t>(std::atoll(argv[++i]));
+#ifdef ACE_WITH_JSBSIM
+    else if (arg == "--aircraft" && i + 1 < argc)
+      options.Aircraft = argv[++i];
+    else if (arg == "--jsbsim-root" && i + 1 < argc)
+      options.JSBSimRoot = argv[++i];
+    else if (arg == "--flight-models" && i + 1 < argc)
+      options.FlightModels = std::max(std::atoi(argv[++i]), 0);
+#endif
+    else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--threads N] [--net-threads N] [--stats <prefix>]"
+                   " [--verbose]"
+                   " [--io-batch N] [--snapshot-budget <bytes>]"
+                   " [--snapshot-rate <Hz>]"
+                   " [--capture <file>] [--port N]"
+                   " [--relay <host[:port]>] [--relay-delay <seconds>]"
+                   " [--record <file>] [--replay <file>]"
+                   " [--replay-from <tick>]"
+#ifdef ACE_WITH_JSBSIM
+                   " [--aircraft <name>] [--jsbsim-root <dir>]"
+                   " [--flight-models N]"
+#endif
+                   "\n";
+      return false;
     }
-    ComputePhysics(player, player.LastInput, NET_TICK);
   }
+  return true;
+}
 
-  for (const auto& player : gameData.Players)
-    if (player.Peer != nullptr) {
-      auto packet = BuildPlayerPositionPacket(gameData, player);
-      enet_peer_send(player.Peer, 0, packet);
+// Players are capped at NET_MAX_CLIENTS over every shard and spectators at
+// SPECTATOR_MAX_PEERS, a peer past that is turned away
+void
+HandleEvent(ServerData& serverData,
+            GameData& gameData,
+            const ServerOptions& options,
+            const NetEvent& event)
+{
+  auto& net = *serverData.net;
+  auto& players = gameData.Players;
+  switch (event.Type) {
+    case ENetEventType::ENET_EVENT_TYPE_CONNECT: {
+      std::cout << event.Peer.Slot() << " - Peer Connected\n";
+      auto gameDataPacket = GameDataPacket();
+      if (event.Data == NET_CONNECT_SPECTATOR) {
+        auto& spectators = gameData.Spectators;
+        if (spectators.size() >= SPECTATOR_MAX_PEERS) {
+          net.Disconnect(event.Peer);
+          break;
+        }
+        spectators.push_back({ event.Peer });
+        gameData.FeedTickIndex = 0;
+        gameDataPacket.PlayerIndex = SPECTATOR_PLAYER_INDEX;
+        net.Send(event.Peer,
+                 BuildPacket(gameDataPacket, ENET_PACKET_FLAG_RELIABLE));
+        net.Send(event.Peer, BuidPlayerListPacket(gameData));
+        break;
+      }
+      if (players.Size() >= NET_MAX_CLIENTS) {
+        net.Disconnect(event.Peer);
+        break;
+      }
+      auto handle = players.Create(event.Peer);
+#ifdef ACE_WITH_JSBSIM
+      if (serverData.flightModels != nullptr)
+        players.Aircraft[players.Dense(handle)] =
+          serverData.flightModels->Acquire();
+#endif
+      gameDataPacket.PlayerIndex = handle.Index();
+      net.Send(event.Peer,
+               BuildPacket(gameDataPacket, ENET_PACKET_FLAG_RELIABLE));
+      BroadcastPlayerList(serverData, gameData);
+    } break;
+
+    case ENetEventType::ENET_EVENT_TYPE_DISCONNECT_TIMEOUT: {
+      std::cout << event.Peer.Slot() << " - Peer Disconnected (timeout)\n";
     }
+
+    case ENetEventType::ENET_EVENT_TYPE_DISCONNECT: {
+      std::cout << event.Peer.Slot() << " - Peer Disconnected\n";
+
+      auto& spectators = gameData.Spectators;
+      if (auto spectator = FindSpectator(gameData, event.Peer)) {
+        spectators.erase(spectators.begin() + (spectator - spectators.data()));
+        break;
+      }
+      auto handle = players.FromPeer(event.Peer);
+      if (!players.IsValid(handle))
+        break;
+#ifdef ACE_WITH_JSBSIM
+      if (serverData.flightModels != nullptr)
+        serverData.flightModels->Release(
+          players.Aircraft[players.Dense(handle)]);
+#endif
+      players.Destroy(handle);
+      BroadcastPlayerList(serverData, gameData);
+    } break;
+
+    case ENetEventType::ENET_EVENT_TYPE_RECEIVE: {
+      if (options.Verbose)
+        std::cout << event.Peer.Slot() << " - Packet Received: "
+                  << enet_packet_get_length(event.Packet) << " bytes\n";
+
+      auto handle = players.FromPeer(event.Peer);
+      if (players.IsValid(handle))
+        HandleMessage(handle, gameData, event.Packet);
+      else if (auto spectator = FindSpectator(gameData, event.Peer))
+        HandleSpectatorMessage(*spectator, gameData, event.Packet);
+
+      enet_packet_destroy(event.Packet);
+    } break;
+
+    default:
+      break;
+  }
 }
 
 void
-HandleMessage(Player& player,
+HandleMessage(PlayerHandle handle,
               GameData& gameData,
-              const std::vector<uint8_t>& message)
+              const ENetPacket* message)
 {
-  auto offset = size_t();
-  auto opcode = static_cast<Opcode>(Unserialize_u8(message, offset));
+  auto& connection = gameData.Players.Connections[handle.Index()];
+  auto reader = BitReader(message->data, message->dataLength);
+  auto opcode = static_cast<Opcode>(reader.ReadU8());
 
   switch (opcode) {
     case Opcode::C_PLAYERINPUT: {
-      auto input = PlayerInputPacket::Unserialize(message, offset);
-      player.InputBuffer.push_back(input.Input);
+      auto input = PlayerInputPacket::Unserialize(reader);
+      if (reader.Overflowed())
+        break;
+      // Inputs overlap between datagrams, only the new ones are buffered
+      for (const auto& playerInput : input.Inputs)
+        if (playerInput.Index > connection.LastReceivedInputIndex) {
+          connection.InputBuffer.Push(playerInput);
+          connection.LastReceivedInputIndex = playerInput.Index;
+        }
+      if (input.AckTickIndex > connection.AckTickIndex &&
+          input.AckTickIndex <= gameData.TickIndex)
+        connection.AckTickIndex = input.AckTickIndex;
+    } break;
+    case Opcode::C_FIRE: {
+      auto fire = FirePacket::Unserialize(reader);
+      auto length = fire.Direction.Length();
+      if (reader.Overflowed() || !(length > .5f && length < 2.f) ||
+          gameData.TickIndex < connection.NextFireTickIndex)
+        break;
+      connection.NextFireTickIndex = gameData.TickIndex + FIRE_INTERVAL_TICKS;
+      auto& shot = gameData.Shots.emplace_back();
+      shot.Shooter = handle;
+      shot.ViewTickIndex = fire.ViewTickIndex;
+      shot.ViewFraction = fire.ViewFraction;
+      shot.Direction = fire.Direction / length;
+    } break;
+    case Opcode::C_LAUNCH: {
+      auto launch = LaunchPacket::Unserialize(reader);
+      auto length = launch.Direction.Length();
+      if (reader.Overflowed() || !(length > .5f && length < 2.f) ||
+          gameData.TickIndex < connection.NextLaunchTickIndex)
+        break;
+      connection.NextLaunchTickIndex =
+        gameData.TickIndex + PROJECTILE_INTERVAL_TICKS;
+      auto& pending = gameData.Launches.emplace_back();
+      pending.Shooter = handle;
+      pending.Direction = launch.Direction / length;
+    } break;
+
+    case Opcode::C_PING: {
+      auto ping = PingPacket::Unserialize(reader);
+      if (reader.Overflowed())
+        break;
+      connection.PingClientTime = ping.ClientTime;
+      connection.PingReceiveTick = TickClock(gameData);
+      connection.PingPending = true;
     } break;
   }
 }
 
+// nullptr for a player
+SpectatorConnection*
+FindSpectator(GameData& gameData, NetPeerId peer)
+{
+  for (auto& spectator : gameData.Spectators)
+    if (spectator.Peer.Value == peer.Value)
+      return &spectator;
+  return nullptr;
+}
+
+// Spectators are answered pings so that they render on the tick clock too,
+// anything else they send is ignored
+void
+HandleSpectatorMessage(SpectatorConnection& spectator,
+                       const GameData& gameData,
+                       const ENetPacket* message)
+{
+  auto reader = BitReader(message->data, message->dataLength);
+  if (static_cast<Opcode>(reader.ReadU8()) != Opcode::C_PING)
+    return;
+  auto ping = PingPacket::Unserialize(reader);
+  if (reader.Overflowed())
+    return;
+  spectator.PingClientTime = ping.ClientTime;
+  spectator.PingReceiveTick = TickClock(gameData);
+  spectator.PingPending = true;
+}
+
 ENetPacket*
 BuidPlayerListPacket(const GameData& gameData)
 {
+  const auto& players = gameData.Players;
   auto packet = PlayerListPacket();
-  for (const auto& player : gameData.Players)
-    if (player.Peer != nullptr) {
-      auto& packetPlayer = packet.Players.emplace_back();
-      packetPlayer.Index = player.Index;
-      packetPlayer.Name = player.Name;
-    }
+  for (auto i = size_t(); i < players.Size(); i++) {
+    auto& packetPlayer = packet.Players.emplace_back();
+    packetPlayer.Index = players.Indices[i];
+    packetPlayer.Name = players.Connection(i).Name;
+  }
   return BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE);
 }
 
-ENetPacket*
-BuildPlayerPositionPacket(GameData& gameData, const Player& player)
+void
+BroadcastPlayerList(ServerData& serverData, const GameData& gameData)
 {
+  auto packet = BuidPlayerListPacket(gameData);
+  if (serverData.recorder != nullptr)
+    serverData.recorder->RecordPlayerList(
+      gameData.TickIndex, packet->data, packet->dataLength);
+  serverData.net->Broadcast(packet);
+}
+
+void
+CaptureSnapshot(GameData& gameData)
+{
+  auto& snapshot = gameData.Snapshots.Push(gameData.TickIndex);
+  gameData.Grid.Clear();
+  const auto& players = gameData.Players;
+  snapshot.Players.resize(players.Size());
+  for (auto i = size_t(); i < players.Size(); i++) {
+    auto& entity = snapshot.Players[i];
+    entity.PlayerIndex = players.Indices[i];
+    entity.Position = QuantizedVector3::FromVector3(players.Positions[i]);
+    entity.Rotation = QuantizedRotation::FromVector3(players.Rotations[i]);
+    entity.Velocity = QuantizedVelocity::FromVector3(players.Velocities[i]);
+    gameData.Grid.Insert(players.Indices[i], players.Positions[i]);
+  }
+}
+
+// Shots received since the last tick, against the rewound hit capsules
+void
+ResolveShots(ServerData& serverData, GameData& gameData)
+{
+  const auto& players = gameData.Players;
+  for (const auto& shot : gameData.Shots) {
+    if (!players.IsValid(shot.Shooter))
+      continue;
+    const auto& origin = players.Positions[players.Dense(shot.Shooter)];
+    auto result = gameData.Hits.Resolve(gameData.TickIndex,
+                                        shot.ViewTickIndex,
+                                        shot.ViewFraction,
+                                        shot.Shooter.Index(),
+                                        Ray(origin, shot.Direction));
+    if (!result.Hit)
+      continue;
+
+    auto packet = HitPacket();
+    packet.TickIndex = gameData.TickIndex;
+    packet.ShooterIndex = shot.Shooter.Index();
+    packet.TargetIndex = result.PlayerIndex;
+    serverData.net->Broadcast(BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE));
+  }
+  gameData.Shots.clear();
+}
+
+// Moves the live projectiles against this tick's hit capsules, then spawns
+// the launches received since the last tick. Both hits and spawns are sent
+// to everyone, clients extrapolate the projectiles on their own
+void
+SimulateProjectiles(ServerData& serverData, GameData& gameData)
+{
+  auto& projectiles = gameData.Projectiles;
+  projectiles.Step(gameData.Hits.Find(gameData.TickIndex)->Capsules);
+  for (const auto& hit : projectiles.Hits) {
+    auto packet = HitPacket();
+    packet.TickIndex = gameData.TickIndex;
+    packet.ShooterIndex = hit.OwnerIndex;
+    packet.TargetIndex = hit.TargetIndex;
+    packet.ProjectileId = hit.Id;
+    serverData.net->Broadcast(BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE));
+  }
+
+  const auto& players = gameData.Players;
+  for (const auto& launch : gameData.Launches) {
+    if (!players.IsValid(launch.Shooter))
+      continue;
+    const auto& origin = players.Positions[players.Dense(launch.Shooter)];
+    projectiles.Spawn(launch.Shooter.Index(),
+                      origin + launch.Direction * PROJECTILE_SPAWN_OFFSET,
+                      launch.Direction * PROJECTILE_SPEED);
+  }
+  gameData.Launches.clear();
+  if (projectiles.Spawns.empty())
+    return;
+
+  auto packet = ProjectileSpawnPacket();
+  packet.TickIndex = gameData.TickIndex;
+  packet.Spawns.swap(projectiles.Spawns);
+  serverData.net->Broadcast(BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE));
+}
+
+double
+TickClock(const GameData& gameData)
+{
+  auto elapsed = GetMicroseconds() - gameData.TickStart;
+  return gameData.TickIndex + elapsed / (NET_TICK * 1000.);
+}
+
+// Right before the flush so that the time the pongs wait for it is counted as
+// held by the server, not as network delay. A client pinging faster than the
+// tick rate only gets its last ping answered
+void
+AnswerPings(ServerData& serverData, GameData& gameData)
+{
+  auto& players = gameData.Players;
+  auto sendTick = TickClock(gameData);
+  auto answer = [&](auto& connection) {
+    if (!connection.PingPending)
+      return;
+    connection.PingPending = false;
+    auto pong = PongPacket();
+    pong.ClientTime = connection.PingClientTime;
+    pong.ReceiveTick = connection.PingReceiveTick;
+    pong.SendTick = sendTick;
+    serverData.net->Send(connection.Peer,
+                         BuildPacket(pong, ENET_PACKET_FLAG_UNSEQUENCED));
+  };
+  for (auto i = size_t(); i < players.Size(); i++)
+    answer(players.Connection(i));
+  for (auto& spectator : gameData.Spectators)
+    answer(spectator);
+}
+
+// Every player of the world snapshot, against the previous feed packet. The
+// feed is reliable so that the previous packet is always there to decode
+// against, a single copy goes to each spectator and relays fan it out
+void
+SendSpectatorFeed(ServerData& serverData, GameData& gameData)
+{
+  const auto& spectators = gameData.Spectators;
+  if (spectators.empty())
+    return;
+  auto baseline = gameData.Snapshots.Find(gameData.FeedTickIndex);
+  if (gameData.TickIndex - gameData.FeedKeyframeTickIndex >=
+      SPECTATOR_KEYFRAME_INTERVAL)
+    baseline = nullptr;
+  if (baseline == nullptr)
+    gameData.FeedKeyframeTickIndex = gameData.TickIndex;
+  gameData.FeedTickIndex = gameData.TickIndex;
+
   auto packet = PlayersPositionPacket();
-  packet.LastInputIndex = player.LastInput.Index;
   packet.TickIndex = gameData.TickIndex;
+  if (baseline != nullptr)
+    packet.BaselineTickIndex = baseline->TickIndex;
+  EncodeSnapshotDelta(baseline,
+                      *gameData.Snapshots.Find(gameData.TickIndex),
+                      packet.Players,
+                      packet.RemovedPlayers);
 
-  auto& currentPlayerData = packet.CurrentPlayerData.emplace();
-  currentPlayerData.Position = player.Position;
+  auto& net = *serverData.net;
+  auto feed = BuildPacket(packet, ENET_PACKET_FLAG_RELIABLE);
+  for (auto i = size_t(1); i < spectators.size(); i++)
+    net.Send(spectators[i].Peer,
+             enet_packet_create(feed->data, feed->dataLength, feed->flags));
+  net.Send(spectators[0].Peer, feed);
+}
+
+// A relay serves the spectators of its upstream rather than a match
+int
+RunRelay(const ServerOptions& options)
+{
+  auto upstream = ENetAddress();
+  if (!ParseRelayAddress(options.Upstream, upstream)) {
+    std::cerr << "Failed to resolve " << options.Upstream << "\n";
+    return EXIT_FAILURE;
+  }
+  auto address = ENetAddress{ ENET_HOST_ANY, options.Port };
+  auto relay = SpectatorRelay();
+  if (!relay.Create(address,
+                    upstream,
+                    static_cast<uint64_t>(options.RelayDelay * 1e6))) {
+    std::cerr
+      << "An error occurred while trying to create the ENet relay hosts.\n";
+    return EXIT_FAILURE;
+  }
+  std::cout << "Relaying " << options.Upstream << " on port " << options.Port
+            << " with a " << options.RelayDelay << "s delay\n";
+  relay.Run();
+  return EXIT_SUCCESS;
+}
 
-  for (const auto& other : gameData.Players) {
-    if (player.Index == other.Index)
+// A replay plays a recording to spectators rather than running a match
+int
+RunReplay(const ServerOptions& options)
+{
+  auto address = ENetAddress{ ENET_HOST_ANY, options.Port };
+  auto replay = ReplayPlayer();
+  auto start = GetMicroseconds();
+  if (!replay.Create(address, options.Replay, options.ReplayFrom)) {
+    std::cerr << "Failed to open the recording " << options.Replay
+              << " or to create the ENet replay host.\n";
+    return EXIT_FAILURE;
+  }
+  std::cout << "Replaying " << options.Replay << " on port " << options.Port
+            << " from tick " << replay.GetTickIndex() << ", opened in "
+            << GetMicroseconds() - start << "us\n";
+  replay.Run();
+  std::cout << "Replay ended at tick " << replay.GetTickIndex() << "\n";
+  return EXIT_SUCCESS;
+}
+
+// Additive increase while the peer keeps up, multiplicative decrease once it
+// loses reliable packets or its round trip time grows. ENet only counts the
+// losses of reliable packets, they stand for the whole link
+void
+UpdateSnapshotBudget(PlayerConnection& connection,
+                     const NetPeerStats& stats,
+                     size_t maxBudget,
+                     uint32_t tickIndex)
+{
+  if (connection.SnapshotBudget == 0)
+    connection.SnapshotBudget = maxBudget;
+  if (tickIndex - connection.BudgetTickIndex < SNAPSHOT_RATE_INTERVAL)
+    return;
+  connection.BudgetTickIndex = tickIndex;
+
+  auto sent = stats.PacketsSent.load(std::memory_order_relaxed);
+  auto lost = stats.PacketsLost.load(std::memory_order_relaxed);
+  auto rtt = stats.Rtt.load(std::memory_order_relaxed);
+  auto loss = sent > connection.PacketsSent
+                ? static_cast<float>(lost - connection.PacketsLost) /
+                    static_cast<float>(sent - connection.PacketsSent)
+                : 0.f;
+  connection.PacketsSent = sent;
+  connection.PacketsLost = lost;
+  if (connection.MinRtt == 0 || rtt < connection.MinRtt)
+    connection.MinRtt = rtt;
+
+  auto& budget = connection.SnapshotBudget;
+  if (loss > SNAPSHOT_MAX_LOSS || rtt > connection.MinRtt + SNAPSHOT_RTT_SLACK)
+    budget = std::max<size_t>(budget * 3 / 4, SNAPSHOT_MIN_BUDGET);
+  else
+    budget = std::min<size_t>(budget + SNAPSHOT_BUDGET_STEP, maxBudget);
+}
+
+// Every entity of interest is listed so that the client keeps it, by default
+// with the state last sent, which costs little or nothing against the
+// baseline. Due entities then get their current state in priority order for
+// as long as the packet stays under the budget, the others keep accumulating
+void
+BuildClientView(const ServerData& serverData,
+                GameData& gameData,
+                size_t dense,
+                const WorldSnapshot* baseline,
+                WorldSnapshot& view)
+{
+  struct Candidate
+  {
+    uint16_t Index;
+    float Priority;
+    const EntitySnapshot* Base;
+    const EntitySnapshot* Current;
+    const EntitySnapshot* State;
+    int StateBits;
+  };
+
+  auto& players = gameData.Players;
+  auto& connection = players.Connection(dense);
+  auto& priorities = connection.Priorities;
+  if (priorities.empty())
+    for (auto index = 0; index < NET_MAX_CLIENTS; index++)
+      priorities.push_back(GetInitialPriority(index));
+
+  const auto& position = players.Positions[dense];
+  thread_local auto indices = std::vector<uint16_t>();
+  thread_local auto candidates = std::vector<Candidate>();
+  thread_local auto order = std::vector<size_t>();
+  indices.clear();
+  candidates.clear();
+  order.clear();
+  gameData.Grid.Query(Sphere(position, INTEREST_MID_RADIUS),
+                      [&](uint16_t index) { indices.push_back(index); });
+  std::sort(indices.begin(), indices.end());
+
+  // The world snapshot is in dense order, the others are walked along with
+  // the sorted candidates
+  const auto& world = *gameData.Snapshots.Find(gameData.TickIndex);
+  auto interval = serverData.snapshotInterval;
+  auto previous =
+    connection.SentSnapshots.Find(gameData.TickIndex - interval);
+  auto baseCursor = size_t();
+  auto previousCursor = size_t();
+  auto find =
+    [](const WorldSnapshot* snapshot, size_t& cursor, uint16_t index) {
+      if (snapshot == nullptr)
+        return static_cast<const EntitySnapshot*>(nullptr);
+      const auto& entities = snapshot->Players;
+      while (cursor < entities.size() && entities[cursor].PlayerIndex < index)
+        cursor++;
+      return cursor < entities.size() && entities[cursor].PlayerIndex == index
+               ? &entities[cursor]
+               : nullptr;
+    };
+  for (auto index : indices) {
+    auto target = players.DenseOf(index);
+    auto priority = GetInterestPriority(position, players.Positions[target]);
+    if (priority == 0.f)
+      continue;
+
+    auto& candidate = candidates.emplace_back();
+    candidate.Index = index;
+    candidate.Priority = priorities[index] += priority * interval;
+    candidate.Base = find(baseline, baseCursor, index);
+    candidate.Current = &world.Players[target];
+    candidate.State = find(previous, previousCursor, index);
+    if (candidate.State == nullptr)
+      candidate.State = candidate.Base;
+    candidate.StateBits =
+      candidate.State
+        ? PlayersPositionPacket::EntityBits(candidate.Base, *candidate.State)
+        : 0;
+    if (candidate.Priority >= 1.f || candidate.State == nullptr)
+      order.push_back(candidates.size() - 1);
+  }
+
+  // Opcode, tick, baseline distance, entity count and removed entities
+  auto budget = static_cast<int>(connection.SnapshotBudget) * 8;
+  auto bits = 8 + 32 + VarUintBits(SNAPSHOT_HISTORY) +
+              VarUintBits(static_cast<uint32_t>(candidates.size()));
+  auto removed = 0u;
+  if (baseline != nullptr) {
+    auto it = candidates.begin();
+    for (const auto& entity : baseline->Players) {
+      while (it != candidates.end() && it->Index < entity.PlayerIndex)
+        ++it;
+      if (it == candidates.end() || it->Index != entity.PlayerIndex) {
+        bits += VarUintBits(entity.PlayerIndex);
+        removed++;
+      }
+    }
+  }
+  bits += VarUintBits(removed);
+  for (const auto& candidate : candidates)
+    bits += candidate.StateBits;
+
+  // Entities the client doesn't have yet come first
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const auto& first = candidates[a];
+    const auto& second = candidates[b];
+    if ((first.State == nullptr) != (second.State == nullptr))
+      return first.State == nullptr;
+    return first.Priority > second.Priority;
+  });
+  for (auto i : order) {
+    auto& candidate = candidates[i];
+    auto currentBits =
+      PlayersPositionPacket::EntityBits(candidate.Base, *candidate.Current);
+    if (bits + currentBits - candidate.StateBits > budget)
       continue;
-    if (other.Peer != nullptr) {
-      auto& packetPlayer = packet.Players.emplace_back();
-      packetPlayer.PlayerIndex = other.Index;
-      packetPlayer.Position = other.Position;
+    bits += currentBits - candidate.StateBits;
+    candidate.State = candidate.Current;
+    candidate.StateBits = currentBits;
+    priorities[candidate.Index] = 0.f;
+  }
+
+  // Repeating the last sent states can exceed the budget on its own after a
+  // long stretch without acks, the lowest priorities fall back to the
+  // baseline, which is free, or are left out until the budget allows
+  if (bits > budget) {
+    order.clear();
+    for (auto i = size_t(); i < candidates.size(); i++)
+      order.push_back(i);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return candidates[a].Priority < candidates[b].Priority;
+    });
+    for (auto i = order.begin(); i != order.end() && bits > budget; ++i) {
+      auto& candidate = candidates[*i];
+      bits -= candidate.StateBits;
+      candidate.State = candidate.Base;
+      candidate.StateBits = 0;
+    }
+  }
+
+  for (const auto& candidate : candidates)
+    if (candidate.State != nullptr)
+      view.Players.push_back(*candidate.State);
+}
+
+ClientView
+PrepareClientView(const ServerData& serverData,
+                  GameData& gameData,
+                  size_t dense)
+{
+  auto& connection = gameData.Players.Connection(dense);
+  UpdateSnapshotBudget(connection,
+                       serverData.net->GetStats(connection.Peer),
+                       serverData.snapshotBudget,
+                       gameData.TickIndex);
+  auto& view = connection.SentSnapshots.Push(gameData.TickIndex);
+  auto baseline = connection.SentSnapshots.Find(connection.AckTickIndex);
+  BuildClientView(serverData, gameData, dense, baseline, view);
+
+  auto clientView = ClientView();
+  clientView.view = &view;
+  clientView.baseline = baseline;
+  clientView.shard = connection.Peer.Shard();
+  clientView.hash = view.Hash() ^ clientView.shard;
+  if (clientView.baseline != nullptr)
+    clientView.hash ^= clientView.baseline->Hash() * 31 +
+                       clientView.baseline->TickIndex;
+  return clientView;
+}
+
+// Sorting by hash puts the candidates for sharing next to each other, every
+// view is then compared with the leaders of its run to rule out collisions
+void
+GroupClientViews(ServerData& serverData)
+{
+  auto& views = serverData.views;
+  auto& order = serverData.viewOrder;
+  auto& leaders = serverData.groupLeaders;
+  order.clear();
+  leaders.clear();
+  for (auto i = size_t(); i < views.size(); i++)
+    if (views[i].view != nullptr)
+      order.push_back(i);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return views[a].hash < views[b].hash;
+  });
+
+  auto sameBaseline = [](const WorldSnapshot* a, const WorldSnapshot* b) {
+    if (a == nullptr || b == nullptr)
+      return a == b;
+    return a->TickIndex == b->TickIndex && a->Players == b->Players;
+  };
+
+  auto runStart = leaders.size();
+  for (auto k = size_t(); k < order.size(); k++) {
+    auto& view = views[order[k]];
+    if (k == 0 || views[order[k - 1]].hash != view.hash)
+      runStart = leaders.size();
+
+    auto group = runStart;
+    for (; group < leaders.size(); group++) {
+      const auto& leader = views[leaders[group]];
+      if (leader.shard == view.shard &&
+          sameBaseline(leader.baseline, view.baseline) &&
+          leader.view->Players == view.view->Players)
+        break;
     }
+    if (group == leaders.size())
+      leaders.push_back(order[k]);
+    view.group = group;
   }
+}
+
+ENetPacket*
+BuildPlayerPositionPacket(const GameData& gameData, const ClientView& view)
+{
+  auto packet = PlayersPositionPacket();
+  packet.TickIndex = gameData.TickIndex;
+  if (view.baseline != nullptr)
+    packet.BaselineTickIndex = view.baseline->TickIndex;
+
+  EncodeSnapshotDelta(
+    view.baseline, *view.view, packet.Players, packet.RemovedPlayers);
+
+  return BuildPacket(packet, 0);
+}
+
+ENetPacket*
+BuildPlayerStatePacket(const GameData& gameData, size_t dense)
+{
+  const auto& players = gameData.Players;
+  auto packet = PlayerStatePacket();
+  packet.LastInputIndex = players.LastInputs[dense].Index;
+  packet.TickIndex = gameData.TickIndex;
+
+  auto& currentPlayerData = packet.CurrentPlayerData.emplace();
+  currentPlayerData.Position = players.Positions[dense];
+  currentPlayerData.Rotation = players.Rotations[dense];
 
   return BuildPacket(packet, 0);
 }
\ No newline at end of file
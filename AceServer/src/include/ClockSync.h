@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Protocol.h"
+#include <algorithm>
+#include <cstdint>
+
+constexpr auto CLOCK_TICKS_PER_SECOND = 1000. / NET_TICK;
+// A ping every quarter of a second, the offset is taken from the best of the
+// last CLOCK_SAMPLES pongs and moves by at most CLOCK_MAX_SLEW ticks per pong
+// once they are all in
+constexpr auto CLOCK_PING_INTERVAL_TICKS = 15;
+constexpr auto CLOCK_SAMPLES = 16;
+constexpr auto CLOCK_MAX_SLEW = .05;
+
+// The render delay covers JITTER_PERCENTILE of the last JITTER_SAMPLES
+// snapshot arrivals plus RENDER_DELAY_MARGIN ticks. Playback runs up to
+// RENDER_DELAY_RATE faster or slower than real time to follow it
+constexpr auto JITTER_SAMPLES = 64;
+constexpr auto JITTER_PERCENTILE = 95;
+constexpr auto RENDER_DELAY_MARGIN = .25;
+constexpr auto RENDER_DELAY_RATE = .1;
+constexpr auto RENDER_DELAY_MAX = INTERPOLATION_BUFFER_CAPACITY - 2.;
+
+// Client clock in pings, microseconds truncated to 32 bits
+inline uint32_t
+ClockStamp(double seconds)
+{
+  return static_cast<uint32_t>(static_cast<uint64_t>(seconds * 1e6));
+}
+
+// Client time a stamp was taken at, for stamps less than an hour old
+inline double
+ClockStampTime(uint32_t stamp, double now)
+{
+  return now - static_cast<uint32_t>(ClockStamp(now) - stamp) / 1e6;
+}
+
+// Server tick clock estimated from the client clock, NTP style. A pong gives
+// the round trip without the time the server held the ping, and an offset
+// that assumes both legs took as long. Queuing only ever adds delay and makes
+// the legs unequal, so the pong with the lowest delay of the last few is the
+// one trusted. Once synchronized the offset slews instead of jumping, remote
+// players would visibly skip
+class ClockSync
+{
+public:
+  // Client times in seconds, server times on the tick clock
+  void AddSample(double clientSend,
+                 double serverReceive,
+                 double serverSend,
+                 double clientReceive)
+  {
+    auto hold = (serverSend - serverReceive) / CLOCK_TICKS_PER_SECOND;
+    auto delay = std::max(clientReceive - clientSend - hold, 0.);
+    auto offset = (serverReceive + serverSend -
+                   (clientSend + clientReceive) * CLOCK_TICKS_PER_SECOND) /
+                  2;
+    Samples.Push({ delay, offset });
+
+    auto best = Samples[0];
+    for (auto i = size_t(1); i < Samples.Size(); i++)
+      if (Samples[i].Delay < best.Delay)
+        best = Samples[i];
+    RoundTrip = best.Delay;
+    if (Count++ < CLOCK_SAMPLES)
+      Offset = best.Offset;
+    else
+      Offset +=
+        std::clamp(best.Offset - Offset, -CLOCK_MAX_SLEW, CLOCK_MAX_SLEW);
+  }
+
+  bool IsSynchronized() const { return Count != 0; }
+
+  // Fractional server tick at a client time
+  double ServerTick(double clientTime) const
+  {
+    return clientTime * CLOCK_TICKS_PER_SECOND + Offset;
+  }
+
+  // Of the trusted pong, in seconds
+  double GetRoundTrip() const { return RoundTrip; }
+
+private:
+  struct Sample
+  {
+    double Delay = 0;
+    double Offset = 0;
+  };
+
+  RingBuffer<Sample, CLOCK_SAMPLES, RingOverflow::DropOldest> Samples;
+  double Offset = 0;
+  double RoundTrip = 0;
+  uint32_t Count = 0;
+};
+
+// How far behind the estimated server tick remote entities are drawn. The
+// snapshot being drawn must not run out before the next one arrives, so each
+// arrival is as late as the previous snapshot could get: its own lateness on
+// the server tick clock plus the ticks since the previous one. The delay
+// covers most of the recent arrivals, a clean link is drawn a tick or so
+// behind and a jittery or lossy one further back
+class RenderDelay
+{
+public:
+  // The first arrival sets the delay, later ones only move the target
+  void AddArrival(uint32_t tickIndex, double arrivalTick)
+  {
+    auto interval = LastTickIndex != 0 ? tickIndex - LastTickIndex : 1u;
+    LastTickIndex = tickIndex;
+    Lateness.Push(arrivalTick - tickIndex +
+                  std::min<uint32_t>(interval, INTERPOLATION_BUFFER_CAPACITY));
+
+    double sorted[JITTER_SAMPLES];
+    auto count = Lateness.Size();
+    for (auto i = size_t(); i < count; i++)
+      sorted[i] = Lateness[i];
+    auto nth = sorted + (count - 1) * JITTER_PERCENTILE / 100;
+    std::nth_element(sorted, nth, sorted + count);
+    Target = std::clamp(*nth + RENDER_DELAY_MARGIN, 0., RENDER_DELAY_MAX);
+    if (Count++ == 0)
+      Delay = Target;
+  }
+
+  // Moves towards the target by at most RENDER_DELAY_RATE of the elapsed
+  // ticks and returns the delay to draw with
+  double Advance(double elapsedTicks)
+  {
+    auto step = elapsedTicks * RENDER_DELAY_RATE;
+    Delay += std::clamp(Target - Delay, -step, step);
+    return Delay;
+  }
+
+  double GetDelay() const { return Delay; }
+  double GetTarget() const { return Target; }
+
+private:
+  RingBuffer<double, JITTER_SAMPLES, RingOverflow::DropOldest> Lateness;
+  uint32_t LastTickIndex = 0;
+  uint32_t Count = 0;
+  double Target = 0;
+  double Delay = 0;
+};
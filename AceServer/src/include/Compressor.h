@@ -0,0 +1,288 @@
+#pragma once
+
+#ifdef SRV
+#include "enet/enet.h"
+#else
+#include <enet6/enet.h>
+#endif
+
+#include "CompressorModel.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+constexpr auto COMPRESSOR_PROBABILITY_BITS = 12;
+constexpr auto COMPRESSOR_ADAPT_SHIFT = 4;
+constexpr auto COMPRESSOR_CONTEXT_SHIFT = 3;
+constexpr auto COMPRESSOR_CONTEXTS = 256 >> COMPRESSOR_CONTEXT_SHIFT;
+constexpr auto COMPRESSOR_MODEL_SIZE = COMPRESSOR_CONTEXTS * 256;
+
+static_assert(std::size(COMPRESSOR_MODEL) == COMPRESSOR_MODEL_SIZE);
+
+// Datagram compressor installed with enet_host_compress by the server and
+// its clients. Datagrams are lost independently so each one is coded on its
+// own: its length, then its bits through an adaptive binary range coder. A
+// bit is predicted from the top bits of the previous byte and the bits of the
+// current byte seen so far, starting from probabilities trained on captured
+// traffic so that a few hundred bytes are enough to do better than zlib
+class DatagramCompressor
+{
+public:
+  // initial holds COMPRESSOR_MODEL_SIZE probabilities
+  explicit DatagramCompressor(const uint16_t* initial = COMPRESSOR_MODEL)
+  {
+    std::memcpy(Initial, initial, sizeof(Initial));
+  }
+
+  // 0 when the output doesn't fit, ENet then sends the datagram as is
+  size_t Compress(const ENetBuffer* buffers,
+                  size_t bufferCount,
+                  size_t inLimit,
+                  uint8_t* out,
+                  size_t outLimit)
+  {
+    if (Capture != nullptr)
+      Record(buffers, bufferCount, inLimit);
+
+    auto encoder = Encoder{ out, out + outLimit };
+    for (auto length = inLimit; true; length >>= 7) {
+      encoder.WriteByte(static_cast<uint8_t>(length & 0x7F) |
+                        (length >= 0x80 ? 0x80 : 0));
+      if (length < 0x80)
+        break;
+    }
+
+    std::memcpy(Probabilities, Initial, sizeof(Probabilities));
+    auto payload = encoder.Out;
+    auto previous = uint8_t();
+    for (auto i = size_t(); i < bufferCount; i++) {
+      auto data = static_cast<const uint8_t*>(buffers[i].data);
+      for (auto j = size_t(); j < buffers[i].dataLength; j++) {
+        auto probabilities = Context(previous);
+        auto node = 1u;
+        for (auto bit = 7; bit >= 0; bit--) {
+          auto value = (data[j] >> bit) & 1u;
+          encoder.EncodeBit(probabilities[node], value);
+          node = node * 2 + value;
+        }
+        previous = data[j];
+      }
+    }
+    encoder.Flush();
+    if (encoder.Overflowed)
+      return 0;
+    // The decoder reads zeros past the end
+    while (encoder.Out > payload && encoder.Out[-1] == 0)
+      encoder.Out--;
+    return static_cast<size_t>(encoder.Out - out);
+  }
+
+  // 0 on malformed input or when the datagram doesn't fit
+  size_t Decompress(const uint8_t* in,
+                    size_t inLimit,
+                    uint8_t* out,
+                    size_t outLimit)
+  {
+    auto end = in + inLimit;
+    auto length = size_t();
+    for (auto shift = 0; true; shift += 7) {
+      if (in == end || shift > 28)
+        return 0;
+      auto byte = *in++;
+      length |= static_cast<size_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        break;
+    }
+    if (length > outLimit)
+      return 0;
+
+    std::memcpy(Probabilities, Initial, sizeof(Probabilities));
+    auto decoder = Decoder(in, end);
+    auto previous = uint8_t();
+    for (auto j = size_t(); j < length; j++) {
+      auto probabilities = Context(previous);
+      auto node = 1u;
+      while (node < 256)
+        node = node * 2 + decoder.DecodeBit(probabilities[node]);
+      out[j] = previous = static_cast<uint8_t>(node);
+    }
+
+    if (Capture != nullptr) {
+      auto buffer = ENetBuffer();
+      buffer.data = out;
+      buffer.dataLength = length;
+      Record(&buffer, 1, length);
+    }
+    return length;
+  }
+
+  // Raw datagrams are appended with a 32 bit little endian length, this is
+  // what AceCompressBench reads and trains on
+  std::FILE* Capture = nullptr;
+
+  static ENetCompressor Make(std::FILE* capture = nullptr)
+  {
+    auto context = new DatagramCompressor();
+    context->Capture = capture;
+    auto compressor = ENetCompressor();
+    compressor.context = context;
+    compressor.compress = &CompressCallback;
+    compressor.decompress = &DecompressCallback;
+    compressor.destroy = &DestroyCallback;
+    return compressor;
+  }
+
+private:
+  static constexpr auto TopValue = 1u << 24;
+  static constexpr auto ProbabilityOne = 1u << COMPRESSOR_PROBABILITY_BITS;
+
+  // Moves the probability of a 0 bit towards the bit that was coded, mask is
+  // all ones for a 1 bit
+  static uint16_t Adapt(uint32_t probability, uint32_t mask)
+  {
+    auto towardsZero = (ProbabilityOne - probability) >> COMPRESSOR_ADAPT_SHIFT;
+    auto towardsOne = probability >> COMPRESSOR_ADAPT_SHIFT;
+    return static_cast<uint16_t>(probability + (towardsZero & ~mask) -
+                                 (towardsOne & mask));
+  }
+
+  // LZMA style, the carry is propagated through the cached bytes. The first
+  // byte out is always 0 and is not written
+  struct Encoder
+  {
+    uint8_t* Out;
+    uint8_t* End;
+    uint64_t Low = 0;
+    uint32_t Range = 0xFFFFFFFF;
+    uint8_t Cache = 0;
+    uint64_t CacheSize = 1;
+    bool First = true;
+    bool Overflowed = false;
+
+    void WriteByte(uint8_t value)
+    {
+      if (Out == End)
+        Overflowed = true;
+      else
+        *Out++ = value;
+    }
+
+    void ShiftLow()
+    {
+      if (static_cast<uint32_t>(Low) < 0xFF000000u || (Low >> 32) != 0) {
+        auto carry = static_cast<uint8_t>(Low >> 32);
+        auto value = Cache;
+        do {
+          if (!First)
+            WriteByte(value + carry);
+          First = false;
+          value = 0xFF;
+        } while (--CacheSize != 0);
+        Cache = static_cast<uint8_t>(Low >> 24);
+      }
+      CacheSize++;
+      Low = (Low & 0x00FFFFFF) << 8;
+    }
+
+    // Branchless, the bits are as unpredictable as the coder can make them
+    void EncodeBit(uint16_t& probability, uint32_t bit)
+    {
+      auto bound = (Range >> COMPRESSOR_PROBABILITY_BITS) * probability;
+      auto mask = 0u - bit;
+      Low += bound & mask;
+      Range = ((Range - bound) & mask) | (bound & ~mask);
+      probability = Adapt(probability, mask);
+      while (Range < TopValue) {
+        Range <<= 8;
+        ShiftLow();
+      }
+    }
+
+    void Flush()
+    {
+      for (auto i = 0; i < 5; i++)
+        ShiftLow();
+    }
+  };
+
+  // Reading past the end yields zeros, a truncated datagram decodes to
+  // garbage that the protocol layer rejects
+  struct Decoder
+  {
+    const uint8_t* In;
+    const uint8_t* End;
+    uint32_t Range = 0xFFFFFFFF;
+    uint32_t Code = 0;
+
+    Decoder(const uint8_t* in, const uint8_t* end)
+      : In(in)
+      , End(end)
+    {
+      for (auto i = 0; i < 4; i++)
+        Code = (Code << 8) | ReadByte();
+    }
+
+    uint8_t ReadByte() { return In < End ? *In++ : 0; }
+
+    uint32_t DecodeBit(uint16_t& probability)
+    {
+      auto bound = (Range >> COMPRESSOR_PROBABILITY_BITS) * probability;
+      auto bit = static_cast<uint32_t>(Code >= bound);
+      auto mask = 0u - bit;
+      Code -= bound & mask;
+      Range = ((Range - bound) & mask) | (bound & ~mask);
+      probability = Adapt(probability, mask);
+      while (Range < TopValue) {
+        Range <<= 8;
+        Code = (Code << 8) | ReadByte();
+      }
+      return bit;
+    }
+  };
+
+  uint16_t* Context(uint8_t previous)
+  {
+    return Probabilities + (previous >> COMPRESSOR_CONTEXT_SHIFT) * 256;
+  }
+
+  void Record(const ENetBuffer* buffers, size_t bufferCount, size_t length)
+  {
+    uint8_t header[4] = { static_cast<uint8_t>(length),
+                          static_cast<uint8_t>(length >> 8),
+                          static_cast<uint8_t>(length >> 16),
+                          static_cast<uint8_t>(length >> 24) };
+    std::fwrite(header, 1, sizeof(header), Capture);
+    for (auto i = size_t(); i < bufferCount; i++)
+      std::fwrite(buffers[i].data, 1, buffers[i].dataLength, Capture);
+  }
+
+  static size_t ENET_CALLBACK CompressCallback(void* context,
+                                               const ENetBuffer* inBuffers,
+                                               size_t inBufferCount,
+                                               size_t inLimit,
+                                               enet_uint8* outData,
+                                               size_t outLimit)
+  {
+    return static_cast<DatagramCompressor*>(context)->Compress(
+      inBuffers, inBufferCount, inLimit, outData, outLimit);
+  }
+
+  static size_t ENET_CALLBACK DecompressCallback(void* context,
+                                                 const enet_uint8* inData,
+                                                 size_t inLimit,
+                                                 enet_uint8* outData,
+                                                 size_t outLimit)
+  {
+    return static_cast<DatagramCompressor*>(context)->Decompress(
+      inData, inLimit, outData, outLimit);
+  }
+
+  static void ENET_CALLBACK DestroyCallback(void* context)
+  {
+    delete static_cast<DatagramCompressor*>(context);
+  }
+
+  uint16_t Initial[COMPRESSOR_MODEL_SIZE];
+  uint16_t Probabilities[COMPRESSOR_MODEL_SIZE];
+};
@@ -0,0 +1,694 @@
+#pragma once
+
+#include <cstdint>
+
+// Generated by AceCompressBench --train from cap.bin, 10s of AceServer
+// --capture cap.bin under AceLoadGen --clients 64 --fire-interval 12
+// --launch-interval 4
+// Initial probability of a 0 bit, on COMPRESSOR_PROBABILITY_BITS, at each
+// bit tree node of each previous byte context
+inline constexpr uint16_t COMPRESSOR_MODEL[32 * 256] = {
+  2048, 3512, 3701, 2618, 3620, 2422, 3148, 2019, 3464, 2544, 2878, 1677,
+  3228, 2183, 1892, 2220, 3283, 2236, 2843, 1975, 2568, 1792, 2132, 2696,
+  3512, 2626, 2084, 2348, 2046, 1636, 1589, 1974, 3712, 3193, 2456, 2250,
+  3251, 1795, 1971, 2446, 3472, 3095, 2112, 2704, 1883, 2357, 2019, 2004,
+  946, 2566, 1308, 2082, 1889, 2258, 2150, 2072, 2028, 2475, 1940, 3054,
+  1973, 1604, 2118, 1777, 3799, 2740, 3618, 2411, 2840, 1835, 2245, 2171,
+  3153, 2263, 2194, 2436, 2221, 2389, 1479, 1838, 2284, 2422, 2479, 2594,
+  1556, 2799, 3052, 2303, 2098, 2313, 2198, 2085, 3118, 1216, 2216, 1918,
+  3294, 502, 2236, 2339, 2477, 1168, 2397, 2278, 2282, 2037, 2573, 2207,
+  2121, 2335, 2168, 2119, 2257, 2199, 2445, 2141, 2200, 2492, 3218, 2362,
+  2040, 2425, 2508, 3232, 1753, 2366, 2300, 2078, 3753, 3273, 3263, 1660,
+  2083, 2100, 2407, 1975, 3162, 2212, 2149, 2554, 2696, 2079, 2143, 2190,
+  2748, 2402, 2283, 2034, 2607, 2267, 2823, 2009, 2280, 2184, 2060, 2226,
+  2356, 1224, 2336, 1793, 3852, 2010, 2957, 2203, 1519, 952, 2861, 2434,
+  1801, 2265, 2309, 2515, 3224, 2305, 2155, 2013, 1899, 2326, 2652, 1898,
+  2999, 1866, 1883, 2099, 706, 1986, 2558, 3551, 2570, 2154, 1631, 1771,
+  3646, 2087, 3445, 3996, 3176, 1760, 1932, 2191, 1897, 2686, 2355, 3606,
+  2422, 2363, 2005, 1641, 1643, 2404, 2673, 2552, 2876, 2515, 2037, 1657,
+  2072, 2601, 2545, 2139, 1968, 2165, 2258, 1948, 1970, 2397, 2424, 2149,
+  2991, 2186, 1893, 1892, 2188, 2507, 2367, 2351, 3385, 2364, 2018, 1983,
+  1773, 2295, 2451, 1500, 3109, 2224, 3493, 1724, 2255, 2246, 2883, 1834,
+  2446, 2520, 2170, 2732, 2048, 2854, 3268, 2186, 3351, 2126, 2086, 1802,
+  3361, 2141, 2191, 1607, 2381, 1431, 1869, 2397, 3763, 2813, 2484, 2643,
+  2786, 2494, 2102, 2656, 2841, 2683, 2202, 3046, 2244, 2559, 2795, 2060,
+  1111, 2656, 3560, 2091, 2948, 1937, 3169, 1993, 3017, 2243, 2875, 2430,
+  2603, 2470, 3067, 1699, 1468, 1822, 2745, 2314, 2051, 2272, 3336, 2296,
+  1796, 2304, 2819, 2240, 3326, 2409, 2389, 1833, 3653, 150, 2929, 2249,
+  3568, 2126, 2339, 2292, 3206, 2204, 2259, 2133, 3431, 2111, 2316, 2374,
+  3506, 2015, 2456, 2051, 2797, 1808, 2782, 2243, 1754, 1954, 2091, 2166,
+  3362, 2509, 2428, 1885, 2881, 493, 2150, 1701, 2986, 2489, 2526, 2222,
+  2275, 1739, 2311, 2308, 3399, 2355, 2749, 2126, 2091, 1499, 2446, 2400,
+  2903, 2071, 2511, 2052, 748, 2097, 2487, 2480, 1690, 2567, 2400, 1783,
+  3533, 2899, 3078, 3973, 3279, 1916, 1831, 2497, 3921, 2197, 1957, 2377,
+  2281, 1967, 1817, 2119, 3623, 2060, 1629, 2036, 1847, 2133, 2204, 1716,
+  3767, 2773, 2058, 1616, 2069, 1551, 1544, 2062, 3410, 1537, 1750, 1628,
+  2615, 1657, 1875, 1758, 3509, 1854, 1974, 1632, 2923, 2022, 2183, 2157,
+  2344, 1599, 2229, 2023, 1916, 2325, 1931, 1960, 376, 2290, 1689, 2375,
+  2516, 2072, 2135, 916, 3214, 1868, 2121, 3822, 2373, 1839, 1560, 2337,
+  3380, 2464, 1577, 1913, 2587, 2131, 2019, 2301, 2345, 1515, 2104, 2465,
+  2315, 1682, 1832, 1956, 3831, 2184, 1326, 1820, 2515, 2002, 1792, 1950,
+  2246, 1371, 1703, 1485, 2381, 1806, 1659, 1850, 3611, 2492, 1974, 2547,
+  2348, 2197, 2018, 2015, 1694, 3780, 1969, 2353, 2463, 1563, 1858, 1901,
+  2351, 3097, 1416, 2153, 2300, 2293, 2089, 2867, 2048, 2560, 2678, 2163,
+  2641, 1561, 2223, 1731, 3243, 3020, 2346, 3048, 2678, 2554, 2080, 2276,
+  3555, 2439, 3480, 2349, 2782, 2070, 3476, 1884, 3010, 2197, 3011, 2454,
+  2517, 2495, 2867, 2218, 3145, 2306, 2547, 2081, 2071, 1993, 2201, 2094,
+  2756, 1941, 2077, 2265, 3721, 2567, 2422, 1947, 1430, 1668, 2265, 1979,
+  3171, 2133, 2262, 1978, 1793, 1984, 2052, 1917, 3160, 2168, 2307, 1681,
+  3502, 2971, 2323, 1748, 2846, 2017, 2043, 2423, 3481, 616, 1838, 2159,
+  2293, 2332, 2243, 2245, 3305, 1702, 1836, 1742, 2472, 2226, 1985, 2386,
+  3898, 1947, 1361, 2009, 2207, 2115, 2149, 1469, 3331, 740, 2122, 1965,
+  2744, 1927, 2329, 2177, 3571, 1381, 2120, 2067, 2514, 2203, 2120, 2005,
+  2650, 1927, 2068, 2167, 2386, 2132, 2062, 2096, 1086, 1728, 2410, 1993,
+  2553, 1777, 2481, 1981, 3129, 2438, 3249, 1561, 2416, 2160, 1988, 1284,
+  3273, 1863, 1667, 2344, 1832, 1894, 1659, 2137, 3736, 2531, 1780, 250,
+  1957, 1547, 2128, 1938, 2643, 2361, 1891, 1698, 2449, 1743, 2000, 1905,
+  3561, 2831, 1395, 1684, 2030, 1631, 1750, 2308, 2596, 2104, 2763, 2396,
+  1965, 2541, 2500, 1876, 3988, 1986, 1932, 1300, 1975, 2237, 2244, 1721,
+  2679, 2372, 2086, 2205, 1498, 1800, 1736, 1094, 3474, 1930, 2186, 3831,
+  1904, 1915, 2026, 2122, 2825, 2128, 1751, 2284, 2617, 1924, 2593, 2252,
+  3805, 2309, 2205, 2245, 1999, 2463, 2030, 2004, 2951, 2201, 1995, 1480,
+  1829, 1949, 1862, 1623, 3089, 1985, 1810, 1461, 1863, 1968, 1719, 2042,
+  2755, 2332, 1901, 2298, 2066, 1877, 1693, 1938, 2815, 3748, 1863, 2138,
+  2406, 1778, 1834, 1819, 3056, 1452, 2098, 1492, 1899, 1938, 1908, 2388,
+  2048, 2368, 2874, 2047, 3081, 2100, 2443, 2375, 3197, 2175, 2246, 2057,
+  2867, 2030, 2707, 1897, 3316, 2183, 2429, 2052, 2416, 2235, 2203, 2022,
+  3038, 2295, 2313, 2421, 2967, 2217, 2303, 2078, 3743, 2382, 2870, 2037,
+  2916, 2054, 2257, 1944, 2816, 1858, 2591, 2278, 2229, 2732, 2397, 2018,
+  1250, 2029, 2409, 2163, 2275, 2187, 2592, 2041, 998, 2226, 2501, 2164,
+  2369, 2060, 2545, 1829, 3231, 1946, 2096, 1947, 2181, 1725, 1981, 2227,
+  2796, 1910, 2070, 2468, 1594, 2336, 1580, 2268, 3094, 1937, 1565, 1794,
+  1144, 2215, 1770, 1866, 2279, 2503, 1300, 2108, 1179, 2189, 1757, 1441,
+  2930, 429, 1913, 2159, 1358, 2249, 1866, 1907, 2293, 1793, 1811, 2250,
+  1338, 2246, 1837, 1966, 2311, 3512, 1617, 2056, 1551, 2391, 1970, 1754,
+  2435, 2143, 1843, 2237, 1372, 1722, 1940, 1666, 2920, 1204, 1591, 1502,
+  2634, 1883, 1949, 1851, 3037, 2296, 1858, 1992, 1575, 2421, 1740, 2110,
+  2550, 2331, 1834, 2377, 1769, 2536, 2427, 1858, 2270, 2571, 1299, 1879,
+  1693, 2068, 2059, 1958, 3038, 2411, 1531, 1853, 2035, 2065, 2017, 1247,
+  1848, 2461, 2027, 2083, 2235, 2492, 1870, 1724, 1346, 2247, 2526, 2136,
+  1583, 1420, 2019, 2016, 1584, 2118, 2121, 2201, 1770, 2133, 1779, 998,
+  2845, 2255, 2160, 3849, 1457, 1969, 1542, 2184, 1924, 2902, 1643, 1923,
+  2015, 2500, 1841, 2085, 1104, 1988, 1786, 1956, 1901, 2328, 2172, 1773,
+  2114, 2048, 1879, 2041, 2051, 2255, 1813, 1729, 1229, 1921, 3777, 1794,
+  1932, 2554, 2095, 1228, 1723, 2902, 1694, 1998, 2006, 2248, 1968, 2245,
+  1035, 2282, 1845, 2027, 1979, 2150, 1786, 1774, 1825, 2815, 2078, 1737,
+  1808, 2392, 2385, 2056, 2048, 2302, 2434, 1707, 2907, 2860, 2510, 2804,
+  3027, 2552, 3326, 2192, 2872, 2170, 3348, 2059, 3533, 2506, 2846, 2180,
+  2210, 2294, 2472, 2037, 2972, 2359, 2417, 2201, 3633, 2530, 2650, 1712,
+  3567, 2034, 2339, 1984, 2816, 2285, 1637, 2060, 3493, 515, 1683, 2207,
+  2979, 2556, 2219, 1751, 1530, 1761, 1661, 2284, 2435, 1703, 2372, 2214,
+  2770, 2258, 1664, 2073, 2886, 1847, 2173, 1202, 3390, 2086, 2308, 1904,
+  1959, 1618, 2457, 2381, 2935, 2125, 2024, 2219, 2053, 2274, 2148, 2430,
+  3942, 2326, 2307, 307, 1551, 2143, 2323, 2014, 3084, 1864, 2481, 2625,
+  2269, 2179, 2011, 951, 3403, 702, 1954, 2209, 1962, 2382, 1922, 1720,
+  2529, 1996, 1746, 1539, 1620, 2061, 2190, 2188, 3736, 3470, 1930, 2041,
+  2295, 2042, 1567, 2021, 2809, 1944, 1918, 1974, 1763, 1547, 2088, 2094,
+  2898, 2558, 1751, 1620, 2092, 2024, 1765, 2089, 2098, 1622, 2155, 2397,
+  1816, 2217, 2426, 2310, 3167, 2211, 2078, 2313, 1591, 1262, 2450, 1900,
+  1648, 2159, 2217, 2702, 1262, 1690, 1919, 1945, 4008, 2083, 1730, 1592,
+  2610, 2053, 1868, 3946, 1623, 2786, 2240, 2842, 2264, 2340, 1908, 2355,
+  3194, 1806, 2209, 2106, 1579, 1781, 2735, 1679, 2885, 1942, 1352, 2894,
+  1558, 2083, 2086, 952, 3600, 2130, 1919, 3840, 1923, 1942, 2462, 2489,
+  1647, 2362, 1614, 1852, 2146, 2728, 1846, 2268, 3008, 1648, 2850, 2306,
+  1982, 2493, 2095, 1480, 2217, 2350, 2204, 2567, 1880, 1929, 1986, 2313,
+  3924, 1184, 3876, 2278, 2255, 2630, 2151, 1882, 2008, 2048, 2590, 1908,
+  2417, 1725, 2100, 2150, 3107, 1473, 2018, 1858, 2235, 2427, 1899, 2724,
+  1942, 1969, 1699, 1847, 1971, 2103, 2849, 2365, 2048, 2493, 3159, 2280,
+  3107, 2176, 2637, 1841, 2976, 2351, 2702, 1634, 3047, 2054, 2087, 1747,
+  3306, 1578, 2197, 1749, 2933, 1691, 2094, 1749, 3255, 2221, 2186, 2478,
+  2224, 2383, 2021, 1553, 3692, 2346, 2462, 2100, 2729, 2128, 2078, 2186,
+  2748, 1917, 2189, 2987, 2263, 2221, 2253, 1216, 1090, 1678, 1832, 2285,
+  1969, 2124, 1978, 1732, 1953, 2205, 1802, 2028, 2014, 1714, 1941, 1645,
+  3075, 1422, 2306, 2257, 2053, 1772, 1951, 2376, 2557, 2096, 1858, 2434,
+  2286, 2134, 1796, 3084, 3617, 2315, 2214, 2911, 2364, 1940, 2535, 2211,
+  1667, 2039, 2000, 2350, 2399, 2393, 1743, 832, 3127, 382, 2016, 1997,
+  2257, 2162, 2301, 2218, 1979, 2894, 1804, 2208, 2249, 2812, 2386, 1997,
+  1861, 1437, 2193, 2042, 2142, 2304, 2025, 2182, 2307, 2418, 2361, 2537,
+  1983, 2215, 2482, 1600, 2557, 2769, 2152, 2131, 2307, 2464, 2304, 1973,
+  1613, 1592, 1772, 2403, 1658, 2173, 1767, 2294, 3100, 1462, 1826, 2282,
+  1959, 2383, 1868, 2247, 1622, 2284, 1771, 1299, 2184, 2023, 1326, 2146,
+  3721, 2703, 681, 1057, 1301, 2074, 1688, 1887, 1214, 2077, 1647, 2142,
+  2557, 2902, 1395, 2530, 1261, 1108, 839, 2170, 1859, 2714, 1714, 2407,
+  952, 2625, 1809, 2959, 1264, 2316, 805, 621, 2951, 1807, 1846, 4000,
+  1694, 2042, 1398, 2852, 1334, 2280, 1284, 2090, 1733, 2909, 2048, 2766,
+  1565, 2700, 1408, 2214, 2091, 2051, 2039, 1773, 1489, 2660, 1348, 2565,
+  1940, 2413, 1657, 2034, 1798, 2339, 2019, 1742, 1267, 2202, 1985, 2250,
+  1195, 2302, 2124, 2654, 2054, 2629, 1677, 2506, 1553, 2330, 997, 2711,
+  1600, 2056, 1097, 2574, 1851, 2966, 2051, 2516, 2790, 2323, 2372, 2403,
+  2048, 2546, 3274, 2380, 2998, 2061, 2920, 1866, 3076, 2341, 2517, 1961,
+  3319, 2135, 2232, 1576, 3566, 2441, 3162, 2596, 2429, 2430, 2553, 1984,
+  3387, 2262, 2384, 2413, 2185, 2431, 2346, 1896, 3492, 2128, 2222, 2193,
+  2303, 2342, 1775, 2383, 2257, 2225, 1278, 2468, 1952, 2249, 2235, 1224,
+  824, 1777, 1548, 2506, 1769, 2275, 1927, 1792, 1491, 2045, 1400, 2258,
+  1694, 1941, 1782, 1414, 3357, 1337, 1978, 2039, 2005, 2313, 2313, 2339,
+  2406, 2179, 2606, 2270, 1597, 2827, 2090, 2075, 3528, 2105, 1358, 2729,
+  2255, 2615, 2480, 1657, 2206, 2919, 1652, 2012, 2247, 2817, 1901, 1199,
+  3139, 355, 1719, 2180, 2075, 2546, 2249, 1665, 1453, 2719, 2066, 2050,
+  2040, 2855, 2044, 1521, 2117, 2291, 1683, 2196, 2059, 2368, 2087, 2118,
+  1884, 2746, 1838, 2490, 2472, 2229, 2481, 1540, 2621, 3076, 2759, 3188,
+  2339, 2416, 2006, 2590, 2508, 2071, 2729, 1953, 2144, 2574, 2101, 2245,
+  2590, 2049, 2240, 2513, 2454, 2852, 2241, 2055, 1543, 2570, 2253, 2850,
+  1907, 1769, 2275, 1546, 3788, 2802, 3133, 1575, 1789, 1338, 2325, 2046,
+  1655, 2298, 2744, 1567, 2966, 2388, 2024, 2535, 2941, 1303, 2797, 2749,
+  2338, 2959, 2344, 1930, 1985, 2836, 2878, 3417, 2110, 2732, 1269, 1151,
+  3150, 2831, 2750, 4038, 2012, 1784, 2198, 3066, 1566, 2803, 2573, 1807,
+  2474, 3077, 2116, 2823, 2745, 2040, 2475, 3200, 2043, 2790, 2886, 3022,
+  1560, 2403, 2827, 2806, 2298, 3052, 1521, 2484, 2620, 2398, 2774, 1615,
+  1119, 2103, 2490, 2003, 1406, 2011, 2734, 2204, 2464, 2800, 2255, 2021,
+  2392, 2253, 2597, 3099, 1717, 1966, 1389, 2525, 1759, 2103, 2910, 2354,
+  1993, 1460, 2094, 2841, 2048, 2468, 3230, 2537, 3053, 2105, 2767, 1910,
+  3236, 2395, 2537, 1872, 3144, 2066, 2308, 1856, 3546, 1648, 1956, 1632,
+  2304, 2168, 2018, 1804, 2153, 2079, 2326, 1876, 2308, 2410, 1928, 1661,
+  3408, 2155, 2271, 2242, 2585, 2018, 2226, 1880, 2612, 1859, 2372, 2245,
+  2001, 2498, 2236, 1412, 724, 3270, 1616, 2275, 2031, 1881, 2510, 1717,
+  1473, 2665, 1716, 2230, 2386, 1665, 2249, 1531, 3037, 728, 1836, 2158,
+  2364, 1765, 1662, 2395, 2698, 1982, 1884, 1788, 2273, 1877, 1663, 2419,
+  3198, 1622, 1650, 2005, 2024, 1614, 2179, 1526, 1555, 2163, 1992, 1733,
+  1882, 2214, 2016, 1178, 2903, 299, 3486, 2156, 2036, 1566, 2311, 1498,
+  1471, 2498, 2156, 1600, 2236, 1946, 1573, 2285, 2187, 1312, 2417, 1832,
+  1999, 1884, 1731, 1946, 1789, 1906, 1416, 2110, 2011, 1628, 1944, 1587,
+  1650, 3581, 2518, 3513, 2158, 2294, 2334, 2727, 2581, 2086, 1989, 2674,
+  1476, 2497, 2168, 2041, 3171, 2028, 1946, 2579, 1912, 2502, 1937, 2319,
+  2175, 2456, 2031, 2290, 1914, 1580, 2457, 2373, 3425, 2613, 2401, 1611,
+  1899, 1628, 2484, 2341, 1937, 2740, 2654, 1502, 2438, 2736, 1793, 2568,
+  2380, 1825, 2511, 2632, 1999, 2498, 2163, 2791, 1795, 2985, 2173, 2784,
+  2447, 2389, 1405, 1858, 3395, 2219, 2384, 3980, 3690, 2442, 2162, 2923,
+  2252, 2350, 1771, 2475, 3007, 2883, 2130, 3012, 1484, 1662, 2877, 2730,
+  1588, 2351, 1880, 2139, 2724, 2515, 2254, 2230, 2521, 2002, 2009, 2367,
+  2314, 2572, 1904, 1383, 2091, 2786, 1637, 2159, 2338, 2399, 1754, 3408,
+  1982, 2530, 2157, 2260, 1135, 2135, 2982, 2524, 2077, 2520, 1197, 2097,
+  2627, 2543, 1966, 3067, 1846, 2423, 2692, 2663, 2048, 1928, 2850, 2930,
+  3205, 2224, 3555, 2245, 3236, 2219, 2656, 1941, 2767, 2071, 2702, 1798,
+  3445, 2058, 2399, 1864, 2741, 2214, 2201, 1911, 2916, 676, 2220, 2456,
+  3033, 2356, 1953, 1663, 3764, 2238, 2105, 2097, 2363, 2011, 1992, 2213,
+  2785, 2075, 1900, 2360, 2203, 2177, 2152, 1829, 3880, 3185, 2207, 311,
+  2159, 1799, 2373, 1925, 3048, 2115, 1928, 2157, 2120, 1830, 1860, 1579,
+  3652, 1915, 2138, 2073, 2298, 2134, 1955, 2383, 1824, 1898, 2143, 2181,
+  2068, 2448, 1711, 2154, 3453, 1334, 1901, 2065, 2396, 1986, 2152, 2072,
+  1643, 2142, 1993, 2177, 2076, 2054, 2405, 1453, 3966, 2147, 3662, 1632,
+  2045, 1840, 2175, 3931, 1716, 2146, 1999, 2287, 2260, 2626, 2533, 1634,
+  3592, 1716, 2472, 1771, 1996, 2015, 2034, 2142, 1732, 1936, 2081, 2497,
+  1938, 1782, 2406, 1521, 2853, 2893, 2514, 2179, 2363, 2770, 1891, 2149,
+  1910, 2068, 1942, 2363, 1729, 2532, 1884, 2226, 2105, 2000, 1844, 2554,
+  2249, 1983, 1846, 2075, 1608, 2670, 2159, 2074, 2086, 1740, 2357, 2270,
+  3787, 1999, 1990, 1440, 1637, 1490, 1726, 2011, 1885, 1929, 2254, 2268,
+  2830, 2383, 2676, 2332, 2904, 1513, 1828, 2258, 2030, 2095, 2110, 1865,
+  1854, 1875, 2278, 2808, 2101, 2694, 2266, 1200, 4045, 1809, 1984, 2518,
+  3813, 2079, 1939, 2131, 2036, 1786, 1996, 2521, 2479, 2942, 4018, 2484,
+  2283, 1528, 2420, 2569, 1732, 2296, 2594, 1973, 1871, 1707, 2866, 3001,
+  1559, 1626, 2776, 2596, 3816, 2101, 2069, 1524, 1855, 2082, 1559, 1750,
+  1885, 2112, 2038, 2992, 2183, 2713, 1978, 2264, 2211, 1516, 2289, 2426,
+  1829, 1801, 986, 2245, 2156, 1970, 2291, 2464, 2266, 1944, 2186, 2810,
+  2048, 2369, 2957, 2439, 3138, 2195, 3071, 1882, 3153, 2116, 2476, 2125,
+  3412, 2179, 2264, 1933, 3411, 1925, 2685, 1792, 2525, 2191, 2430, 2076,
+  3376, 2031, 2093, 2164, 2091, 2256, 2087, 1550, 3674, 2018, 2427, 1875,
+  2569, 2011, 1892, 2419, 2114, 1894, 2230, 2108, 2406, 1933, 2245, 1627,
+  3842, 1678, 2230, 2082, 2156, 1750, 2526, 2214, 1569, 1714, 2300, 1984,
+  2488, 1610, 2122, 1380, 3717, 1943, 2407, 2226, 2032, 1788, 1973, 2150,
+  2179, 2453, 2133, 1888, 1811, 2882, 1292, 2529, 3073, 1570, 2164, 1973,
+  1831, 2070, 2177, 1817, 1138, 2289, 2075, 1687, 2360, 2180, 2423, 1361,
+  3972, 2114, 2117, 1791, 2091, 2054, 2037, 1872, 1592, 2552, 2237, 2056,
+  2405, 2678, 2592, 1464, 1971, 1407, 2211, 1896, 2016, 2490, 2127, 2166,
+  1672, 2256, 2232, 2964, 2508, 2257, 2659, 1334, 3062, 3019, 2530, 2754,
+  2026, 2642, 2299, 1831, 1753, 1969, 2185, 2167, 1718, 2302, 2113, 1880,
+  2742, 2120, 1635, 2560, 2705, 2421, 2797, 2127, 1458, 2389, 1757, 2007,
+  1483, 1042, 2042, 1472, 3611, 1759, 2409, 1253, 1959, 1589, 2038, 1430,
+  1777, 1629, 2352, 1818, 2527, 2633, 2789, 1584, 2059, 1353, 2336, 2633,
+  1385, 2847, 2399, 1691, 2287, 2507, 2278, 2715, 2372, 2608, 2171, 903,
+  4060, 1057, 2507, 2587, 1670, 1987, 1862, 2325, 2021, 2011, 2081, 2766,
+  2053, 2400, 2706, 2451, 1825, 2055, 2265, 1732, 2400, 2281, 2293, 1878,
+  2319, 2226, 1772, 1692, 2171, 2180, 2295, 1899, 2092, 2054, 2358, 1591,
+  1708, 2168, 1660, 1301, 1418, 1852, 2612, 2350, 2066, 2809, 2712, 1988,
+  1795, 2073, 2622, 1781, 1546, 1604, 1090, 1934, 1862, 2481, 2230, 1955,
+  1918, 1737, 2520, 2853, 2048, 2609, 2966, 1910, 3165, 2048, 2298, 1884,
+  3138, 2051, 2311, 2018, 2578, 2248, 2249, 1670, 3411, 1925, 2588, 1756,
+  2242, 1910, 2230, 1881, 1982, 2211, 2144, 2445, 2380, 2484, 2424, 1404,
+  3605, 1721, 2413, 1866, 2363, 1944, 1980, 2670, 1672, 1910, 2323, 2058,
+  2605, 2148, 2028, 1493, 2918, 1761, 2279, 2047, 2330, 2015, 2287, 2057,
+  1890, 1843, 2221, 2256, 2754, 2202, 2371, 1601, 3342, 1949, 2419, 2347,
+  1713, 2079, 2201, 2545, 1431, 1985, 1948, 2206, 1603, 2580, 1183, 2763,
+  1983, 1387, 2112, 1861, 1903, 2300, 1749, 2301, 1493, 1869, 2070, 2398,
+  1684, 2166, 1975, 1100, 2509, 2414, 1919, 1682, 1688, 1951, 1833, 2109,
+  1734, 2702, 2887, 2660, 1582, 2806, 1940, 1645, 1402, 1154, 2182, 1803,
+  1233, 2591, 2384, 2172, 1471, 2538, 2714, 2135, 1754, 2448, 2467, 1610,
+  2000, 2666, 3080, 3053, 1934, 2429, 1833, 1986, 1545, 1552, 2183, 1869,
+  1851, 2359, 1847, 2178, 1836, 2201, 2050, 2019, 2273, 1867, 2436, 2118,
+  1754, 2222, 2165, 1513, 2561, 1115, 2245, 1789, 3186, 2271, 1973, 889,
+  2110, 1214, 1737, 1008, 1626, 1927, 2317, 2023, 1959, 2268, 2669, 2351,
+  1858, 1564, 2845, 1916, 2427, 2718, 2704, 2402, 1947, 2017, 2747, 3066,
+  2374, 3099, 2426, 383, 3643, 1482, 2389, 2360, 1609, 2132, 2249, 2576,
+  1686, 2385, 2095, 2280, 2469, 3004, 2649, 2016, 1833, 2039, 2190, 1471,
+  2075, 1615, 2160, 2244, 1710, 1208, 2031, 3112, 2404, 2084, 2242, 1708,
+  2050, 1717, 2183, 933, 1715, 1289, 1294, 1139, 1026, 2181, 1878, 1902,
+  1516, 2029, 2192, 1649, 1692, 1566, 2754, 1709, 1511, 2158, 2076, 2225,
+  1665, 2032, 2235, 2099, 1649, 1920, 2305, 2518, 2048, 2638, 3024, 1875,
+  3228, 2111, 2394, 1896, 3157, 2341, 2637, 2189, 2578, 2133, 2526, 1536,
+  3366, 1971, 2775, 2124, 2255, 2200, 2316, 2051, 1866, 2225, 2035, 2349,
+  2186, 2439, 2310, 1343, 3622, 1715, 2440, 2017, 2803, 2403, 2054, 2049,
+  1666, 1782, 2730, 2254, 2659, 3096, 2141, 1913, 2884, 1501, 2316, 3060,
+  2902, 2841, 2649, 2042, 1703, 2002, 2626, 2612, 2380, 2152, 2385, 1627,
+  2908, 2135, 2043, 2387, 1776, 2133, 1926, 2531, 1668, 2191, 1874, 2230,
+  1295, 2900, 1897, 2679, 2265, 1126, 1125, 2021, 1547, 2159, 1508, 1898,
+  782, 2498, 1066, 2515, 1355, 2107, 1338, 953, 2574, 2118, 1433, 1887,
+  1731, 2102, 1491, 2114, 1073, 2347, 1723, 1876, 1169, 2788, 1517, 1842,
+  1213, 966, 1682, 2045, 1658, 2695, 802, 2271, 1163, 2510, 1771, 2686,
+  1871, 2460, 1866, 1455, 2653, 3471, 3116, 2979, 2090, 2414, 2000, 1432,
+  1902, 2230, 2108, 2174, 1908, 2794, 1743, 2293, 2547, 2188, 2178, 2166,
+  2291, 2803, 2006, 2513, 2525, 3210, 2119, 2411, 2221, 3573, 1941, 1441,
+  3394, 2842, 2332, 531, 1770, 2920, 2061, 1108, 1572, 2637, 2377, 2068,
+  2112, 3459, 3328, 2769, 2660, 2219, 3055, 2768, 2004, 3567, 2306, 1285,
+  1939, 2531, 3103, 3385, 2477, 3038, 3251, 1318, 3380, 2396, 2973, 2057,
+  1726, 2812, 1514, 2122, 1176, 3007, 2677, 2927, 2460, 2887, 2239, 2351,
+  2146, 1881, 2614, 2259, 1886, 3199, 2541, 2205, 2554, 2606, 2800, 2639,
+  2812, 3137, 1734, 1862, 1903, 2175, 2060, 867, 1235, 3260, 1950, 883,
+  1570, 3013, 2721, 2757, 2081, 3030, 2259, 915, 1367, 2641, 2952, 2206,
+  1298, 2881, 2417, 1681, 2106, 2840, 2566, 1607, 1986, 2562, 2369, 2828,
+  2048, 2651, 3025, 1953, 3198, 2215, 2151, 2043, 3423, 2631, 2913, 2800,
+  2925, 2733, 3003, 2217, 3227, 2138, 2151, 2047, 2043, 1637, 1779, 2242,
+  1541, 2497, 1648, 2117, 1924, 2178, 1720, 1405, 3623, 2299, 2110, 2097,
+  2305, 3070, 2207, 1520, 1457, 2948, 2105, 2464, 1853, 3318, 1843, 2001,
+  1780, 2678, 1816, 2272, 1691, 3145, 2456, 2004, 1427, 2739, 2124, 2282,
+  1474, 3260, 2262, 1593, 3429, 1723, 3247, 2616, 2222, 2071, 2035, 2263,
+  2301, 1264, 3484, 2553, 2340, 2852, 2558, 2568, 3253, 861, 3275, 1955,
+  2323, 2265, 2630, 2352, 1781, 1144, 3338, 2667, 2125, 2201, 2326, 2222,
+  3141, 1163, 3399, 2001, 2243, 2106, 2092, 1635, 1683, 1276, 3436, 2262,
+  2816, 2190, 1811, 1775, 2669, 673, 3353, 2123, 2288, 2287, 2556, 1940,
+  2053, 1006, 3406, 2618, 2620, 2177, 2004, 1491, 2724, 3703, 2873, 1584,
+  2046, 2400, 2226, 890, 1758, 2175, 2561, 2331, 1740, 2393, 2237, 1476,
+  2975, 2064, 1846, 1082, 2370, 2552, 2366, 2740, 1283, 2810, 1704, 2189,
+  2282, 2851, 1918, 931, 3181, 3117, 1920, 521, 2299, 1824, 2108, 1277,
+  1444, 2760, 2802, 1623, 1848, 2422, 2331, 2182, 2027, 1445, 2306, 739,
+  2360, 2883, 2386, 1752, 1918, 2380, 2098, 3151, 1283, 1895, 2443, 2229,
+  3223, 1748, 2980, 745, 2313, 2352, 1381, 1871, 1455, 2608, 2314, 2738,
+  2170, 3032, 2590, 1898, 1695, 1617, 1887, 722, 2247, 2310, 2674, 1981,
+  1876, 1969, 2716, 1848, 1444, 2359, 2465, 1714, 2396, 2351, 1940, 377,
+  2217, 2383, 1511, 776, 1320, 2078, 1912, 1910, 1946, 3335, 3172, 1867,
+  1986, 2249, 2675, 831, 2422, 2452, 2565, 2145, 1507, 2361, 2644, 2113,
+  1890, 1949, 2509, 2525, 2048, 2652, 3154, 1886, 3167, 2195, 2408, 1771,
+  3170, 1951, 2584, 2227, 2087, 2268, 2372, 1575, 3304, 1841, 2427, 2010,
+  2458, 2367, 2199, 2374, 1684, 2162, 1960, 2464, 2393, 2355, 2166, 1520,
+  3413, 1625, 2106, 1893, 2279, 1875, 2259, 935, 1186, 2118, 2058, 1644,
+  2481, 2821, 2292, 1744, 2527, 1496, 1864, 2848, 2055, 2109, 2520, 1585,
+  926, 2104, 1920, 2164, 2249, 2039, 2290, 1723, 3314, 2757, 2631, 3129,
+  2321, 1882, 2040, 2594, 1696, 2193, 2585, 2401, 2576, 3128, 2218, 1255,
+  2791, 1041, 1686, 2702, 1884, 2504, 2347, 2481, 1275, 2632, 2995, 2237,
+  2501, 2607, 1696, 2612, 3026, 2794, 2652, 2163, 2551, 1646, 2843, 2240,
+  1554, 2003, 1781, 1740, 3214, 3044, 2389, 2344, 2088, 1116, 2436, 2777,
+  1742, 2384, 1935, 1869, 1690, 2801, 2225, 2381, 2684, 2320, 2157, 1850,
+  2429, 3530, 3456, 2352, 1429, 1965, 3376, 1688, 1808, 2208, 1958, 2546,
+  2745, 2509, 2075, 1502, 2061, 1986, 1509, 2273, 2171, 2272, 2229, 2761,
+  2186, 3428, 2387, 962, 2457, 3202, 1719, 345, 2822, 2511, 2208, 542,
+  1556, 2502, 2923, 1299, 2385, 2395, 2771, 1697, 2528, 2236, 2735, 1315,
+  2021, 1837, 2918, 1708, 2961, 2256, 2125, 1647, 2015, 2169, 1933, 2176,
+  1568, 2600, 2699, 2341, 3482, 1515, 2399, 2249, 1068, 2318, 2154, 3321,
+  1651, 2783, 2765, 3403, 3204, 2685, 2664, 2644, 1592, 2241, 1756, 1539,
+  1462, 2511, 3021, 3537, 2804, 3077, 3140, 1986, 2202, 2590, 2365, 1567,
+  2111, 2570, 2565, 1199, 2294, 2972, 3450, 1352, 1596, 2411, 2781, 2052,
+  1794, 2972, 2534, 2618, 2315, 2234, 3548, 1599, 1368, 2091, 3102, 1589,
+  1181, 2467, 2475, 1951, 1687, 2816, 3337, 2298, 2048, 2957, 3346, 2028,
+  3439, 2088, 2378, 1674, 3445, 1792, 2217, 2055, 2540, 2160, 1893, 1624,
+  3287, 1855, 2439, 1393, 2182, 2085, 2089, 2114, 1702, 2467, 2345, 2051,
+  2046, 2337, 2185, 1441, 3431, 1275, 1884, 1787, 2170, 1554, 1857, 944,
+  2073, 2097, 1956, 1620, 2130, 1852, 1689, 1906, 2590, 1627, 2073, 1906,
+  1930, 1525, 1614, 1500, 1805, 1578, 1808, 1848, 2155, 1665, 1717, 1419,
+  2034, 3448, 2783, 3532, 2143, 2167, 1917, 2739, 1813, 2106, 3007, 3119,
+  2287, 3236, 2264, 1514, 2929, 3009, 2177, 2307, 2571, 2791, 2480, 2612,
+  1622, 2775, 2488, 2923, 2328, 2233, 2303, 2745, 2798, 2122, 1904, 2076,
+  2656, 3059, 1359, 2232, 1677, 2750, 2109, 2816, 2053, 3034, 1951, 2597,
+  1964, 2936, 2622, 2352, 2328, 2775, 2071, 3035, 2204, 2609, 1996, 3168,
+  1917, 2405, 2116, 1866, 2183, 3996, 3650, 2314, 1909, 2247, 3863, 1746,
+  1979, 1979, 2736, 2102, 2118, 2062, 2263, 1611, 2187, 1623, 2473, 2097,
+  3088, 2703, 2985, 2762, 2033, 2389, 2453, 2766, 2557, 2789, 2541, 322,
+  3619, 2770, 2690, 2464, 2317, 1882, 3266, 2025, 2144, 2625, 3228, 2615,
+  2843, 2934, 3448, 2730, 2793, 2017, 2995, 2899, 2058, 3079, 3340, 2717,
+  2818, 2474, 2615, 3140, 2713, 2985, 3756, 2883, 3485, 2305, 2962, 3135,
+  2058, 2756, 2682, 3268, 2578, 2345, 2966, 2200, 2117, 2200, 2992, 2435,
+  1705, 1492, 2982, 2394, 2241, 2243, 3590, 2233, 2565, 2059, 3442, 1956,
+  2179, 2744, 3129, 1273, 2275, 2599, 2907, 2219, 1311, 3538, 3048, 1452,
+  1903, 2709, 3040, 2363, 1785, 2859, 3218, 2736, 2528, 2353, 3022, 1558,
+  2237, 2285, 3229, 2029, 1579, 1593, 2462, 1260, 1604, 1378, 3069, 2312,
+  2048, 2788, 3144, 1872, 3070, 2077, 2194, 1842, 2556, 1791, 2397, 1872,
+  2299, 2116, 2263, 1622, 3396, 2702, 2472, 1434, 2335, 2046, 2094, 2249,
+  2059, 2260, 2079, 1826, 2054, 1923, 2184, 1517, 3573, 2060, 3243, 1903,
+  2689, 1714, 2041, 783, 2208, 2367, 2525, 1781, 2579, 2478, 1699, 2225,
+  2521, 1405, 2196, 2218, 2095, 2079, 2582, 1751, 1888, 2072, 2558, 1914,
+  2381, 1917, 1860, 1640, 3286, 2235, 2668, 2206, 3424, 1982, 2241, 2640,
+  2300, 1681, 1614, 2354, 2170, 2776, 2636, 913, 2768, 1523, 2822, 2136,
+  2390, 1670, 2184, 1605, 1459, 2948, 2398, 1837, 1561, 1747, 1963, 2464,
+  2922, 1732, 1947, 1648, 2338, 2042, 1839, 2037, 1977, 2177, 1862, 1755,
+  2536, 2517, 2127, 1377, 1733, 1687, 2393, 1989, 2551, 2622, 2010, 1800,
+  2058, 2346, 2379, 2355, 1911, 1545, 2039, 1628, 2550, 3377, 1266, 2261,
+  1695, 2603, 2794, 2068, 3804, 2487, 2792, 2802, 2535, 2598, 2143, 1995,
+  2967, 2122, 2190, 2493, 3546, 3104, 2763, 3187, 3596, 3024, 2235, 2539,
+  2510, 3138, 1837, 206, 3434, 2734, 1790, 3628, 2970, 3010, 3366, 1860,
+  1763, 3123, 3289, 2717, 2279, 3154, 2855, 3354, 2964, 2216, 3330, 2572,
+  2341, 2850, 2871, 2208, 2698, 3051, 2239, 3451, 2152, 3367, 3308, 3095,
+  3363, 2354, 1932, 2948, 2088, 2613, 2189, 3081, 2429, 3587, 2984, 2885,
+  2903, 2995, 2441, 3824, 2268, 1879, 2950, 2810, 1513, 3258, 3582, 3296,
+  2520, 2899, 2596, 1988, 2399, 3173, 2579, 1472, 2640, 2390, 3317, 2777,
+  2930, 3271, 3094, 1955, 2405, 2111, 2619, 2423, 2422, 3138, 2804, 3205,
+  2950, 2435, 3161, 2626, 2926, 2480, 2856, 2175, 2363, 2909, 2503, 2038,
+  2534, 2115, 2868, 2099, 2048, 3235, 3762, 2642, 3399, 1902, 2397, 1917,
+  3625, 1779, 2301, 2282, 2579, 3056, 2275, 1737, 3938, 2233, 3233, 701,
+  2120, 1964, 2521, 2419, 2908, 1355, 3250, 2322, 2164, 2090, 2087, 1621,
+  3989, 2434, 3039, 1151, 2479, 2555, 1670, 2916, 1625, 2539, 2139, 2204,
+  2523, 2461, 1947, 2226, 3352, 1984, 2228, 927, 2441, 2473, 2466, 2041,
+  1917, 2389, 2194, 2382, 2139, 1986, 1969, 1472, 3994, 1897, 2485, 2495,
+  3472, 2035, 1796, 3117, 3311, 3149, 2492, 2434, 2119, 2387, 3874, 1163,
+  1804, 1799, 2140, 2374, 2089, 2013, 2167, 2240, 1428, 2172, 2431, 2282,
+  1923, 1938, 2310, 2521, 3773, 1376, 2228, 1946, 2322, 1958, 2087, 3334,
+  3654, 3397, 2701, 2703, 2283, 2205, 2577, 2149, 2615, 1259, 2303, 2144,
+  1853, 2192, 2221, 1928, 1935, 2432, 1875, 2799, 2444, 2060, 2245, 1287,
+  3878, 3184, 1675, 2265, 1809, 2445, 2610, 2761, 3727, 2552, 2714, 2329,
+  2203, 2534, 852, 2591, 509, 1642, 500, 1915, 1782, 2189, 2243, 2470,
+  1656, 2898, 1596, 2096, 4001, 2819, 1883, 339, 2223, 2392, 2085, 2356,
+  2880, 2692, 2628, 2793, 2210, 2224, 2840, 2465, 2983, 2721, 2131, 2522,
+  2177, 1117, 2395, 2186, 2095, 3119, 3257, 2472, 2599, 2748, 2574, 2662,
+  2763, 2759, 3037, 2540, 3860, 2447, 2525, 2012, 1978, 2401, 2013, 3327,
+  2846, 2933, 2005, 2529, 2313, 3213, 368, 2297, 370, 2212, 325, 2631,
+  1733, 2422, 3134, 2753, 1804, 2963, 3127, 2791, 2811, 3229, 2844, 3572,
+  2511, 2623, 2014, 2279, 2627, 1927, 2985, 2531, 2743, 2641, 2319, 2890,
+  3075, 3097, 2897, 2799, 2189, 2107, 2940, 2483, 2371, 2963, 3175, 2503,
+  2604, 2993, 2824, 2846, 2593, 2338, 3116, 1789, 2048, 2938, 3304, 1931,
+  3081, 2031, 2088, 1952, 2539, 1708, 2226, 2169, 2174, 2298, 2146, 1864,
+  3534, 3097, 2380, 1504, 2235, 1882, 2276, 2231, 1685, 1993, 2002, 2238,
+  2231, 2053, 2067, 1781, 3749, 2360, 3589, 1795, 2353, 1965, 1793, 911,
+  1731, 2597, 2099, 1973, 2427, 2042, 1802, 2086, 1992, 1732, 1837, 2178,
+  2018, 1934, 2210, 1656, 1391, 2159, 2015, 2271, 2131, 2040, 2030, 1474,
+  3518, 2324, 2638, 1968, 368, 2069, 1994, 2516, 1587, 1940, 2051, 1988,
+  2154, 2607, 2222, 1167, 2053, 1886, 1879, 2175, 2199, 1593, 1700, 1892,
+  1176, 1843, 2163, 1638, 2118, 2056, 2383, 2106, 2383, 1468, 2149, 1748,
+  1959, 1790, 1516, 1690, 1440, 1914, 2449, 1999, 2507, 2324, 2503, 1929,
+  2230, 1564, 2113, 1874, 1817, 2721, 1757, 1881, 1651, 2000, 1820, 1727,
+  2320, 2194, 2339, 1437, 2444, 2830, 1360, 2245, 2129, 2219, 2616, 2055,
+  1926, 172, 2337, 1876, 2120, 2242, 2053, 1936, 1834, 1801, 1434, 2198,
+  2431, 1885, 2017, 1481, 1460, 2395, 1586, 1941, 2478, 2359, 1023, 317,
+  2304, 2071, 1519, 2603, 2486, 1990, 2655, 1340, 1525, 2186, 2130, 2106,
+  2379, 2478, 2701, 1901, 2371, 1446, 1876, 1954, 1577, 2210, 2613, 1940,
+  1942, 2200, 1727, 3283, 2938, 2461, 2146, 1872, 994, 1650, 999, 2453,
+  1640, 2094, 2117, 3001, 2325, 2691, 2228, 2905, 1918, 2622, 2072, 2281,
+  2250, 1550, 1625, 1991, 2174, 2367, 2396, 1721, 1931, 2708, 1868, 2088,
+  2006, 1741, 2300, 2297, 1791, 2023, 1899, 2549, 2167, 2189, 2604, 2014,
+  1889, 2174, 1858, 2594, 1998, 3053, 2967, 2511, 1612, 1790, 2435, 2141,
+  1963, 2268, 2523, 1554, 1807, 2345, 2007, 2164, 2132, 1392, 2686, 1720,
+  2048, 2699, 3133, 2006, 2836, 2066, 2212, 1792, 2939, 1884, 2103, 2158,
+  2422, 2425, 2191, 1796, 3309, 1794, 2629, 1529, 2231, 1600, 2351, 2437,
+  2215, 2013, 2244, 2318, 2241, 2108, 2199, 1489, 3628, 2211, 2271, 1874,
+  2319, 2153, 2048, 987, 1736, 2547, 2250, 2141, 2710, 2442, 1939, 2455,
+  2618, 1733, 1971, 2068, 1952, 2127, 2606, 1990, 1727, 2488, 2293, 2302,
+  2056, 2103, 1980, 1577, 3573, 2018, 2640, 2306, 2077, 1996, 2064, 2655,
+  1617, 1883, 2635, 2119, 2165, 2115, 2169, 964, 2851, 1542, 1876, 2043,
+  2475, 2061, 2390, 2191, 1486, 1761, 2518, 2054, 2154, 1874, 2297, 2200,
+  3317, 2001, 1927, 1882, 2074, 1573, 1922, 1933, 1470, 1706, 2322, 2205,
+  2528, 2551, 2207, 2147, 1815, 2000, 2425, 2420, 2220, 2416, 1998, 2302,
+  1646, 2222, 2219, 2184, 2814, 1744, 2892, 1391, 2183, 2601, 2419, 2238,
+  2077, 2000, 2672, 2224, 1637, 2137, 2142, 2101, 2106, 2305, 1658, 2316,
+  2040, 1642, 1318, 2295, 2467, 2212, 2425, 2077, 1817, 2513, 1955, 2146,
+  2726, 2491, 2190, 524, 2831, 2795, 2406, 2722, 2586, 1615, 2569, 2058,
+  2041, 2656, 2481, 2292, 2677, 2167, 2382, 2221, 1821, 1032, 2125, 2071,
+  2863, 2381, 2591, 2223, 1958, 2489, 2876, 3169, 2598, 2423, 2299, 2184,
+  2680, 2371, 2753, 1948, 2735, 2729, 1939, 3657, 2167, 1886, 2330, 3154,
+  2816, 2922, 3073, 2829, 1731, 1974, 2208, 2609, 2629, 2273, 2664, 2628,
+  2229, 2169, 2635, 2785, 2660, 2501, 2508, 2651, 1283, 2339, 2338, 2114,
+  2675, 2201, 2178, 2401, 2093, 2402, 2445, 2184, 2608, 3590, 3049, 2281,
+  1729, 1716, 2187, 2524, 2988, 2216, 2947, 2145, 1960, 2381, 2154, 1990,
+  2284, 2134, 2557, 1726, 2048, 2877, 3246, 1859, 3111, 1929, 2257, 1828,
+  3185, 1892, 2091, 2115, 2466, 2377, 2156, 1640, 3498, 1751, 2788, 1579,
+  2334, 2216, 2548, 2375, 2042, 2228, 2307, 1943, 2374, 2368, 2311, 1683,
+  3797, 2402, 2144, 1856, 2135, 2533, 2191, 1268, 1659, 2518, 2245, 1782,
+  2351, 2663, 1749, 2224, 2234, 1428, 2030, 2399, 2221, 2363, 2497, 1505,
+  1443, 2365, 2229, 2272, 2224, 2587, 1824, 1135, 3946, 2102, 2730, 2306,
+  2252, 1912, 2121, 2707, 1510, 2378, 1899, 2020, 2368, 2111, 2540, 898,
+  2711, 2532, 1475, 2230, 2630, 2109, 2020, 1711, 978, 2251, 2044, 1780,
+  2663, 1575, 2228, 1964, 2910, 1907, 1985, 1697, 2403, 1754, 2012, 1608,
+  1627, 2407, 1898, 1743, 1720, 2020, 2288, 1661, 2555, 2169, 1598, 2383,
+  2268, 2070, 2122, 1810, 1637, 2207, 1876, 2064, 2521, 2008, 1872, 1405,
+  3356, 2229, 1665, 2071, 2959, 2280, 2657, 2001, 1765, 2113, 2290, 1943,
+  2514, 2460, 1421, 2141, 1899, 1358, 1354, 2484, 2477, 1925, 3042, 1968,
+  1352, 2442, 2214, 2051, 2418, 2956, 2268, 600, 3051, 2182, 1869, 3384,
+  2219, 1903, 2186, 1469, 1845, 2903, 2448, 1151, 2573, 1948, 2314, 2575,
+  2262, 711, 1710, 2237, 1795, 2738, 3056, 2491, 1734, 3001, 1998, 3024,
+  2404, 2384, 1708, 3194, 3081, 2290, 2146, 2212, 2292, 1869, 2422, 3489,
+  2271, 3212, 1470, 2818, 3169, 3230, 2213, 2451, 2236, 1535, 1527, 2275,
+  2219, 2119, 2342, 1894, 1387, 2881, 2220, 1847, 3086, 1872, 2088, 2117,
+  2399, 1673, 1479, 2650, 2383, 2198, 2409, 1693, 1161, 2472, 2284, 1665,
+  2406, 2649, 1064, 2315, 2236, 1520, 1975, 2172, 2702, 2366, 2954, 1480,
+  1774, 3022, 2375, 1743, 2416, 1535, 2446, 1837, 2048, 2639, 2971, 1997,
+  2859, 1912, 2112, 1891, 2774, 2183, 2216, 2047, 2490, 2207, 2346, 1784,
+  3262, 1678, 2622, 1821, 2346, 1929, 2597, 2616, 1631, 2075, 2591, 2155,
+  2698, 2314, 2208, 1573, 3490, 2061, 2189, 1525, 2238, 2526, 2157, 1425,
+  1625, 2519, 2140, 2550, 2566, 2490, 1747, 1899, 2036, 1649, 2246, 1839,
+  2217, 2436, 2205, 2123, 1711, 2411, 2173, 2114, 2038, 2238, 2220, 1388,
+  3777, 1857, 2411, 2255, 2296, 1821, 2106, 2980, 1669, 2177, 2706, 2304,
+  2460, 1996, 2175, 1194, 2448, 1713, 2092, 2456, 2207, 1849, 2442, 2329,
+  1658, 1738, 2164, 1400, 2664, 1500, 2492, 1775, 1828, 1648, 2393, 1734,
+  2614, 1872, 2228, 2037, 1798, 1755, 2339, 1881, 2620, 1965, 1983, 2350,
+  2718, 1654, 2616, 2200, 2118, 2113, 2330, 2017, 1724, 2122, 2532, 1946,
+  2518, 2134, 2417, 1803, 2003, 1820, 2402, 2292, 2354, 1907, 3097, 1937,
+  1726, 2641, 2041, 1990, 2190, 2485, 1255, 2058, 2071, 1635, 1626, 2106,
+  2023, 1554, 1611, 1715, 1031, 2149, 2389, 1428, 2068, 2509, 2230, 974,
+  1578, 2614, 2085, 2479, 2348, 2227, 2358, 2145, 1419, 1938, 2213, 1332,
+  2050, 1868, 2581, 2093, 1500, 996, 2674, 1875, 2216, 2702, 1838, 1911,
+  1692, 2644, 1664, 3348, 2122, 2745, 2097, 2398, 1790, 1618, 2366, 2176,
+  1937, 2351, 2213, 2999, 1919, 2079, 2020, 2465, 2307, 2715, 2122, 2421,
+  1978, 1249, 1894, 2052, 2549, 2053, 2131, 1818, 1743, 1663, 2364, 1971,
+  1852, 1726, 2122, 2497, 1924, 1933, 2292, 2190, 2164, 2253, 2537, 1087,
+  1387, 2051, 2163, 1819, 2796, 2449, 2859, 2260, 2197, 1472, 2099, 2027,
+  2136, 1892, 2629, 1963, 1944, 2027, 2455, 1509, 2330, 1514, 2327, 1740,
+  2048, 2656, 3108, 1935, 2919, 1824, 2272, 1645, 2773, 2322, 2131, 2586,
+  2364, 2499, 2341, 1590, 3254, 1622, 2896, 1896, 2347, 1874, 2692, 2260,
+  1867, 2103, 2766, 1972, 2362, 2633, 2037, 1563, 3375, 2119, 2106, 1754,
+  2632, 2303, 2238, 1535, 1099, 2504, 2279, 3072, 2671, 2362, 2275, 2780,
+  2171, 1308, 2348, 1892, 2215, 2327, 2208, 2429, 1567, 2625, 2283, 2160,
+  2073, 2528, 2219, 1228, 3795, 1680, 2564, 2207, 2279, 1978, 2160, 2795,
+  1214, 2030, 2364, 2146, 3024, 2070, 2384, 1312, 2161, 2070, 2227, 2037,
+  2717, 1962, 2870, 2180, 1205, 1217, 2345, 2143, 2424, 2783, 2345, 2144,
+  2599, 1607, 2587, 1440, 2740, 1989, 1819, 1931, 1010, 2175, 1982, 1628,
+  2359, 1968, 2633, 2034, 2645, 1471, 2433, 1430, 2045, 2726, 2604, 2019,
+  1471, 1489, 2822, 2431, 3076, 1918, 1967, 1523, 2514, 2060, 2718, 2444,
+  2440, 2056, 2860, 1833, 1312, 2117, 2387, 2248, 1961, 2370, 1481, 2246,
+  1795, 985, 1822, 1769, 2477, 2176, 2131, 2146, 989, 2151, 2421, 2258,
+  1911, 2638, 2120, 863, 2162, 1722, 2005, 1862, 1907, 2165, 1858, 1974,
+  1570, 2494, 2710, 2049, 869, 2149, 1888, 2928, 1011, 740, 1611, 2157,
+  2319, 3281, 1989, 2140, 1842, 2479, 2079, 2397, 1862, 2614, 2220, 2253,
+  2952, 1490, 2223, 1697, 1138, 1820, 1910, 3324, 952, 2013, 1860, 2534,
+  2330, 2610, 2226, 2477, 1758, 1244, 1174, 1496, 2738, 2239, 1908, 1790,
+  1683, 1644, 2014, 2415, 1095, 1539, 1623, 2352, 595, 982, 1958, 2410,
+  2319, 1764, 1178, 2148, 1902, 2588, 1850, 2350, 2338, 2712, 2188, 1514,
+  2990, 1198, 1629, 1826, 1354, 1968, 2270, 2222, 1042, 1932, 3057, 1758,
+  2335, 1632, 1963, 1717, 2048, 2693, 3091, 1976, 2998, 1815, 2351, 1729,
+  2942, 2330, 2131, 2679, 2241, 2374, 2130, 1666, 3369, 1995, 3031, 2586,
+  2685, 2742, 3138, 2683, 2428, 2043, 2863, 2483, 2466, 2890, 2872, 1577,
+  3346, 2164, 2351, 1909, 2791, 2233, 2158, 2447, 1789, 1951, 2345, 2291,
+  2732, 2698, 2507, 1964, 2295, 1444, 1772, 1889, 2474, 2308, 2119, 1922,
+  1637, 2539, 2282, 2409, 2294, 2028, 1961, 1431, 3768, 2356, 2280, 1931,
+  1897, 2268, 2025, 1724, 873, 2353, 2206, 2119, 2116, 2555, 2399, 2407,
+  1329, 2394, 2038, 1929, 1101, 2462, 2556, 2661, 563, 2100, 2625, 2024,
+  1571, 3503, 1955, 1910, 2215, 1952, 2367, 1667, 1642, 3073, 2428, 959,
+  787, 2450, 2229, 1831, 1768, 2570, 2616, 2397, 1056, 2375, 2536, 2403,
+  1984, 3156, 2939, 1316, 694, 2096, 2030, 1611, 1695, 3106, 2334, 1688,
+  1915, 1136, 3294, 2009, 2777, 1642, 2417, 1412, 1339, 1674, 2603, 2163,
+  2286, 2476, 2894, 1778, 2148, 785, 2320, 2140, 2550, 2081, 2631, 2417,
+  1438, 1249, 3117, 2281, 2273, 2585, 2309, 2227, 2392, 1058, 2905, 2332,
+  2226, 2085, 2961, 1826, 2259, 822, 3237, 2215, 2921, 2451, 2819, 2747,
+  2534, 272, 3519, 2072, 2520, 2674, 2835, 2356, 1146, 907, 3047, 2126,
+  2766, 2422, 1827, 1897, 3507, 932, 3009, 2015, 2496, 2268, 1747, 3762,
+  2785, 1201, 3460, 2893, 3184, 2839, 1849, 1420, 1853, 558, 2800, 1965,
+  2468, 1587, 2012, 2531, 1360, 668, 3028, 1664, 2675, 1214, 2301, 2196,
+  1841, 1304, 3338, 2869, 3019, 1654, 2392, 1946, 2272, 1360, 3330, 1964,
+  2490, 2242, 2188, 2072, 2060, 652, 3420, 1696, 2862, 1758, 2525, 1537,
+  2496, 1037, 3264, 1988, 2841, 1297, 2361, 1634, 2048, 2773, 3308, 1955,
+  3171, 2146, 2762, 1570, 2853, 2091, 2292, 2082, 2056, 2093, 2256, 1452,
+  3275, 1733, 2556, 2198, 2276, 1901, 1843, 1748, 1335, 1313, 2106, 2399,
+  2195, 2636, 2172, 1387, 3389, 2005, 2329, 1598, 2127, 2378, 2295, 2237,
+  1664, 2341, 2671, 2149, 1879, 2504, 2292, 1883, 2377, 1543, 2412, 1367,
+  2355, 2688, 1544, 1963, 1509, 2378, 2031, 2467, 2231, 2615, 2249, 1310,
+  3550, 2415, 2560, 2024, 2429, 1664, 1962, 1406, 2149, 2217, 2506, 2241,
+  2228, 2234, 1886, 2544, 2053, 1829, 2122, 2690, 2414, 2056, 2389, 2251,
+  1930, 2283, 2765, 1078, 2487, 2367, 2021, 1116, 2155, 1666, 2198, 1411,
+  2497, 1455, 1375, 462, 1996, 2061, 2229, 2538, 2193, 2416, 2694, 1961,
+  2260, 1910, 2221, 1906, 2187, 2237, 2725, 1128, 2058, 1854, 2346, 2659,
+  2087, 1638, 2332, 1326, 2978, 2739, 2996, 1741, 2428, 2047, 2832, 1432,
+  1285, 2119, 2280, 2049, 2286, 2467, 2575, 1204, 2051, 2980, 1795, 2046,
+  2632, 2020, 2220, 2111, 761, 2499, 2379, 2053, 1956, 2594, 2093, 1536,
+  2622, 2808, 2639, 2737, 2001, 1990, 2141, 2466, 2127, 2727, 2709, 1302,
+  1754, 2725, 2723, 2270, 1662, 2995, 2987, 1316, 2208, 2753, 2965, 2172,
+  1817, 1967, 2309, 2492, 1594, 2430, 2376, 1154, 2568, 2176, 1809, 1985,
+  1761, 1622, 2235, 3765, 1454, 2613, 1643, 2457, 2327, 3384, 2125, 832,
+  2124, 2687, 2342, 1583, 2431, 2110, 2833, 1537, 1403, 1400, 3030, 2140,
+  2780, 2731, 1619, 2112, 1781, 3003, 2251, 2442, 2737, 2724, 1929, 2123,
+  1468, 2350, 2474, 2449, 2164, 1671, 942, 2308, 2887, 2338, 2900, 1501,
+  2965, 2242, 3133, 1909, 2191, 2122, 1652, 2522, 2115, 1649, 1700, 1718,
+  2048, 2789, 3243, 2141, 3459, 2563, 2930, 2284, 3131, 2157, 2000, 2126,
+  1791, 1959, 1957, 1420, 2169, 2228, 2537, 2382, 1644, 3014, 2364, 1922,
+  1307, 2366, 2455, 2677, 1859, 3194, 1995, 1489, 3658, 3475, 3012, 1568,
+  2141, 2189, 2523, 2433, 2129, 1505, 3333, 2426, 2529, 2471, 2463, 2161,
+  2571, 987, 3046, 1090, 2533, 2026, 2895, 2174, 2254, 1147, 3228, 2258,
+  2204, 1956, 2034, 1413, 3706, 2522, 3881, 1174, 2343, 2155, 1886, 894,
+  1771, 2109, 1969, 1979, 2834, 2107, 2236, 2430, 2377, 2060, 2500, 724,
+  2330, 2455, 2624, 2108, 1418, 2234, 2007, 1808, 2373, 1741, 1980, 1164,
+  2848, 2196, 2134, 868, 2259, 2141, 1433, 413, 1396, 1596, 2455, 1866,
+  2313, 2321, 2112, 1690, 1564, 1628, 2561, 769, 2545, 2592, 3028, 1606,
+  2113, 1947, 2076, 1894, 2310, 1816, 2046, 1389, 2327, 2612, 2901, 2190,
+  239, 1627, 2385, 2986, 2398, 3011, 2377, 1983, 2648, 2351, 2129, 945,
+  2279, 2354, 1759, 2103, 2706, 1862, 2769, 2024, 851, 1899, 2307, 2266,
+  2599, 2490, 1916, 1998, 2698, 1794, 2527, 1989, 1842, 1319, 2392, 3790,
+  3437, 3236, 2880, 1937, 2467, 2287, 2140, 2032, 2113, 1650, 2553, 1766,
+  2437, 2275, 2916, 1533, 1604, 2383, 1710, 2137, 2832, 2374, 2442, 919,
+  3205, 2372, 2772, 918, 2604, 1874, 2224, 3653, 3521, 3165, 2633, 2492,
+  3134, 3308, 2178, 972, 2664, 1610, 1909, 2668, 2331, 1707, 2240, 1855,
+  1125, 1739, 2411, 3030, 2829, 2516, 2043, 2124, 2338, 1402, 2407, 1986,
+  2278, 2372, 2669, 3768, 3611, 3583, 2881, 1962, 3093, 2661, 2231, 1572,
+  2531, 1706, 2382, 2626, 2112, 1585, 2943, 1750, 1464, 2535, 2580, 2062,
+  2956, 1673, 1912, 1172, 2048, 2645, 3101, 2082, 3067, 1998, 2532, 1668,
+  2530, 1945, 2113, 1854, 2162, 2131, 2027, 1439, 3195, 1721, 2403, 2388,
+  2511, 2117, 2276, 2117, 1525, 1328, 1983, 2554, 2441, 2726, 2319, 1715,
+  3493, 2108, 2541, 1588, 2224, 2480, 2799, 2152, 2527, 2419, 2297, 2322,
+  2463, 2399, 2726, 1847, 2748, 1095, 2398, 781, 2030, 1834, 2554, 1884,
+  1991, 2262, 2408, 2278, 2422, 2294, 2525, 1444, 3746, 2489, 2471, 2055,
+  2285, 1875, 2370, 888, 1938, 2520, 2286, 1788, 2913, 2345, 2147, 2431,
+  2194, 1990, 1799, 2337, 2086, 2281, 2386, 1938, 1485, 2310, 2010, 1362,
+  2193, 2964, 2008, 1536, 2480, 2422, 2070, 1077, 1731, 2521, 2651, 246,
+  1947, 2105, 2110, 1840, 2238, 2335, 1855, 1682, 1400, 1667, 2141, 2621,
+  1869, 3094, 2602, 1738, 1478, 2573, 2153, 1880, 2531, 2062, 2328, 1525,
+  2687, 2037, 2404, 1983, 2826, 1480, 2516, 1956, 988, 2800, 1768, 2252,
+  2693, 2443, 2481, 862, 2389, 2709, 1108, 2472, 2824, 1183, 2231, 2307,
+  652, 2185, 1942, 2271, 2113, 2350, 2251, 2686, 3240, 1953, 2099, 2309,
+  2077, 2287, 2528, 2131, 996, 2372, 1434, 1674, 2602, 2610, 2256, 1913,
+  2492, 2626, 1711, 1691, 2878, 2457, 1794, 1991, 1643, 1900, 1511, 1981,
+  2583, 2302, 1824, 2089, 3396, 1884, 2075, 1702, 1884, 2167, 1820, 3668,
+  1178, 2388, 1227, 1537, 2459, 1690, 2175, 308, 2734, 2010, 1311, 2127,
+  2515, 1884, 2486, 2004, 1739, 1954, 2361, 2854, 2383, 1731, 2599, 2151,
+  2458, 1982, 2250, 2394, 2427, 3007, 1839, 2256, 1090, 1767, 1700, 2418,
+  2157, 1481, 2400, 1374, 2136, 1603, 1932, 2015, 2564, 1936, 2561, 1750,
+  1288, 1748, 1638, 1915, 2109, 1400, 1766, 1280, 2048, 2600, 3086, 1978,
+  2936, 1919, 2526, 1754, 2754, 1830, 1799, 2171, 2031, 2252, 2178, 1316,
+  3249, 2113, 2334, 2690, 2298, 2131, 2680, 2191, 1139, 1971, 2218, 2403,
+  2246, 2637, 2319, 1579, 3539, 2339, 2864, 2080, 2383, 1898, 2962, 2604,
+  2433, 2359, 2788, 1631, 2618, 2647, 2651, 1762, 2727, 869, 2429, 1716,
+  2544, 2235, 2748, 2008, 1971, 2624, 2830, 2385, 2854, 2125, 2130, 1548,
+  3762, 2081, 2604, 1921, 2515, 2046, 2686, 1484, 1938, 2360, 2570, 2797,
+  3002, 2353, 2570, 2707, 1450, 2235, 2081, 1734, 1881, 1865, 2471, 2761,
+  1882, 2560, 2262, 1695, 2193, 2280, 2161, 866, 1598, 2283, 2158, 856,
+  2101, 2672, 2953, 435, 1482, 2232, 2640, 2412, 1741, 2382, 2173, 1891,
+  1766, 2345, 2448, 2100, 2163, 2193, 2946, 1752, 1453, 2003, 2254, 2113,
+  2138, 2397, 2439, 1515, 2264, 1418, 2686, 1454, 3000, 1522, 2427, 1886,
+  701, 2643, 2118, 1963, 3191, 2268, 2517, 909, 2216, 2164, 2115, 1805,
+  2965, 1463, 3374, 2418, 1589, 1586, 2405, 2057, 2283, 2485, 1793, 2603,
+  1694, 1058, 2054, 2747, 2142, 2029, 1837, 2572, 1126, 1799, 2443, 1602,
+  2228, 2575, 3156, 1865, 3102, 1406, 3032, 1074, 2508, 2643, 1623, 2020,
+  1041, 1098, 2083, 1299, 2698, 2398, 1869, 1673, 2520, 1379, 2509, 1958,
+  2528, 2289, 2391, 3803, 1681, 871, 2803, 1892, 3220, 2388, 1385, 548,
+  2001, 1043, 2580, 1108, 2365, 1388, 2019, 2714, 1274, 627, 2780, 1361,
+  2594, 2343, 2861, 2805, 2214, 861, 2691, 2258, 3214, 1610, 2089, 2286,
+  1392, 2249, 1812, 1478, 2482, 2049, 1786, 2205, 2127, 1953, 2336, 2181,
+  2243, 1743, 2722, 2075, 1146, 1475, 2821, 1576, 3320, 1402, 2209, 1309,
+  2048, 2719, 3106, 1738, 2914, 2173, 2314, 1708, 2824, 1793, 2473, 1713,
+  2527, 2177, 2217, 1330, 2975, 2006, 2478, 2454, 1723, 2543, 2000, 1863,
+  1504, 2031, 2224, 2439, 1609, 2326, 2070, 1440, 3348, 2262, 2835, 2628,
+  2487, 2793, 2927, 2321, 2253, 1460, 3135, 2537, 2535, 3065, 2865, 1877,
+  2832, 1657, 3089, 2484, 2479, 2898, 2947, 2075, 2410, 1552, 2824, 2568,
+  2404, 2318, 2498, 1174, 3570, 1694, 2988, 1351, 2832, 1835, 2602, 2204,
+  2274, 2249, 2971, 2096, 3197, 2233, 2749, 1855, 2217, 2578, 2640, 789,
+  2576, 2939, 2941, 1557, 2264, 1974, 2851, 2456, 2663, 3066, 2636, 541,
+  2337, 2466, 2546, 1190, 2578, 2429, 2690, 1970, 1950, 2274, 2940, 1816,
+  2586, 2761, 2911, 1992, 2206, 1339, 2599, 945, 2302, 2297, 3128, 1364,
+  1934, 2243, 2834, 2026, 2591, 2110, 2574, 1392, 2648, 1292, 2194, 1012,
+  2542, 1800, 2214, 947, 651, 2056, 2007, 2046, 2724, 2066, 2365, 1944,
+  1511, 2195, 1840, 1873, 1752, 1752, 2154, 1880, 350, 1488, 1835, 2268,
+  1685, 3103, 2475, 1101, 630, 1373, 1778, 2291, 2073, 2618, 2495, 366,
+  862, 1390, 1851, 2913, 1914, 3129, 882, 2731, 2047, 1674, 1893, 1337,
+  2121, 3278, 1398, 3009, 594, 1837, 1427, 1626, 1392, 3022, 1392, 1533,
+  1392, 1667, 2520, 1643, 1816, 1869, 1707, 442, 927, 880, 2907, 1714,
+  1613, 2165, 2479, 2435, 1126, 1264, 1825, 2488, 1693, 2048, 2138, 2038,
+  1048, 1073, 2532, 1783, 1847, 2767, 2287, 3234, 2028, 1283, 1882, 2697,
+  1371, 2196, 1214, 272, 1023, 2123, 1936, 1868, 1467, 1845, 2488, 1672,
+  1450, 1916, 2631, 2393, 983, 2735, 3080, 2520, 768, 1902, 1927, 1965,
+  1915, 1725, 1756, 1264, 2048, 2867, 3245, 1800, 3332, 2228, 2432, 1947,
+  3261, 1972, 2628, 1915, 2692, 2199, 2526, 1523, 3280, 1651, 2391, 1779,
+  1505, 1957, 2310, 1661, 1452, 2115, 2345, 1970, 1586, 2189, 1789, 1508,
+  1990, 1949, 2261, 2705, 2335, 2456, 2086, 1814, 1628, 1372, 1974, 2885,
+  2665, 2619, 2485, 1269, 2649, 1283, 2323, 2503, 2460, 2513, 2345, 2418,
+  1962, 1277, 2039, 2539, 2414, 2773, 2236, 1592, 3774, 3740, 2839, 1058,
+  1628, 2200, 3109, 2209, 2360, 2087, 2566, 2094, 2273, 1893, 2347, 1317,
+  1801, 1883, 2420, 541, 1709, 1518, 3166, 2086, 2377, 1801, 2292, 1697,
+  2167, 2773, 2212, 739, 2876, 1905, 2537, 799, 1716, 1855, 2625, 1740,
+  2214, 2659, 2184, 1514, 2514, 2607, 2816, 1739, 2483, 1539, 2516, 622,
+  2029, 2216, 3164, 1839, 1843, 1610, 2422, 2281, 2336, 1852, 2429, 1305,
+  2133, 2106, 3913, 1692, 3405, 2160, 2183, 560, 2151, 2492, 1415, 2165,
+  3239, 1992, 2374, 2184, 1880, 2929, 1503, 2253, 2787, 2312, 2597, 2057,
+  1321, 2193, 1891, 1989, 2602, 2822, 1862, 964, 3010, 2328, 2129, 2937,
+  2441, 2576, 1698, 264, 1372, 2826, 1916, 1653, 2234, 2151, 1392, 2588,
+  1391, 1867, 2542, 1700, 2523, 2853, 2009, 1782, 2080, 2787, 1850, 2402,
+  2519, 2536, 1550, 1706, 3049, 2705, 2268, 2576, 1530, 1681, 1788, 347,
+  1150, 2529, 2008, 1631, 3382, 2050, 1525, 2156, 1841, 2267, 2207, 1520,
+  3124, 1776, 1989, 1991, 1684, 1819, 2630, 2075, 2198, 2544, 2358, 1796,
+  1973, 2244, 2474, 2856, 1781, 2113, 1608, 183, 1046, 2155, 1441, 1838,
+  3165, 1999, 2877, 2318, 1898, 2687, 2515, 2230, 2615, 2251, 3100, 1772,
+  1620, 2481, 1790, 1714, 2139, 1477, 1743, 1081, 2048, 2690, 3112, 1760,
+  3061, 1940, 2081, 1738, 2730, 2102, 2424, 1669, 2435, 2177, 2320, 1650,
+  2837, 1301, 2427, 1672, 1838, 1811, 1885, 1315, 1798, 1983, 1835, 1897,
+  2029, 1909, 2060, 1289, 3337, 2756, 2197, 2806, 2215, 2792, 2245, 1858,
+  1312, 2287, 2668, 2806, 2184, 2633, 2222, 1735, 2012, 1787, 2090, 2883,
+  1467, 2907, 2738, 2635, 1870, 2330, 2022, 2771, 1620, 2210, 2060, 1516,
+  3418, 1775, 3355, 1711, 2244, 2370, 3319, 2248, 2760, 1725, 2975, 2092,
+  1903, 2240, 2793, 1378, 2504, 1435, 3029, 1311, 2920, 2679, 3107, 1749,
+  2102, 1552, 2959, 1970, 2612, 2558, 3148, 669, 2918, 1379, 2723, 1898,
+  2577, 2002, 2711, 2219, 2310, 1504, 3153, 2460, 3021, 2959, 3812, 2732,
+  2410, 1191, 2720, 1574, 1960, 2441, 3252, 2543, 3082, 1602, 2820, 2661,
+  2715, 2155, 2604, 1618, 2541, 1309, 2232, 1128, 3492, 1822, 2281, 1388,
+  2285, 2517, 2320, 2109, 3450, 1731, 2718, 1296, 2118, 2682, 2134, 1215,
+  3232, 1815, 2364, 2271, 2430, 2373, 2466, 2625, 2903, 2742, 2274, 568,
+  2840, 2428, 1889, 1596, 2309, 2097, 2214, 605, 1373, 1636, 2801, 2535,
+  2956, 2859, 3193, 1829, 2086, 2351, 2899, 867, 3252, 2859, 2106, 2247,
+  1949, 1498, 2053, 2032, 2386, 2632, 3191, 1607, 850, 1743, 2485, 867,
+  2640, 2174, 1863, 507, 2481, 2427, 2673, 2255, 3330, 2118, 2987, 2200,
+  2342, 2038, 2681, 913, 2517, 2067, 2908, 2209, 1067, 1926, 3149, 2676,
+  2701, 1885, 2596, 1978, 1166, 1942, 2690, 1183, 3272, 1838, 2204, 827,
+  2286, 1632, 2666, 1727, 2896, 1845, 2173, 1358, 1798, 2320, 2180, 771,
+  2827, 1634, 3056, 728, 2317, 2178, 1506, 884, 3632, 1075, 1750, 1627,
+  2048, 2650, 3079, 1786, 2936, 1883, 2345, 1651, 2864, 2203, 2033, 2290,
+  2465, 2266, 2631, 1351, 3371, 1425, 2588, 1890, 2925, 1745, 2727, 1450,
+  2234, 2783, 2829, 1840, 2793, 2563, 2389, 1616, 3536, 2028, 2200, 1265,
+  1521, 2117, 2552, 1332, 1385, 2316, 2083, 1970, 1679, 2726, 2783, 1175,
+  1641, 1655, 2834, 2430, 1446, 2338, 2206, 1666, 1516, 2801, 2345, 2644,
+  1529, 1674, 2132, 1322, 3537, 1347, 1744, 1613, 1724, 2078, 1883, 908,
+  1944, 1984, 3013, 2686, 2311, 2062, 2144, 851, 1821, 887, 2084, 2413,
+  1429, 2850, 2927, 3057, 2346, 1193, 2475, 2760, 1459, 2007, 1909, 486,
+  1952, 1241, 2308, 3159, 2470, 2443, 2305, 1593, 1046, 860, 1540, 2149,
+  1619, 2739, 2343, 2933, 2315, 1272, 2780, 2332, 1772, 2683, 2648, 2324,
+  1468, 957, 1910, 3152, 2522, 2508, 2518, 1332, 1794, 1793, 1865, 931,
+  2097, 2810, 1935, 1409, 1810, 2036, 1619, 1796, 2186, 1667, 2415, 406,
+  2207, 1967, 3099, 874, 3542, 1736, 3374, 1643, 3105, 1343, 2296, 2255,
+  2315, 2667, 2530, 370, 3221, 1001, 1630, 594, 2418, 1501, 1818, 2514,
+  906, 576, 3492, 1867, 3447, 2186, 3311, 2849, 3263, 1013, 2846, 442,
+  2851, 2747, 2124, 1817, 1792, 1285, 2027, 2322, 2080, 2821, 2376, 1520,
+  1251, 908, 2914, 435, 2686, 2352, 3318, 2027, 3465, 1089, 3288, 1595,
+  3025, 1551, 2099, 2486, 1364, 1190, 2509, 497, 1949, 2562, 1349, 1765,
+  1315, 665, 2338, 1864, 2721, 3335, 3415, 2067, 3115, 888, 3251, 954,
+  2920, 1392, 2438, 2621, 2260, 900, 2399, 1831, 2529, 2882, 2754, 2471,
+  1808, 1338, 1844, 191, 2031, 2145, 3154, 1629, 2847, 1224, 2926, 1741,
+  3365, 1056, 1848, 1461, 2048, 2861, 3067, 2054, 2770, 2442, 2631, 1569,
+  2797, 2477, 3036, 1732, 2963, 1898, 1960, 1361, 2705, 1346, 3476, 1934,
+  3571, 2069, 2353, 1512, 3371, 2356, 2408, 2250, 2607, 2320, 2334, 1411,
+  2581, 816, 2228, 999, 2736, 2586, 1982, 1488, 3762, 2659, 3039, 2732,
+  2953, 2776, 3198, 1338, 3755, 2184, 3036, 2670, 2724, 2378, 2915, 2370,
+  2577, 2570, 2864, 2452, 2968, 2224, 2588, 1118, 3536, 575, 2050, 494,
+  2111, 2441, 2647, 650, 3459, 2389, 3110, 2681, 1909, 2043, 2999, 972,
+  3650, 2271, 3403, 3058, 1960, 2473, 3522, 1839, 2104, 3004, 2975, 2553,
+  2126, 3263, 2645, 590, 774, 2652, 2862, 3240, 2086, 2580, 3311, 2680,
+  1912, 2376, 3499, 2145, 1945, 2812, 2984, 2491, 1720, 2374, 3080, 2587,
+  2041, 2899, 3190, 2292, 2174, 2681, 2625, 2989, 2196, 1839, 2621, 1267,
+  2312, 1606, 2027, 265, 1675, 2222, 2611, 218, 1551, 1773, 1568, 1471,
+  1738, 1745, 2571, 257, 3555, 1324, 1026, 1021, 1893, 2048, 3438, 1982,
+  1212, 1180, 1762, 1048, 1634, 2400, 2783, 321, 330, 664, 2906, 2709,
+  1437, 1441, 2632, 1382, 1769, 850, 3225, 1758, 1594, 3067, 3289, 1996,
+  1678, 779, 2879, 2619, 1669, 2883, 2853, 2345, 1891, 835, 1998, 2108,
+  1843, 3245, 2853, 1784, 2141, 64, 2773, 2644, 1785, 2248, 2613, 1922,
+  1481, 373, 2974, 2482, 1395, 2735, 3480, 2154, 1349, 774, 2859, 1930,
+  1652, 1948, 3674, 1833, 1615, 686, 2761, 2645, 2006, 1673, 2489, 2044,
+  1710, 485, 2833, 2588, 991, 1424, 1931, 2044, 1682, 560, 2585, 1535,
+  1649, 2293, 3378, 1740, 1341, 870, 3318, 2803, 1556, 2205, 3257, 1520,
+  1545, 1214, 2550, 1757, 1845, 514, 1322, 1405,
+};
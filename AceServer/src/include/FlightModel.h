@@ -0,0 +1,174 @@
+#pragma once
+
+#include "FGFDMExec.h"
+#include "Protocol.h"
+#include "initialization/FGInitialCondition.h"
+#include "math/angles.hpp"
+#include "models/FGFCS.h"
+#include "models/FGPropagate.h"
+#include "models/FGPropulsion.h"
+#include "utils/job_system.hpp"
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+constexpr auto FLIGHT_MODEL_SUBSTEPS = 2;
+constexpr auto FLIGHT_MODEL_START_ALTITUDE = 1000.;
+constexpr auto FLIGHT_MODEL_START_SPEED = 250.;
+constexpr auto FLIGHT_MODEL_EARTH_RADIUS = 6371000.;
+
+// One JSBSim instance per player. The models are grabbed once after loading,
+// going through the property tree by name on every tick is far too slow
+class FlightModel
+{
+public:
+  bool Load(const std::string& rootDir, const std::string& aircraft)
+  {
+    Exec = std::make_unique<JSBSim::FGFDMExec>();
+    Exec->SetRootDir(SGPath(rootDir));
+    Exec->SetAircraftPath(SGPath("aircraft"));
+    Exec->SetEnginePath(SGPath("engine"));
+    Exec->SetSystemsPath(SGPath("systems"));
+    Exec->DisableOutput();
+    if (!Exec->LoadModel(aircraft))
+      return false;
+
+    Fcs = Exec->GetFCS();
+    Propagate = Exec->GetPropagate();
+    Propulsion = Exec->GetPropulsion();
+
+    auto ic = Exec->GetIC();
+    ic->SetLatitudeDegIC(0.);
+    ic->SetLongitudeDegIC(0.);
+    ic->SetAltitudeASLFtIC(FLIGHT_MODEL_START_ALTITUDE / .3048);
+    ic->SetVcalibratedKtsIC(FLIGHT_MODEL_START_SPEED);
+    ic->SetPsiDegIC(0.);
+    return true;
+  }
+
+  void Reset()
+  {
+    Exec->ResetToInitialConditions(0);
+    Propulsion->InitRunning(-1);
+  }
+
+  // Inputs are mapped to JSBSim sign conventions: positive elevator and rudder
+  // commands push the nose down and to the left
+  void Step(const PlayerInput& input, float elapsedTime)
+  {
+    Fcs->SetDeCmd(-input.Pitch);
+    Fcs->SetDaCmd(input.Roll);
+    Fcs->SetDrCmd(-input.Yaw);
+    Fcs->SetThrottleCmd(-1, (input.Throttle + 1.) * .5);
+
+    Exec->Setdt(elapsedTime / 1000. / FLIGHT_MODEL_SUBSTEPS);
+    for (auto i = 0; i < FLIGHT_MODEL_SUBSTEPS; i++)
+      Exec->Run();
+  }
+
+  // Flat earth around the start location, x north, y east and z up in cm
+  Vector3 GetPosition() const
+  {
+    auto north = Propagate->GetLatitude() * FLIGHT_MODEL_EARTH_RADIUS;
+    auto east = Propagate->GetLongitude() * FLIGHT_MODEL_EARTH_RADIUS *
+                std::cos(Propagate->GetLatitude());
+    auto up = Propagate->GetAltitudeASLmeters() - FLIGHT_MODEL_START_ALTITUDE;
+    return StartPos + Vector3(north * 100., east * 100., up * 100.);
+  }
+
+  // Roll, pitch and yaw in degrees
+  Vector3 GetRotation() const
+  {
+    return Vector3(Propagate->GetEuler(JSBSim::FGJSBBase::ePhi) * Rad2Deg,
+                   Propagate->GetEuler(JSBSim::FGJSBBase::eTht) * Rad2Deg,
+                   Propagate->GetEuler(JSBSim::FGJSBBase::ePsi) * Rad2Deg);
+  }
+
+private:
+  std::unique_ptr<JSBSim::FGFDMExec> Exec;
+  std::shared_ptr<JSBSim::FGFCS> Fcs;
+  std::shared_ptr<JSBSim::FGPropagate> Propagate;
+  std::shared_ptr<JSBSim::FGPropulsion> Propulsion;
+};
+
+// JSBSim cannot share a parsed aircraft between instances, so every instance
+// is loaded once up front (in parallel) and then recycled across connections:
+// a connecting player only pays for a reset instead of parsing the XML files
+class FlightModelPool
+{
+public:
+  FlightModelPool(std::string rootDir, std::string aircraft)
+    : RootDir(std::move(rootDir))
+    , Aircraft(std::move(aircraft))
+  {
+    JSBSim::FGJSBBase::debug_lvl = 0;
+  }
+
+  bool Prewarm(size_t count, JobSystem& jobs)
+  {
+    auto models = std::vector<std::unique_ptr<FlightModel>>(count);
+    auto failed = std::atomic<bool>(false);
+    jobs.ParallelFor(count, 1, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++) {
+        models[i] = std::make_unique<FlightModel>();
+        if (!models[i]->Load(RootDir, Aircraft))
+          failed = true;
+      }
+    });
+    if (failed)
+      return false;
+
+    auto lock = std::lock_guard(Mutex);
+    for (auto& model : models) {
+      Free.push_back(model.get());
+      Models.push_back(std::move(model));
+    }
+    return true;
+  }
+
+  FlightModel* Acquire()
+  {
+    auto lock = std::lock_guard(Mutex);
+    if (Free.empty()) {
+      auto model = std::make_unique<FlightModel>();
+      if (!model->Load(RootDir, Aircraft))
+        return nullptr;
+      Free.push_back(model.get());
+      Models.push_back(std::move(model));
+    }
+    auto model = Free.back();
+    Free.pop_back();
+    model->Reset();
+    return model;
+  }
+
+  void Release(FlightModel* model)
+  {
+    if (model == nullptr)
+      return;
+    auto lock = std::lock_guard(Mutex);
+    Free.push_back(model);
+  }
+
+private:
+  std::string RootDir;
+  std::string Aircraft;
+  std::mutex Mutex;
+  std::vector<std::unique_ptr<FlightModel>> Models;
+  std::vector<FlightModel*> Free;
+};
+
+inline void
+StepFlightModel(FlightModel& aircraft,
+                const PlayerInput& input,
+                float elapsedTime,
+                Vector3& position,
+                Vector3& rotation)
+{
+  aircraft.Step(input, elapsedTime);
+  position = aircraft.GetPosition();
+  rotation = aircraft.GetRotation();
+}
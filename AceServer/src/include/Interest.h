@@ -0,0 +1,109 @@
+#pragma once
+
+#include "math/box.hpp"
+#include "math/sphere.hpp"
+#include "math/vector3.hpp"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+constexpr auto INTEREST_NEAR_RADIUS = 100000.f;
+constexpr auto INTEREST_MID_RADIUS = 400000.f;
+constexpr auto INTEREST_MID_INTERVAL = 4;
+constexpr auto INTEREST_CELL_SIZE = INTEREST_MID_RADIUS / 2;
+
+enum class InterestLevel : uint8_t
+{
+  None,
+  Mid,
+  Near
+};
+
+inline InterestLevel
+GetInterestLevel(const Vector3& viewer, const Vector3& target)
+{
+  auto distSq = (target - viewer).SquaredLength();
+  if (distSq <= INTEREST_NEAR_RADIUS * INTEREST_NEAR_RADIUS)
+    return InterestLevel::Near;
+  if (distSq <= INTEREST_MID_RADIUS * INTEREST_MID_RADIUS)
+    return InterestLevel::Mid;
+  return InterestLevel::None;
+}
+
+// Added every tick to the viewer's accumulator for the target, which is due
+// for a fresh state once it reaches 1: every tick for near entities, closest
+// first, every INTEREST_MID_INTERVAL ticks for mid band ones
+inline float
+GetInterestPriority(const Vector3& viewer, const Vector3& target)
+{
+  switch (GetInterestLevel(viewer, target)) {
+    case InterestLevel::Near:
+      return 2.f - (target - viewer).Length() / INTEREST_NEAR_RADIUS;
+    case InterestLevel::Mid:
+      return 1.f / INTEREST_MID_INTERVAL;
+    default:
+      return 0.f;
+  }
+}
+
+// Accumulators start staggered by index so that mid band entities don't all
+// land in the same snapshot
+inline float
+GetInitialPriority(uint16_t playerIndex)
+{
+  return static_cast<float>(playerIndex % INTEREST_MID_INTERVAL) /
+         INTEREST_MID_INTERVAL;
+}
+
+// Uniform grid over the horizontal plane, altitude is only filtered by the
+// final distance test since aircraft spread far more in XY than in Z
+struct InterestGrid
+{
+  std::unordered_map<uint64_t, std::vector<uint16_t>> Cells;
+
+  static int32_t CellCoord(float value)
+  {
+    return static_cast<int32_t>(std::floor(value / INTEREST_CELL_SIZE));
+  }
+
+  static uint64_t CellKey(int32_t x, int32_t y)
+  {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+  }
+
+  // Keeps the buckets that were used last tick to avoid reallocating them
+  void Clear()
+  {
+    for (auto it = Cells.begin(); it != Cells.end();)
+      if (it->second.empty())
+        it = Cells.erase(it);
+      else {
+        it->second.clear();
+        ++it;
+      }
+  }
+
+  void Insert(uint16_t playerIndex, const Vector3& position)
+  {
+    auto key = CellKey(CellCoord(position.x), CellCoord(position.y));
+    Cells[key].push_back(playerIndex);
+  }
+
+  template<typename F>
+  void Query(const Sphere& sphere, F&& callback) const
+  {
+    auto bounds = Box(sphere.center, Vector3(1, 1, 1) * (2 * sphere.radius));
+    auto mins = bounds.Mins();
+    auto maxs = bounds.Maxs();
+    for (auto x = CellCoord(mins.x); x <= CellCoord(maxs.x); x++)
+      for (auto y = CellCoord(mins.y); y <= CellCoord(maxs.y); y++) {
+        auto it = Cells.find(CellKey(x, y));
+        if (it == Cells.end())
+          continue;
+        for (auto playerIndex : it->second)
+          callback(playerIndex);
+      }
+  }
+};
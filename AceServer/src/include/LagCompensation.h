@@ -0,0 +1,254 @@
+#pragma once
+
+#include "PlayerStore.h"
+#include "Protocol.h"
+#include "math/angles.hpp"
+#include "math/batch.hpp"
+#include "math/capsule.hpp"
+#include "math/ray.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+constexpr auto LAG_COMPENSATION_MS = 300;
+constexpr auto LAG_COMPENSATION_TICKS = LAG_COMPENSATION_MS / NET_TICK + 1;
+constexpr auto HIT_CELL_SIZE = 20000.f;
+constexpr auto HIT_CAPSULE_LENGTH = 1400.f;
+constexpr auto HIT_CAPSULE_RADIUS = 500.f;
+constexpr auto WEAPON_RANGE = 150000.f;
+constexpr auto FIRE_INTERVAL_TICKS = 6;
+
+struct HitCapsule
+{
+  uint16_t PlayerIndex = 0;
+  Capsule Shape;
+};
+
+// Fuselage capsule along the nose direction, rotation is roll, pitch and yaw
+// in degrees like the player rotations
+inline Capsule
+MakeHitCapsule(const Vector3& position, const Vector3& rotation)
+{
+  auto pitch = DegreesToRadians(rotation.y);
+  auto yaw = DegreesToRadians(rotation.z);
+  auto forward = Vector3(std::cos(pitch) * std::cos(yaw),
+                         std::cos(pitch) * std::sin(yaw),
+                         std::sin(pitch));
+  auto half = forward * (HIT_CAPSULE_LENGTH * .5f);
+  return Capsule(position - half, position + half, HIT_CAPSULE_RADIUS);
+}
+
+// Hit capsules of one tick with a uniform grid over the horizontal plane.
+// Capsules are sorted by player index and registered in every cell their
+// bounds overlap, a shot then only tests the capsules of the cells it crosses
+struct HitFrame
+{
+  uint32_t TickIndex = 0;
+  std::vector<HitCapsule> Capsules;
+  std::unordered_map<uint64_t, std::vector<uint16_t>> Cells;
+
+  static int32_t CellCoord(float value)
+  {
+    return static_cast<int32_t>(std::floor(value / HIT_CELL_SIZE));
+  }
+
+  static uint64_t CellKey(int32_t x, int32_t y)
+  {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+  }
+
+  // Keeps the buckets that were used last time to avoid reallocating them
+  void Clear(uint32_t tickIndex)
+  {
+    TickIndex = tickIndex;
+    Capsules.clear();
+    for (auto it = Cells.begin(); it != Cells.end();)
+      if (it->second.empty())
+        it = Cells.erase(it);
+      else {
+        it->second.clear();
+        ++it;
+      }
+  }
+
+  void Insert(uint16_t playerIndex, const Capsule& shape)
+  {
+    auto slot = static_cast<uint16_t>(Capsules.size());
+    Capsules.push_back({ playerIndex, shape });
+    auto minX = CellCoord(std::min(shape.start.x, shape.end.x) - shape.radius);
+    auto maxX = CellCoord(std::max(shape.start.x, shape.end.x) + shape.radius);
+    auto minY = CellCoord(std::min(shape.start.y, shape.end.y) - shape.radius);
+    auto maxY = CellCoord(std::max(shape.start.y, shape.end.y) + shape.radius);
+    for (auto x = minX; x <= maxX; x++)
+      for (auto y = minY; y <= maxY; y++)
+        Cells[CellKey(x, y)].push_back(slot);
+  }
+
+  const HitCapsule* Find(uint16_t playerIndex) const
+  {
+    auto it = std::lower_bound(
+      Capsules.begin(),
+      Capsules.end(),
+      playerIndex,
+      [](const auto& c, uint16_t index) { return c.PlayerIndex < index; });
+    if (it == Capsules.end() || it->PlayerIndex != playerIndex)
+      return nullptr;
+    return &*it;
+  }
+
+  // Walks the cells crossed by the segment [origin, origin + dir * length]
+  template<typename F>
+  void Traverse(const Vector3& origin,
+                const Vector3& direction,
+                float length,
+                F&& callback) const
+  {
+    auto x = CellCoord(origin.x);
+    auto y = CellCoord(origin.y);
+    auto endX = CellCoord(origin.x + direction.x * length);
+    auto endY = CellCoord(origin.y + direction.y * length);
+    auto stepX = direction.x >= 0 ? 1 : -1;
+    auto stepY = direction.y >= 0 ? 1 : -1;
+    auto boundary = [](int32_t cell, int step) {
+      return (cell + (step > 0 ? 1 : 0)) * HIT_CELL_SIZE;
+    };
+    auto inf = std::numeric_limits<float>::infinity();
+    auto deltaX =
+      direction.x != 0 ? HIT_CELL_SIZE / std::abs(direction.x) : inf;
+    auto deltaY =
+      direction.y != 0 ? HIT_CELL_SIZE / std::abs(direction.y) : inf;
+    auto nextX = direction.x != 0
+                   ? (boundary(x, stepX) - origin.x) / direction.x
+                   : inf;
+    auto nextY = direction.y != 0
+                   ? (boundary(y, stepY) - origin.y) / direction.y
+                   : inf;
+
+    while (true) {
+      auto it = Cells.find(CellKey(x, y));
+      if (it != Cells.end())
+        for (auto slot : it->second)
+          callback(Capsules[slot]);
+      if (x == endX && y == endY)
+        break;
+      if (nextX < nextY) {
+        if (nextX > length)
+          break;
+        x += stepX;
+        nextX += deltaX;
+      } else {
+        if (nextY > length)
+          break;
+        y += stepY;
+        nextY += deltaY;
+      }
+    }
+  }
+};
+
+struct ShotResult
+{
+  bool Hit = false;
+  uint16_t PlayerIndex = 0;
+  float Distance = 0;
+};
+
+// Ring of the last LAG_COMPENSATION_TICKS hit frames. Shots are resolved
+// against the world as the shooter saw it: between the two frames around its
+// interpolated view tick instead of the current positions
+class HitHistory
+{
+public:
+  void Record(uint32_t tickIndex, const PlayerStore& players)
+  {
+    auto& frame = Frames[tickIndex % LAG_COMPENSATION_TICKS];
+    frame.Clear(tickIndex);
+    for (auto i = size_t(); i < players.Size(); i++)
+      frame.Insert(players.Indices[i],
+                   MakeHitCapsule(players.Positions[i], players.Rotations[i]));
+  }
+
+  const HitFrame* Find(uint32_t tickIndex) const
+  {
+    if (tickIndex == 0)
+      return nullptr;
+    const auto& frame = Frames[tickIndex % LAG_COMPENSATION_TICKS];
+    return frame.TickIndex == tickIndex ? &frame : nullptr;
+  }
+
+  // viewTickIndex is clamped to the recorded history, the capsules are lerped
+  // towards the next frame by viewFraction
+  ShotResult Resolve(uint32_t currentTickIndex,
+                     uint32_t viewTickIndex,
+                     float viewFraction,
+                     uint16_t shooterIndex,
+                     const Ray& ray) const
+  {
+    auto oldest = currentTickIndex >= LAG_COMPENSATION_TICKS
+                    ? currentTickIndex - LAG_COMPENSATION_TICKS + 1
+                    : 1;
+    viewTickIndex = std::clamp(viewTickIndex, oldest, currentTickIndex);
+    auto from = Find(viewTickIndex);
+    if (from == nullptr)
+      return {};
+    auto to = viewTickIndex < currentTickIndex ? Find(viewTickIndex + 1)
+                                               : nullptr;
+    viewFraction = std::clamp(viewFraction, 0.f, 1.f);
+
+    thread_local auto candidates = std::vector<uint16_t>();
+    candidates.clear();
+    // Aircraft move far less than a cell per tick, so the cells of both
+    // frames cover the lerped capsule
+    from->Traverse(ray.origin, ray.direction, WEAPON_RANGE, [&](const auto& c) {
+      candidates.push_back(c.PlayerIndex);
+    });
+    if (to != nullptr)
+      to->Traverse(ray.origin, ray.direction, WEAPON_RANGE, [&](const auto& c) {
+        candidates.push_back(c.PlayerIndex);
+      });
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    thread_local auto shapes = CapsuleSoA();
+    thread_local auto distances = std::vector<float>();
+    shapes.Clear();
+    candidates.erase(
+      std::remove_if(candidates.begin(),
+                     candidates.end(),
+                     [&](uint16_t index) {
+                       return index == shooterIndex ||
+                              from->Find(index) == nullptr;
+                     }),
+      candidates.end());
+    for (auto index : candidates) {
+      auto shape = from->Find(index)->Shape;
+      auto end = to != nullptr ? to->Find(index) : nullptr;
+      if (end != nullptr) {
+        shape.start += (end->Shape.start - shape.start) * viewFraction;
+        shape.end += (end->Shape.end - shape.end) * viewFraction;
+      }
+      shapes.Push(shape);
+    }
+    distances.resize(candidates.size());
+    Batch::Intersects(ray, shapes, distances.data());
+
+    auto result = ShotResult();
+    result.Distance = WEAPON_RANGE;
+    auto closest = Batch::Closest(distances.data(), distances.size());
+    if (closest < distances.size() && distances[closest] < WEAPON_RANGE) {
+      result.Hit = true;
+      result.PlayerIndex = candidates[closest];
+      result.Distance = distances[closest];
+    }
+    return result;
+  }
+
+private:
+  std::array<HitFrame, LAG_COMPENSATION_TICKS> Frames;
+};
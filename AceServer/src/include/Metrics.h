@@ -0,0 +1,169 @@
+#pragma once
+
+#include "json/json.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+constexpr auto METRICS_SUMMARY_TICKS = 5 * 60;
+
+// Log-linear histogram: exact below 32, then 32 sub-buckets per power of two
+// (~3% precision) which is plenty for microsecond timings
+struct LatencyHistogram
+{
+  static constexpr auto SubBuckets = 32;
+  static constexpr auto SubBucketBits = 5;
+  static constexpr auto BucketCount = SubBuckets * (64 - SubBucketBits + 1);
+
+  std::array<uint64_t, BucketCount> Buckets{};
+  uint64_t Count = 0;
+  uint64_t Sum = 0;
+  uint64_t Max = 0;
+
+  static size_t BucketIndex(uint64_t value)
+  {
+    if (value < SubBuckets)
+      return static_cast<size_t>(value);
+    auto msb = 63 - std::countl_zero(value);
+    auto shift = msb - SubBucketBits;
+    auto sub = (value >> shift) & (SubBuckets - 1);
+    return SubBuckets + shift * SubBuckets + sub;
+  }
+
+  static uint64_t BucketValue(size_t index)
+  {
+    if (index < SubBuckets)
+      return index;
+    auto shift = (index - SubBuckets) / SubBuckets;
+    auto sub = (index - SubBuckets) % SubBuckets;
+    return (SubBuckets + sub) << shift;
+  }
+
+  void Record(uint64_t value)
+  {
+    Buckets[BucketIndex(value)]++;
+    Count++;
+    Sum += value;
+    Max = std::max(Max, value);
+  }
+
+  uint64_t Percentile(double percentile) const
+  {
+    if (Count == 0)
+      return 0;
+    auto target = static_cast<uint64_t>(percentile / 100. * Count);
+    auto seen = uint64_t();
+    for (auto i = size_t(); i < Buckets.size(); i++) {
+      seen += Buckets[i];
+      if (seen > target)
+        return std::min(BucketValue(i), Max);
+    }
+    return Max;
+  }
+
+  double Mean() const { return Count ? static_cast<double>(Sum) / Count : 0.; }
+
+  nlohmann::json ToJson() const
+  {
+    return { { "count", Count },
+             { "mean", Mean() },
+             { "p50", Percentile(50) },
+             { "p90", Percentile(90) },
+             { "p99", Percentile(99) },
+             { "p999", Percentile(99.9) },
+             { "max", Max } };
+  }
+};
+
+struct TickSample
+{
+  uint32_t TickIndex = 0;
+  uint64_t DurationUs = 0;
+  uint64_t StartJitterUs = 0;
+  uint32_t BytesSent = 0;
+  uint32_t PacketsSent = 0;
+  uint32_t Peers = 0;
+};
+
+// Per-tick CSV rows plus a JSON summary rewritten every METRICS_SUMMARY_TICKS
+struct TickMetrics
+{
+  std::string OutputPrefix;
+  std::ofstream Csv;
+  LatencyHistogram TickDuration;
+  LatencyHistogram TickStartJitter;
+  LatencyHistogram BytesPerTick;
+  LatencyHistogram PacketsPerTick;
+  uint32_t LastBytesSent = 0;
+  uint32_t LastPacketsSent = 0;
+
+  bool Open(const std::string& prefix)
+  {
+    OutputPrefix = prefix;
+    Csv.open(prefix + ".csv");
+    if (!Csv)
+      return false;
+    Csv << "tick,duration_us,start_jitter_us,bytes_sent,packets_sent,peers\n";
+    return true;
+  }
+
+  // ENet counters are 32-bit and wrap, unsigned differences stay correct
+  TickSample Sample(uint32_t tickIndex,
+                    uint64_t durationUs,
+                    uint64_t startJitterUs,
+                    uint32_t bytesSent,
+                    uint32_t packetsSent,
+                    uint32_t peers)
+  {
+    auto sample = TickSample{ tickIndex,
+                              durationUs,
+                              startJitterUs,
+                              bytesSent - LastBytesSent,
+                              packetsSent - LastPacketsSent,
+                              peers };
+    LastBytesSent = bytesSent;
+    LastPacketsSent = packetsSent;
+    return sample;
+  }
+
+  void Record(const TickSample& sample)
+  {
+    TickDuration.Record(sample.DurationUs);
+    TickStartJitter.Record(sample.StartJitterUs);
+    BytesPerTick.Record(sample.BytesSent);
+    PacketsPerTick.Record(sample.PacketsSent);
+    if (Csv.is_open())
+      Csv << sample.TickIndex << ',' << sample.DurationUs << ','
+          << sample.StartJitterUs << ',' << sample.BytesSent << ','
+          << sample.PacketsSent << ',' << sample.Peers << '\n';
+  }
+
+  nlohmann::json ToJson() const
+  {
+    return { { "tick_duration_us", TickDuration.ToJson() },
+             { "tick_start_jitter_us", TickStartJitter.ToJson() },
+             { "bytes_per_tick", BytesPerTick.ToJson() },
+             { "packets_per_tick", PacketsPerTick.ToJson() } };
+  }
+
+  void WriteSummary()
+  {
+    if (OutputPrefix.empty())
+      return;
+    Csv.flush();
+    auto json = std::ofstream(OutputPrefix + ".json");
+    json << ToJson().dump(2) << '\n';
+  }
+};
+
+inline uint64_t
+GetMicroseconds()
+{
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch())
+    .count();
+}
@@ -0,0 +1,417 @@
+#pragma once
+
+#include "Compressor.h"
+#include "Protocol.h"
+#include "utils/ring_buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+// Events and commands each shard queues in one tick at most
+constexpr auto NET_SHARD_QUEUE_CAPACITY = 4096;
+// Peer slots have to fit 16 bits
+constexpr auto NET_MAX_SHARDS = 64;
+
+// Peer of any shard. The slot is unique across shards, NET_MAX_CLIENTS per
+// shard, and the session tells apart the successive connections on a slot so
+// that packets queued for a peer that already left are dropped rather than
+// sent to the next one. A valid id is never 0
+struct NetPeerId
+{
+  uint32_t Value = 0;
+
+  uint16_t Slot() const { return static_cast<uint16_t>(Value); }
+  uint16_t Session() const { return static_cast<uint16_t>(Value >> 16); }
+  size_t Shard() const { return Slot() / NET_MAX_CLIENTS; }
+};
+
+struct NetEvent
+{
+  ENetEventType Type = ENET_EVENT_TYPE_NONE;
+  NetPeerId Peer;
+  ENetPacket* Packet = nullptr;
+  // Connect data of a connection
+  uint32_t Data = 0;
+};
+
+// Link of a peer as last seen by its shard, updated on every flush
+struct NetPeerStats
+{
+  std::atomic<uint64_t> PacketsSent = 0;
+  std::atomic<uint32_t> PacketsLost = 0;
+  std::atomic<uint32_t> Rtt = 0;
+};
+
+enum class NetCommandType : uint8_t
+{
+  Send,
+  Release,
+  Broadcast,
+  Disconnect,
+  Flush
+};
+
+struct NetCommand
+{
+  NetCommandType Type = NetCommandType::Flush;
+  NetPeerId Peer;
+  ENetPacket* Packet = nullptr;
+};
+
+// Network side of the server. Without threads a single host is serviced by
+// the simulation thread itself, through the same calls. With N threads each
+// one services its own host, all bound to the server port with SO_REUSEPORT
+// so that the kernel spreads the clients across them. Events then reach the
+// simulation and packets reach the shards through one single producer /
+// single consumer queue each way per shard, the simulation never touches a
+// host or a peer
+class NetShards
+{
+public:
+  NetShards() = default;
+  NetShards(const NetShards&) = delete;
+  NetShards& operator=(const NetShards&) = delete;
+
+  ~NetShards()
+  {
+    Stopping.store(true, std::memory_order_release);
+    for (auto& shard : Shards) {
+      Wake(*shard);
+      if (shard->Thread.joinable())
+        shard->Thread.join();
+      if (shard->Host != nullptr)
+        enet_host_destroy(shard->Host);
+#ifdef __linux__
+      if (shard->Epoll >= 0)
+        close(shard->Epoll);
+      if (shard->WakeFd >= 0)
+        close(shard->WakeFd);
+#endif
+    }
+  }
+
+  // Datagrams of the first shard only are recorded to capture, the file
+  // isn't shared between threads. Batching is reported by IsBatched()
+  bool Create(const ENetAddress& address,
+              unsigned threads,
+              size_t ioBatch,
+              std::FILE* capture)
+  {
+    Threaded = threads > 0;
+    Batched = true;
+    auto count = std::clamp(threads, 1u, unsigned(NET_MAX_SHARDS));
+    for (auto i = 0u; i < count; i++) {
+      auto& shard = *Shards.emplace_back(std::make_unique<Shard>());
+      shard.Host =
+        Threaded
+          ? enet_host_create_shared(
+              &address, NET_MAX_CLIENTS, NET_CHANNELS, 0, 0)
+          : enet_host_create(&address, NET_MAX_CLIENTS, NET_CHANNELS, 0, 0);
+      if (shard.Host == nullptr)
+        return false;
+      auto compressor = DatagramCompressor::Make(i == 0 ? capture : nullptr);
+      enet_host_compress(shard.Host, &compressor);
+      if (enet_host_set_batching(shard.Host, ioBatch) < 0)
+        Batched = false;
+      shard.FirstSlot = i * NET_MAX_CLIENTS;
+      shard.Sessions.assign(NET_MAX_CLIENTS, 0);
+    }
+    Stats = std::make_unique<NetPeerStats[]>(count * NET_MAX_CLIENTS);
+
+    if (Threaded)
+      for (auto& shard : Shards)
+        if (!Start(*shard))
+          return false;
+    return true;
+  }
+
+  bool IsBatched() const { return Batched; }
+  size_t GetShardCount() const { return Shards.size(); }
+  uint32_t GetMtu() const { return enet_host_get_mtu(Shards[0]->Host); }
+
+  // What the simulation thread waits on between ticks, nothing when the
+  // shards service their sockets themselves
+  ENetSocket GetWaitSocket() const
+  {
+    return Threaded ? ENET_SOCKET_NULL : Shards[0]->Host->socket;
+  }
+
+  // Calls handler for every event received since the last call, the handler
+  // owns the packet of a receive event
+  template<typename F>
+  void Poll(F&& handler)
+  {
+    if (!Threaded) {
+      Service(*Shards[0], static_cast<size_t>(-1), handler);
+      return;
+    }
+    auto event = NetEvent();
+    for (auto& shard : Shards)
+      while (shard->Events.Pop(event))
+        handler(event);
+  }
+
+  // The packet is freed once sent, or right away when the peer is gone
+  void Send(NetPeerId peer, ENetPacket* packet)
+  {
+    Submit(peer.Shard(), { NetCommandType::Send, peer, packet });
+  }
+
+  // Holds a packet about to be sent to several peers of one shard, ENet would
+  // otherwise free it as soon as it went out to the first one. Release() with
+  // any of these peers drops the hold once every Send() was made
+  static ENetPacket* Share(ENetPacket* packet)
+  {
+    packet->referenceCount++;
+    return packet;
+  }
+
+  void Release(NetPeerId peer, ENetPacket* packet)
+  {
+    Submit(peer.Shard(), { NetCommandType::Release, peer, packet });
+  }
+
+  // To every connected peer, through a copy of the packet per extra shard.
+  // The copies are made before the packet is handed to its shard
+  void Broadcast(ENetPacket* packet)
+  {
+    for (auto i = Shards.size(); i-- > 0;) {
+      auto shardPacket =
+        i == 0 ? packet
+               : enet_packet_create(
+                   packet->data, packet->dataLength, packet->flags);
+      Submit(i, { NetCommandType::Broadcast, NetPeerId(), shardPacket });
+    }
+  }
+
+  void Disconnect(NetPeerId peer)
+  {
+    Submit(peer.Shard(), { NetCommandType::Disconnect, peer, nullptr });
+  }
+
+  // Sends everything submitted so far and wakes the shards up to do it
+  void Flush()
+  {
+    for (auto i = size_t(); i < Shards.size(); i++) {
+      Submit(i, { NetCommandType::Flush, NetPeerId(), nullptr });
+      Wake(*Shards[i]);
+    }
+  }
+
+  const NetPeerStats& GetStats(NetPeerId peer) const
+  {
+    return Stats[peer.Slot()];
+  }
+
+  // Totals over the shards as of their last flush
+  uint32_t GetBytesSent() const { return Sum(&Shard::BytesSent); }
+  uint32_t GetPacketsSent() const { return Sum(&Shard::PacketsSent); }
+  uint32_t GetPeersCount() const { return Sum(&Shard::Peers); }
+
+private:
+  struct Shard
+  {
+    ENetHost* Host = nullptr;
+    uint32_t FirstSlot = 0;
+    // Current session of each peer, only touched by the servicing thread
+    std::vector<uint16_t> Sessions;
+    RingBuffer<NetEvent, NET_SHARD_QUEUE_CAPACITY> Events;
+    RingBuffer<NetCommand, NET_SHARD_QUEUE_CAPACITY> Commands;
+    std::atomic<uint32_t> BytesSent = 0;
+    std::atomic<uint32_t> PacketsSent = 0;
+    std::atomic<uint32_t> Peers = 0;
+    std::thread Thread;
+#ifdef __linux__
+    int Epoll = -1;
+    int WakeFd = -1;
+#endif
+  };
+
+  // The thread sleeps on its socket and on an eventfd written by Flush()
+  bool Start(Shard& shard)
+  {
+#ifdef __linux__
+    auto socket = shard.Host->socket;
+    auto epoll = shard.Epoll = epoll_create1(EPOLL_CLOEXEC);
+    auto wakeFd = shard.WakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    auto socketEvent = epoll_event{ EPOLLIN, { .fd = socket } };
+    auto wakeEvent = epoll_event{ EPOLLIN, { .fd = wakeFd } };
+    if (epoll < 0 || wakeFd < 0 ||
+        epoll_ctl(epoll, EPOLL_CTL_ADD, socket, &socketEvent) < 0 ||
+        epoll_ctl(epoll, EPOLL_CTL_ADD, wakeFd, &wakeEvent) < 0)
+      return false;
+#endif
+    shard.Thread = std::thread([this, &shard] { Run(shard); });
+    return true;
+  }
+
+  // Commands first so that a tick's packets go out as soon as it flushed,
+  // then events for as long as the simulation has room for them. Events left
+  // in the host are picked up on the next round
+  void Run(Shard& shard)
+  {
+    auto command = NetCommand();
+    while (!Stopping.load(std::memory_order_acquire)) {
+      Wait(shard);
+      while (shard.Commands.Pop(command))
+        Apply(shard, command);
+      Service(shard,
+              NET_SHARD_QUEUE_CAPACITY - shard.Events.Size(),
+              [&](const NetEvent& event) { shard.Events.Push(event); });
+    }
+  }
+
+  void Wait(Shard& shard)
+  {
+#ifdef __linux__
+    epoll_event events[2];
+    auto count = epoll_wait(shard.Epoll, events, 2, NET_TICK);
+    for (auto i = 0; i < count; i++)
+      if (events[i].data.fd == shard.WakeFd) {
+        auto value = uint64_t();
+        if (read(shard.WakeFd, &value, sizeof(value)) < 0)
+          continue;
+      }
+#else
+    auto condition = static_cast<enet_uint32>(ENET_SOCKET_WAIT_RECEIVE);
+    enet_socket_wait(shard.Host->socket, &condition, 1);
+#endif
+  }
+
+  void Wake(Shard& shard)
+  {
+#ifdef __linux__
+    if (shard.WakeFd < 0)
+      return;
+    auto value = uint64_t(1);
+    if (write(shard.WakeFd, &value, sizeof(value)) < 0)
+      return;
+#endif
+  }
+
+  template<typename F>
+  void Service(Shard& shard, size_t limit, F&& handler)
+  {
+    auto event = ENetEvent();
+    auto room = limit;
+    while (room > 0 && enet_host_service(shard.Host, &event, 0) > 0)
+      do {
+        handler(ToNetEvent(shard, event));
+        room--;
+      } while (room > 0 && enet_host_check_events(shard.Host, &event) > 0);
+  }
+
+  // A connection starts a new session on the slot, with clean statistics
+  NetEvent ToNetEvent(Shard& shard, const ENetEvent& event)
+  {
+    auto index = static_cast<size_t>(event.peer - shard.Host->peers);
+    auto& session = shard.Sessions[index];
+    if (event.type == ENET_EVENT_TYPE_CONNECT) {
+      if (++session == 0)
+        session = 1;
+      auto& stats = Stats[shard.FirstSlot + index];
+      stats.PacketsSent.store(0, std::memory_order_relaxed);
+      stats.PacketsLost.store(0, std::memory_order_relaxed);
+      stats.Rtt.store(0, std::memory_order_relaxed);
+    }
+    auto peer = NetPeerId{ static_cast<uint32_t>(shard.FirstSlot + index) |
+                           uint32_t(session) << 16 };
+    return { event.type, peer, event.packet, event.data };
+  }
+
+  static ENetPeer* Find(Shard& shard, NetPeerId peer)
+  {
+    auto index = peer.Slot() - shard.FirstSlot;
+    if (index >= shard.Sessions.size() ||
+        shard.Sessions[index] != peer.Session())
+      return nullptr;
+    return &shard.Host->peers[index];
+  }
+
+  void Submit(size_t index, const NetCommand& command)
+  {
+    auto& shard = *Shards[index];
+    if (!Threaded) {
+      Apply(shard, command);
+      return;
+    }
+    while (!shard.Commands.Push(command)) {
+      Wake(shard);
+      std::this_thread::yield();
+    }
+  }
+
+  void Apply(Shard& shard, const NetCommand& command)
+  {
+    auto packet = command.Packet;
+    switch (command.Type) {
+      case NetCommandType::Send: {
+        auto peer = Find(shard, command.Peer);
+        if ((peer == nullptr || enet_peer_send(peer, 0, packet) < 0) &&
+            packet->referenceCount == 0)
+          enet_packet_destroy(packet);
+      } break;
+      case NetCommandType::Release:
+        if (--packet->referenceCount == 0)
+          enet_packet_destroy(packet);
+        break;
+      case NetCommandType::Broadcast:
+        enet_host_broadcast(shard.Host, 0, packet);
+        break;
+      case NetCommandType::Disconnect:
+        if (auto peer = Find(shard, command.Peer))
+          enet_peer_disconnect(peer, 0);
+        break;
+      case NetCommandType::Flush:
+        enet_host_flush(shard.Host);
+        Publish(shard);
+        break;
+    }
+  }
+
+  void Publish(Shard& shard)
+  {
+    auto host = shard.Host;
+    for (auto i = size_t(); i < host->peerCount; i++) {
+      auto peer = &host->peers[i];
+      if (peer->state != ENET_PEER_STATE_CONNECTED)
+        continue;
+      auto& stats = Stats[shard.FirstSlot + i];
+      stats.PacketsSent.store(enet_peer_get_packets_sent(peer),
+                              std::memory_order_relaxed);
+      stats.PacketsLost.store(enet_peer_get_packets_lost(peer),
+                              std::memory_order_relaxed);
+      stats.Rtt.store(enet_peer_get_rtt(peer), std::memory_order_relaxed);
+    }
+    shard.BytesSent.store(enet_host_get_bytes_sent(host),
+                          std::memory_order_relaxed);
+    shard.PacketsSent.store(enet_host_get_packets_sent(host),
+                            std::memory_order_relaxed);
+    shard.Peers.store(enet_host_get_peers_count(host),
+                      std::memory_order_relaxed);
+  }
+
+  uint32_t Sum(std::atomic<uint32_t> Shard::*counter) const
+  {
+    auto total = uint32_t();
+    for (const auto& shard : Shards)
+      total += ((*shard).*counter).load(std::memory_order_relaxed);
+    return total;
+  }
+
+  std::vector<std::unique_ptr<Shard>> Shards;
+  std::unique_ptr<NetPeerStats[]> Stats;
+  std::atomic<bool> Stopping = false;
+  bool Threaded = false;
+  bool Batched = false;
+};
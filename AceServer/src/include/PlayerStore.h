@@ -0,0 +1,189 @@
+#pragma once
+
+#include "NetShards.h"
+#include "Protocol.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef ACE_WITH_JSBSIM
+class FlightModel;
+#endif
+
+// Player index in the low 16 bits, generation of the slot in the high ones.
+// Generations start at 1 so that a valid handle is never 0, which is what a
+// peer slot without a player maps to
+struct PlayerHandle
+{
+  uint32_t Value = 0;
+
+  uint16_t Index() const { return static_cast<uint16_t>(Value); }
+  uint16_t Generation() const { return static_cast<uint16_t>(Value >> 16); }
+};
+
+// Per connection state, only touched by the events and by the one job that
+// serves the client each tick
+struct PlayerConnection
+{
+  NetPeerId Peer;
+  std::string Name;
+  uint32_t AckTickIndex = 0;
+  uint32_t LastReceivedInputIndex = 0;
+  uint32_t NextFireTickIndex = 0;
+  uint32_t NextLaunchTickIndex = 0;
+  SnapshotHistory SentSnapshots;
+  RingBuffer<PlayerInput, INPUT_BUFFER_CAPACITY, RingOverflow::Coalesce>
+    InputBuffer;
+  float InputBufferAdvancement = 0;
+
+  // Last ping since the previous tick, answered with the tick's packets
+  uint32_t PingClientTime = 0;
+  double PingReceiveTick = 0;
+  bool PingPending = false;
+
+  // Snapshot priority accumulators by player index, and the snapshot byte
+  // budget adapted to the loss and round trip time of the peer
+  std::vector<float> Priorities;
+  size_t SnapshotBudget = 0;
+  uint32_t BudgetTickIndex = 0;
+  uint32_t MinRtt = 0;
+  uint64_t PacketsSent = 0;
+  uint32_t PacketsLost = 0;
+};
+
+// Connected players. The components read by the physics, the snapshots and
+// the interest queries are dense arrays of the live players only, sorted by
+// player index so that snapshots come out in order. Connections are indexed
+// by player index and hold everything else. Peer slots map to the handle of
+// their player: events find their player without a search, and a handle kept
+// from a previous connection on the same index no longer resolves
+class PlayerStore
+{
+public:
+  static constexpr auto NoDense = static_cast<uint16_t>(-1);
+
+  // Takes the lowest free index like clients expect, indices stay small
+  PlayerHandle Create(NetPeerId peer)
+  {
+    auto index = uint16_t();
+    while (index < Connections.size() && Connections[index].Peer.Value != 0)
+      index++;
+    if (index == Connections.size()) {
+      Connections.emplace_back();
+      Generations.push_back(1);
+      DenseIndices.push_back(NoDense);
+    }
+    Connections[index] = PlayerConnection();
+    Connections[index].Peer = peer;
+
+    auto dense = static_cast<size_t>(
+      std::lower_bound(Indices.begin(), Indices.end(), index) -
+      Indices.begin());
+    Indices.insert(Indices.begin() + dense, index);
+    Positions.insert(Positions.begin() + dense, StartPos);
+    Rotations.insert(Rotations.begin() + dense, Vector3());
+    Velocities.insert(Velocities.begin() + dense, Vector3());
+    LastInputs.insert(LastInputs.begin() + dense, PlayerInput());
+#ifdef ACE_WITH_JSBSIM
+    Aircraft.insert(Aircraft.begin() + dense, nullptr);
+#endif
+    Reindex(dense);
+
+    auto handle = PlayerHandle{ index | uint32_t(Generations[index]) << 16 };
+    if (peer.Slot() >= PeerHandles.size())
+      PeerHandles.resize(peer.Slot() + 1);
+    PeerHandles[peer.Slot()] = handle;
+    return handle;
+  }
+
+  // The generation is bumped so that every copy of the handle goes stale
+  void Destroy(PlayerHandle handle)
+  {
+    if (!IsValid(handle))
+      return;
+    auto index = handle.Index();
+    PeerHandles[Connections[index].Peer.Slot()] = PlayerHandle();
+    Connections[index].Peer = NetPeerId();
+    if (++Generations[index] == 0)
+      Generations[index] = 1;
+
+    auto dense = DenseIndices[index];
+    Indices.erase(Indices.begin() + dense);
+    Positions.erase(Positions.begin() + dense);
+    Rotations.erase(Rotations.begin() + dense);
+    Velocities.erase(Velocities.begin() + dense);
+    LastInputs.erase(LastInputs.begin() + dense);
+#ifdef ACE_WITH_JSBSIM
+    Aircraft.erase(Aircraft.begin() + dense);
+#endif
+    DenseIndices[index] = NoDense;
+    Reindex(dense);
+  }
+
+  // Invalid once the player left, and for a later session on the same slot
+  PlayerHandle FromPeer(NetPeerId peer) const
+  {
+    if (peer.Slot() >= PeerHandles.size())
+      return PlayerHandle();
+    auto handle = PeerHandles[peer.Slot()];
+    if (!IsValid(handle) ||
+        Connections[handle.Index()].Peer.Value != peer.Value)
+      return PlayerHandle();
+    return handle;
+  }
+
+  bool IsValid(PlayerHandle handle) const
+  {
+    auto index = handle.Index();
+    return index < Generations.size() &&
+           Generations[index] == handle.Generation() &&
+           Connections[index].Peer.Value != 0;
+  }
+
+  // Position of a valid handle in the dense arrays
+  size_t Dense(PlayerHandle handle) const
+  {
+    return DenseIndices[handle.Index()];
+  }
+
+  // Position of a live player index in the dense arrays, NoDense otherwise
+  uint16_t DenseOf(uint16_t index) const
+  {
+    return index < DenseIndices.size() ? DenseIndices[index] : NoDense;
+  }
+
+  size_t Size() const { return Indices.size(); }
+
+  PlayerConnection& Connection(size_t dense)
+  {
+    return Connections[Indices[dense]];
+  }
+  const PlayerConnection& Connection(size_t dense) const
+  {
+    return Connections[Indices[dense]];
+  }
+
+  std::vector<uint16_t> Indices;
+  std::vector<Vector3> Positions;
+  std::vector<Vector3> Rotations;
+  // Units per tick over the last tick
+  std::vector<Vector3> Velocities;
+  std::vector<PlayerInput> LastInputs;
+#ifdef ACE_WITH_JSBSIM
+  std::vector<FlightModel*> Aircraft;
+#endif
+
+  std::vector<PlayerConnection> Connections;
+
+private:
+  void Reindex(size_t from)
+  {
+    for (auto dense = from; dense < Indices.size(); dense++)
+      DenseIndices[Indices[dense]] = static_cast<uint16_t>(dense);
+  }
+
+  std::vector<uint16_t> Generations;
+  std::vector<uint16_t> DenseIndices;
+  std::vector<PlayerHandle> PeerHandles;
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "LagCompensation.h"
+#include "Protocol.h"
+#include "math/capsule.hpp"
+#include "math/ray.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+constexpr auto PROJECTILE_CELL_SIZE = 8192.f;
+constexpr auto PROJECTILE_INTERVAL_TICKS = 3;
+// Spawned ahead of the shooter's hit capsule
+constexpr auto PROJECTILE_SPAWN_OFFSET = HIT_CAPSULE_LENGTH;
+
+struct ProjectileHit
+{
+  uint32_t Id = 0;
+  uint16_t OwnerIndex = 0;
+  uint16_t TargetIndex = 0;
+};
+
+// Horizontal cells to the hit capsules overlapping them, rebuilt every tick.
+// Entries are sorted by cell so that each cell is a range of one array, found
+// through an open addressing table kept under half full: a projectile far
+// from every player costs a probe or two and no pointer chasing
+class CapsuleHash
+{
+public:
+  // Inline floor, without SSE4.1 std::floor is a libm call and this runs
+  // several times per projectile
+  static int32_t CellCoord(float value)
+  {
+    auto scaled = value / PROJECTILE_CELL_SIZE;
+    auto truncated = static_cast<int32_t>(scaled);
+    return truncated - (scaled < truncated);
+  }
+
+  void Build(const std::vector<HitCapsule>& capsules)
+  {
+    Capsules = &capsules;
+    Entries.clear();
+    for (auto slot = size_t(); slot < capsules.size(); slot++) {
+      const auto& shape = capsules[slot].Shape;
+      auto minX =
+        CellCoord(std::min(shape.start.x, shape.end.x) - shape.radius);
+      auto maxX =
+        CellCoord(std::max(shape.start.x, shape.end.x) + shape.radius);
+      auto minY =
+        CellCoord(std::min(shape.start.y, shape.end.y) - shape.radius);
+      auto maxY =
+        CellCoord(std::max(shape.start.y, shape.end.y) + shape.radius);
+      for (auto x = minX; x <= maxX; x++)
+        for (auto y = minY; y <= maxY; y++)
+          Entries.push_back({ HitFrame::CellKey(x, y),
+                              static_cast<uint16_t>(slot) });
+    }
+    std::sort(Entries.begin(), Entries.end(), [](const auto& a, const auto& b) {
+      return a.Key < b.Key;
+    });
+
+    auto size = std::bit_ceil(std::max<size_t>(Entries.size() * 2, 16));
+    Buckets.assign(size, Bucket());
+    Mask = size - 1;
+    for (auto begin = size_t(); begin < Entries.size();) {
+      auto end = begin + 1;
+      while (end < Entries.size() && Entries[end].Key == Entries[begin].Key)
+        end++;
+      auto index = Hash(Entries[begin].Key);
+      while (Buckets[index].End != 0)
+        index = (index + 1) & Mask;
+      Buckets[index] = { Entries[begin].Key,
+                         static_cast<uint32_t>(begin),
+                         static_cast<uint32_t>(end) };
+      begin = end;
+    }
+  }
+
+  template<typename F>
+  void Query(int32_t x, int32_t y, F&& callback) const
+  {
+    auto key = HitFrame::CellKey(x, y);
+    for (auto index = Hash(key); Buckets[index].End != 0;
+         index = (index + 1) & Mask)
+      if (Buckets[index].Key == key) {
+        for (auto i = Buckets[index].Begin; i < Buckets[index].End; i++)
+          callback((*Capsules)[Entries[i].Slot]);
+        return;
+      }
+  }
+
+private:
+  struct Entry
+  {
+    uint64_t Key;
+    uint16_t Slot;
+  };
+
+  // End is 0 for an empty bucket, a used one always holds an entry
+  struct Bucket
+  {
+    uint64_t Key = 0;
+    uint32_t Begin = 0;
+    uint32_t End = 0;
+  };
+
+  size_t Hash(uint64_t key) const
+  {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & Mask;
+  }
+
+  const std::vector<HitCapsule>* Capsules = nullptr;
+  std::vector<Entry> Entries;
+  std::vector<Bucket> Buckets = std::vector<Bucket>(1);
+  size_t Mask = 0;
+};
+
+// Live projectiles stored by component. Step() first integrates every
+// projectile in a loop the compiler vectorizes, then sweeps the segment each
+// one covered this tick against the hit capsules of its cells, then compacts
+// the arrays. Only Spawns are replicated, clients extrapolate the rest with
+// ProjectilePosition
+class ProjectileSystem
+{
+public:
+  const ProjectileSpawn& Spawn(uint16_t ownerIndex,
+                               const Vector3& position,
+                               const Vector3& velocity)
+  {
+    auto& spawn = Spawns.emplace_back();
+    spawn.Id = NextId++;
+    spawn.OwnerIndex = ownerIndex;
+    spawn.Position = QuantizedVector3::FromVector3(position);
+    spawn.Velocity = velocity;
+
+    // Starts from the quantized position the clients receive
+    auto start = spawn.Position.ToVector3();
+    X.push_back(start.x);
+    Y.push_back(start.y);
+    Z.push_back(start.z);
+    VX.push_back(velocity.x);
+    VY.push_back(velocity.y);
+    VZ.push_back(velocity.z);
+    Lifetimes.push_back(PROJECTILE_LIFETIME_TICKS);
+    Owners.push_back(ownerIndex);
+    Ids.push_back(spawn.Id);
+    return spawn;
+  }
+
+  void Step(const std::vector<HitCapsule>& capsules)
+  {
+    constexpr auto dt = NET_TICK / 1000.f;
+    auto count = X.size();
+    Hits.clear();
+    Grid.Build(capsules);
+
+    for (auto i = size_t(); i < count; i++) {
+      VZ[i] -= PROJECTILE_GRAVITY * dt;
+      X[i] += VX[i] * dt;
+      Y[i] += VY[i] * dt;
+      Z[i] += VZ[i] * dt;
+      Lifetimes[i]--;
+    }
+
+    if (!capsules.empty())
+      for (auto i = size_t(); i < count; i++)
+        Sweep(i, dt);
+
+    auto live = size_t();
+    for (auto i = size_t(); i < count; i++) {
+      if (Lifetimes[i] == 0 || std::abs(X[i]) > MAP_HALF_EXTENT ||
+          std::abs(Y[i]) > MAP_HALF_EXTENT || std::abs(Z[i]) > MAP_HALF_EXTENT)
+        continue;
+      X[live] = X[i];
+      Y[live] = Y[i];
+      Z[live] = Z[i];
+      VX[live] = VX[i];
+      VY[live] = VY[i];
+      VZ[live] = VZ[i];
+      Lifetimes[live] = Lifetimes[i];
+      Owners[live] = Owners[i];
+      Ids[live] = Ids[i];
+      live++;
+    }
+    for (auto* component : { &X, &Y, &Z, &VX, &VY, &VZ })
+      component->resize(live);
+    Lifetimes.resize(live);
+    Owners.resize(live);
+    Ids.resize(live);
+  }
+
+  size_t Size() const { return X.size(); }
+
+  // Filled by Spawn() until the caller clears it, by Step() every tick
+  std::vector<ProjectileSpawn> Spawns;
+  std::vector<ProjectileHit> Hits;
+
+private:
+  // The segment is rebuilt from the end position, the projectile moves far
+  // less than a cell per tick so its bounds span at most 2x2 cells
+  void Sweep(size_t i, float dt)
+  {
+    auto end = Vector3(X[i], Y[i], Z[i]);
+    auto motion = Vector3(VX[i], VY[i], VZ[i]) * dt;
+    auto start = end - motion;
+    auto minX = CapsuleHash::CellCoord(std::min(start.x, end.x));
+    auto maxX = CapsuleHash::CellCoord(std::max(start.x, end.x));
+    auto minY = CapsuleHash::CellCoord(std::min(start.y, end.y));
+    auto maxY = CapsuleHash::CellCoord(std::max(start.y, end.y));
+
+    // Most projectiles are in empty cells, the ray is only built on demand
+    auto length = 0.f;
+    auto ray = Ray(start, motion);
+    auto closest = std::numeric_limits<float>::max();
+    const HitCapsule* target = nullptr;
+    for (auto x = minX; x <= maxX; x++)
+      for (auto y = minY; y <= maxY; y++)
+        Grid.Query(x, y, [&](const HitCapsule& capsule) {
+          if (capsule.PlayerIndex == Owners[i])
+            return;
+          // Every hit capsule has the same size, its bounding sphere rejects
+          // most candidates before the exact test
+          auto center = (capsule.Shape.start + capsule.Shape.end) * .5f;
+          if (Vector3::SegmentDistance(start, end, center) > BoundsSq)
+            return;
+          if (length == 0.f) {
+            length = motion.Length();
+            ray.direction = motion / length;
+          }
+          Vector3 p1, p2, n1, n2;
+          if (!Ray::Intersects(ray, capsule.Shape, p1, p2, n1, n2))
+            return;
+          auto entry = Vector3::DotProduct(p1 - start, ray.direction);
+          auto exit = Vector3::DotProduct(p2 - start, ray.direction);
+          if (exit < 0 || entry > length || entry >= closest)
+            return;
+          closest = std::max(entry, 0.f);
+          target = &capsule;
+        });
+    if (target == nullptr)
+      return;
+
+    Hits.push_back({ Ids[i], Owners[i], target->PlayerIndex });
+    Lifetimes[i] = 0;
+  }
+
+  static constexpr auto Bounds = HIT_CAPSULE_LENGTH * .5f + HIT_CAPSULE_RADIUS;
+  static constexpr auto BoundsSq = Bounds * Bounds;
+
+  CapsuleHash Grid;
+  std::vector<float> X, Y, Z, VX, VY, VZ;
+  std::vector<uint16_t> Lifetimes;
+  std::vector<uint16_t> Owners;
+  std::vector<uint32_t> Ids;
+  uint32_t NextId = 1;
+};
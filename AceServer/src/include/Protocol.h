@@ -3,12 +3,13 @@
 #ifdef SRV
 #include "enet/enet.h"
 #else
-#define htonf
-#define ntohf
 #include <enet6/enet.h>
 #endif
 
+#include "Snapshot.h"
 #include "math/vector3.hpp"
+#include "utils/bit_stream.hpp"
+#include "utils/ring_buffer.hpp"
 #include <cassert>
 #include <cstdint>
 #include <optional>
@@ -20,12 +21,30 @@ constexpr auto NET_PORT = 8888;
 constexpr auto NET_TICK = 1000 / TICK_RATE;
 constexpr auto NET_MAX_WAIT = 1000;
 constexpr auto NET_RETRY_TIME = 100;
-constexpr auto NET_MAX_CLIENTS = 64;
+constexpr auto NET_MAX_CLIENTS = 256;
 constexpr auto NET_CHANNELS = 2;
 constexpr auto NET_TIMEOUT = 1;
+constexpr auto NET_MAX_PACKET_SIZE = 4096;
+// Connect data of a peer that only watches, it is sent the spectator feed and
+// SPECTATOR_PLAYER_INDEX as its game data rather than given a player
+constexpr auto NET_CONNECT_SPECTATOR = 1u;
+constexpr auto SPECTATOR_PLAYER_INDEX = uint16_t(0xFFFF);
+
+constexpr auto POSITION_BITS = BitsRequired(2 * MAP_HALF_EXTENT);
+constexpr auto DELTA_WIDTH_BITS = 5;
+constexpr auto INPUT_AXIS_BITS = 8;
+constexpr auto INPUT_AXIS_STEPS = (1 << (INPUT_AXIS_BITS - 1)) - 1;
+constexpr auto INPUT_DELTA_WIDTH_BITS = 4;
+constexpr auto INPUT_REDUNDANCY = 8;
+
+constexpr auto PROJECTILE_SPEED = 60000.f;
+constexpr auto PROJECTILE_GRAVITY = 980.f;
+constexpr auto PROJECTILE_LIFETIME_TICKS = 3 * TICK_RATE;
 
 constexpr auto TargetInputBufferSize = 5;
-constexpr auto TargetInterpolationBufferSize = 5;
+constexpr auto INPUT_BUFFER_CAPACITY = 32;
+constexpr auto PREDICTED_INPUT_CAPACITY = 128;
+constexpr auto INTERPOLATION_BUFFER_CAPACITY = 32;
 
 const auto StartPos = Vector3(-15000, 0, 5000);
 
@@ -34,7 +53,14 @@ enum class Opcode : uint8_t
   C_PLAYERINPUT,
   S_GAMEDATA,
   S_PLAYERLIST,
-  S_PLAYERPOSITION
+  S_PLAYERPOSITION,
+  S_PLAYERSTATE,
+  C_FIRE,
+  S_HIT,
+  C_LAUNCH,
+  S_PROJECTILESPAWN,
+  C_PING,
+  S_PONG
 };
 
 struct PlayerInput
@@ -46,99 +72,149 @@ struct PlayerInput
   float Throttle = 0;
 };
 
+// Initial state of a projectile. Its position at any later tick only depends
+// on this, see ProjectilePosition, so nothing else is replicated
+struct ProjectileSpawn
+{
+  uint32_t Id = 0;
+  uint16_t OwnerIndex = 0;
+  QuantizedVector3 Position;
+  Vector3 Velocity;
+};
+
+// Client side player, the server keeps its players in a PlayerStore
 struct Player
 {
-  ENetPeer* Peer = nullptr;
   size_t Index = 0;
   std::string Name;
-  PlayerInput LastInput;
-  std::vector<PlayerInput> InputBuffer;
-  float InputBufferAdvancement = 0;
-
   Vector3 Position;
+  Vector3 Rotation;
 };
 
+void
+ComputePhysics(Vector3& position,
+               Vector3& rotation,
+               const PlayerInput& input,
+               float elapsedTime);
 void
 ComputePhysics(Player& player, const PlayerInput& input, float elapsedTime);
+Vector3
+ProjectilePosition(const ProjectileSpawn& spawn, float ticks);
+
+int32_t
+QuantizeAxis(float value);
+float
+DequantizeAxis(int32_t value);
+PlayerInput
+QuantizeInput(const PlayerInput& input);
 
 void
-Serialize_f32(std::vector<uint8_t>& byteArray, float value);
-void
-Serialize_f32(std::vector<uint8_t>& byteArray, size_t offset, float value);
-void
-Serialize_i8(std::vector<uint8_t>& byteArray, int8_t value);
-void
-Serialize_i8(std::vector<uint8_t>& byteArray, size_t offset, int8_t value);
-void
-Serialize_i16(std::vector<uint8_t>& byteArray, int16_t value);
-void
-Serialize_i16(std::vector<uint8_t>& byteArray, size_t offset, int16_t value);
-void
-Serialize_i32(std::vector<uint8_t>& byteArray, int32_t value);
-void
-Serialize_i32(std::vector<uint8_t>& byteArray, size_t offset, int32_t value);
-void
-Serialize_u8(std::vector<uint8_t>& byteArray, uint8_t value);
-void
-Serialize_u8(std::vector<uint8_t>& byteArray, size_t offset, uint8_t value);
-void
-Serialize_u16(std::vector<uint8_t>& byteArray, uint16_t value);
-void
-Serialize_u16(std::vector<uint8_t>& byteArray, size_t offset, uint16_t value);
+Serialize_axis(BitWriter& writer, float value);
 void
-Serialize_u32(std::vector<uint8_t>& byteArray, uint32_t value);
+Serialize_position(BitWriter& writer, const QuantizedVector3& value);
 void
-Serialize_u32(std::vector<uint8_t>& byteArray, size_t offset, uint32_t value);
+Serialize_rotation(BitWriter& writer, const QuantizedRotation& value);
 void
-Serialize_str(std::vector<uint8_t>& byteArray, const std::string& value);
+Serialize_velocity(BitWriter& writer, const QuantizedVelocity& value);
 void
-Serialize_str(std::vector<uint8_t>& byteArray,
-              size_t offset,
-              const std::string& value);
+Serialize_tick(BitWriter& writer, double value);
 
 float
-Unserialize_f32(const std::vector<uint8_t>& byteArray, size_t& offset);
-int8_t
-Unserialize_i8(const std::vector<uint8_t>& byteArray, size_t& offset);
-int16_t
-Unserialize_i16(const std::vector<uint8_t>& byteArray, size_t& offset);
-int32_t
-Unserialize_i32(const std::vector<uint8_t>& byteArray, size_t& offset);
-uint8_t
-Unserialize_u8(const std::vector<uint8_t>& byteArray, size_t& offset);
-uint16_t
-Unserialize_u16(const std::vector<uint8_t>& byteArray, size_t& offset);
-uint32_t
-Unserialize_u32(const std::vector<uint8_t>& byteArray, size_t& offset);
-std::string
-Unserialize_str(const std::vector<uint8_t>& byteArray, size_t& offset);
+Unserialize_axis(BitReader& reader);
+QuantizedVector3
+Unserialize_position(BitReader& reader);
+QuantizedRotation
+Unserialize_rotation(BitReader& reader);
+QuantizedVelocity
+Unserialize_velocity(BitReader& reader);
+double
+Unserialize_tick(BitReader& reader);
 
+// Sent unsequenced once per tick with the last INPUT_REDUNDANCY inputs, oldest
+// first and with consecutive indices, so that a lost datagram is covered by
+// the next one. Inputs after the first are delta encoded on the quantized axes
 struct PlayerInputPacket
 {
-  PlayerInput Input;
+  std::vector<PlayerInput> Inputs;
+  uint32_t AckTickIndex = 0;
 
-  static constexpr Opcode Opcode = Opcode::C_PLAYERINPUT;
-  void Serialize(std::vector<uint8_t>& byteArray) const;
-  static PlayerInputPacket Unserialize(const std::vector<uint8_t>& byteArray,
-                                       size_t& offset);
+  static constexpr ::Opcode Opcode = ::Opcode::C_PLAYERINPUT;
+  void Serialize(BitWriter& writer) const;
+  static PlayerInputPacket Unserialize(BitReader& reader);
 };
 inline void
-PlayerInputPacket::Serialize(std::vector<uint8_t>& byteArray) const
+PlayerInputPacket::Serialize(BitWriter& writer) const
 {
-  Serialize_f32(byteArray, Input.Pitch);
-  Serialize_f32(byteArray, Input.Yaw);
-  Serialize_f32(byteArray, Input.Roll);
-  Serialize_f32(byteArray, Input.Throttle);
+  writer.WriteU32(AckTickIndex);
+  writer.WriteVarUint(Inputs.size());
+  if (Inputs.empty())
+    return;
+
+  const auto& first = Inputs.front();
+  writer.WriteU32(first.Index);
+  Serialize_axis(writer, first.Pitch);
+  Serialize_axis(writer, first.Yaw);
+  Serialize_axis(writer, first.Roll);
+  Serialize_axis(writer, first.Throttle);
+
+  for (auto i = size_t(1); i < Inputs.size(); i++) {
+    const auto& from = Inputs[i - 1];
+    const auto& to = Inputs[i];
+    uint32_t deltas[] = {
+      ZigZagEncode(QuantizeAxis(to.Pitch) - QuantizeAxis(from.Pitch)),
+      ZigZagEncode(QuantizeAxis(to.Yaw) - QuantizeAxis(from.Yaw)),
+      ZigZagEncode(QuantizeAxis(to.Roll) - QuantizeAxis(from.Roll)),
+      ZigZagEncode(QuantizeAxis(to.Throttle) - QuantizeAxis(from.Throttle))
+    };
+    auto mask = 0u;
+    auto maxDelta = 0u;
+    for (auto axis = 0; axis < 4; axis++)
+      if (deltas[axis] != 0) {
+        mask |= 1u << axis;
+        maxDelta = std::max(maxDelta, deltas[axis]);
+      }
+    writer.WriteBits(mask, 4);
+    if (mask == 0)
+      continue;
+    auto width = BitsRequired(maxDelta);
+    writer.WriteBits(width - 1, INPUT_DELTA_WIDTH_BITS);
+    for (auto axis = 0; axis < 4; axis++)
+      if (mask & (1u << axis))
+        writer.WriteBits(deltas[axis], width);
+  }
 }
 inline PlayerInputPacket
-PlayerInputPacket::Unserialize(const std::vector<uint8_t>& byteArray,
-                               size_t& offset)
+PlayerInputPacket::Unserialize(BitReader& reader)
 {
   PlayerInputPacket packet{};
-  packet.Input.Pitch = Unserialize_f32(byteArray, offset);
-  packet.Input.Yaw = Unserialize_f32(byteArray, offset);
-  packet.Input.Roll = Unserialize_f32(byteArray, offset);
-  packet.Input.Throttle = Unserialize_f32(byteArray, offset);
+  packet.AckTickIndex = reader.ReadU32();
+  auto count = reader.ReadVarUint();
+  if (count == 0 || count > INPUT_REDUNDANCY)
+    return packet;
+
+  auto index = reader.ReadU32();
+  int32_t axes[4];
+  for (auto& axis : axes)
+    axis = static_cast<int32_t>(reader.ReadBits(INPUT_AXIS_BITS)) -
+           INPUT_AXIS_STEPS;
+  packet.Inputs.resize(count);
+  for (auto i = size_t(); i < count; i++) {
+    if (i > 0) {
+      auto mask = reader.ReadBits(4);
+      if (mask != 0) {
+        auto width = reader.ReadBits(INPUT_DELTA_WIDTH_BITS) + 1;
+        for (auto axis = 0; axis < 4; axis++)
+          if (mask & (1u << axis))
+            axes[axis] += ZigZagDecode(reader.ReadBits(width));
+      }
+    }
+    auto& input = packet.Inputs[i];
+    input.Index = index + static_cast<uint32_t>(i);
+    input.Pitch = DequantizeAxis(axes[0]);
+    input.Yaw = DequantizeAxis(axes[1]);
+    input.Roll = DequantizeAxis(axes[2]);
+    input.Throttle = DequantizeAxis(axes[3]);
+  }
   return packet;
 }
 
@@ -146,22 +222,20 @@ struct GameDataPacket
 {
   uint16_t PlayerIndex = 0;
 
-  static constexpr Opcode Opcode = Opcode::S_GAMEDATA;
-  void Serialize(std::vector<uint8_t>& byteArray) const;
-  static GameDataPacket Unserialize(const std::vector<uint8_t>& byteArray,
-                                    size_t& offset);
+  static constexpr ::Opcode Opcode = ::Opcode::S_GAMEDATA;
+  void Serialize(BitWriter& writer) const;
+  static GameDataPacket Unserialize(BitReader& reader);
 };
 inline void
-GameDataPacket::Serialize(std::vector<uint8_t>& byteArray) const
+GameDataPacket::Serialize(BitWriter& writer) const
 {
-  Serialize_u16(byteArray, PlayerIndex);
+  writer.WriteVarUint(PlayerIndex);
 }
 inline GameDataPacket
-GameDataPacket::Unserialize(const std::vector<uint8_t>& byteArray,
-                            size_t& offset)
+GameDataPacket::Unserialize(BitReader& reader)
 {
   GameDataPacket packet{};
-  packet.PlayerIndex = Unserialize_u16(byteArray, offset);
+  packet.PlayerIndex = reader.ReadVarUint();
   return packet;
 }
 
@@ -174,288 +248,581 @@ struct PlayerListPacket
   };
   std::vector<Player> Players;
 
-  static constexpr Opcode Opcode = Opcode::S_PLAYERLIST;
-  void Serialize(std::vector<uint8_t>& byteArray) const;
-  static PlayerListPacket Unserialize(const std::vector<uint8_t>& byteArray,
-                                      size_t& offset);
+  static constexpr ::Opcode Opcode = ::Opcode::S_PLAYERLIST;
+  void Serialize(BitWriter& writer) const;
+  static PlayerListPacket Unserialize(BitReader& reader);
 };
 inline void
-PlayerListPacket::Serialize(std::vector<uint8_t>& byteArray) const
+PlayerListPacket::Serialize(BitWriter& writer) const
 {
-  Serialize_u16(byteArray, Players.size());
+  writer.WriteVarUint(Players.size());
   for (const auto& player : Players) {
-    Serialize_str(byteArray, player.Name);
-    Serialize_u16(byteArray, player.Index);
+    writer.WriteString(player.Name);
+    writer.WriteVarUint(player.Index);
   }
 }
 inline PlayerListPacket
-PlayerListPacket::Unserialize(const std::vector<uint8_t>& byteArray,
-                              size_t& offset)
+PlayerListPacket::Unserialize(BitReader& reader)
 {
   PlayerListPacket packet{};
-  packet.Players.resize(Unserialize_u16(byteArray, offset));
+  auto count = reader.ReadVarUint();
+  if (count > reader.GetBytesRemaining())
+    return packet;
+  packet.Players.resize(count);
   for (auto& player : packet.Players) {
-    player.Name = Unserialize_str(byteArray, offset);
-    player.Index = Unserialize_u16(byteArray, offset);
+    player.Name = reader.ReadString();
+    player.Index = reader.ReadVarUint();
   }
   return packet;
 }
 
+// World state shared by every client with the same view and baseline, the
+// receiving player's own entity is included and skipped by the client
 struct PlayersPositionPacket
 {
-  struct PlayerData
-  {
-    uint8_t PlayerIndex = 0;
-    Vector3 Position;
-  };
-  struct CurrentPlayerData
-  {
-    Vector3 Position;
-  };
-
-  std::optional<CurrentPlayerData> CurrentPlayerData;
-  uint32_t LastInputIndex = 0;
   uint32_t TickIndex = 0;
-  std::vector<PlayerData> Players;
+  uint32_t BaselineTickIndex = 0;
+  std::vector<EntityDelta> Players;
+  std::vector<uint16_t> RemovedPlayers;
 
-  static constexpr Opcode Opcode = Opcode::S_PLAYERPOSITION;
-  void Serialize(std::vector<uint8_t>& byteArray) const;
-  static PlayersPositionPacket Unserialize(
-    const std::vector<uint8_t>& byteArray,
-    size_t& offset);
+  static constexpr ::Opcode Opcode = ::Opcode::S_PLAYERPOSITION;
+  void Serialize(BitWriter& writer) const;
+  static PlayersPositionPacket Unserialize(BitReader& reader);
+  static int EntityBits(const EntitySnapshot* base,
+                        const EntitySnapshot& entity);
 };
 inline void
-PlayersPositionPacket::Serialize(std::vector<uint8_t>& byteArray) const
+PlayersPositionPacket::Serialize(BitWriter& writer) const
 {
-  Serialize_u32(byteArray, LastInputIndex);
-  Serialize_u32(byteArray, TickIndex);
-  Serialize_u16(byteArray, Players.size());
+  writer.WriteU32(TickIndex);
+  writer.WriteVarUint(BaselineTickIndex ? TickIndex - BaselineTickIndex : 0);
+
+  writer.WriteVarUint(Players.size());
+  auto previousIndex = uint16_t();
   for (const auto& playerData : Players) {
-    Serialize_u8(byteArray, playerData.PlayerIndex);
-    Serialize_f32(byteArray, playerData.Position.x);
-    Serialize_f32(byteArray, playerData.Position.y);
-    Serialize_f32(byteArray, playerData.Position.z);
+    writer.WriteVarUint(playerData.PlayerIndex - previousIndex);
+    previousIndex = playerData.PlayerIndex;
+
+    writer.WriteBool(playerData.Mask & DELTA_FULL);
+    if (playerData.Mask & DELTA_FULL) {
+      Serialize_position(writer, playerData.Position);
+      Serialize_rotation(writer, playerData.Rotation);
+      Serialize_velocity(writer, playerData.Velocity);
+      continue;
+    }
+
+    writer.WriteBits(playerData.Mask, 3);
+    if (playerData.Mask & (DELTA_X | DELTA_Y | DELTA_Z)) {
+      auto x = ZigZagEncode(playerData.Position.x);
+      auto y = ZigZagEncode(playerData.Position.y);
+      auto z = ZigZagEncode(playerData.Position.z);
+      auto width = BitsRequired(std::max({ x, y, z }));
+      writer.WriteBits(width - 1, DELTA_WIDTH_BITS);
+      if (playerData.Mask & DELTA_X)
+        writer.WriteBits(x, width);
+      if (playerData.Mask & DELTA_Y)
+        writer.WriteBits(y, width);
+      if (playerData.Mask & DELTA_Z)
+        writer.WriteBits(z, width);
+    }
+    writer.WriteBool(playerData.Mask & DELTA_ROTATION);
+    if (playerData.Mask & DELTA_ROTATION)
+      Serialize_rotation(writer, playerData.Rotation);
+    writer.WriteBool(playerData.Mask & DELTA_VELOCITY);
+    if (playerData.Mask & DELTA_VELOCITY) {
+      auto x = ZigZagEncode(playerData.Velocity.x);
+      auto y = ZigZagEncode(playerData.Velocity.y);
+      auto z = ZigZagEncode(playerData.Velocity.z);
+      auto width = BitsRequired(std::max({ x, y, z }));
+      writer.WriteBits(width - 1, DELTA_WIDTH_BITS);
+      writer.WriteBits(x, width);
+      writer.WriteBits(y, width);
+      writer.WriteBits(z, width);
+    }
   }
 
-  Serialize_u8(byteArray, CurrentPlayerData.has_value());
-  if (CurrentPlayerData) {
-    Serialize_f32(byteArray, CurrentPlayerData->Position.x);
-    Serialize_f32(byteArray, CurrentPlayerData->Position.y);
-    Serialize_f32(byteArray, CurrentPlayerData->Position.z);
+  writer.WriteVarUint(RemovedPlayers.size());
+  for (auto playerIndex : RemovedPlayers)
+    writer.WriteVarUint(playerIndex);
+}
+// Upper bound of what Serialize writes for the entity against its baseline,
+// the index is counted in full rather than as the gap from the previous one
+inline int
+PlayersPositionPacket::EntityBits(const EntitySnapshot* base,
+                                  const EntitySnapshot& entity)
+{
+  auto delta = DiffEntity(base, entity);
+  if (delta.Mask == 0)
+    return 0;
+  auto bits = VarUintBits(delta.PlayerIndex) + 1;
+  if (delta.Mask & DELTA_FULL)
+    return bits + 3 * POSITION_BITS + 3 * ROTATION_BITS + 3 * VELOCITY_BITS;
+
+  bits += 3 + 1 + 1;
+  if (delta.Mask & (DELTA_X | DELTA_Y | DELTA_Z)) {
+    auto x = ZigZagEncode(delta.Position.x);
+    auto y = ZigZagEncode(delta.Position.y);
+    auto z = ZigZagEncode(delta.Position.z);
+    auto width = BitsRequired(std::max({ x, y, z }));
+    bits += DELTA_WIDTH_BITS + width * ((delta.Mask & DELTA_X) != 0) +
+            width * ((delta.Mask & DELTA_Y) != 0) +
+            width * ((delta.Mask & DELTA_Z) != 0);
+  }
+  if (delta.Mask & DELTA_ROTATION)
+    bits += 3 * ROTATION_BITS;
+  if (delta.Mask & DELTA_VELOCITY) {
+    auto x = ZigZagEncode(delta.Velocity.x);
+    auto y = ZigZagEncode(delta.Velocity.y);
+    auto z = ZigZagEncode(delta.Velocity.z);
+    bits += DELTA_WIDTH_BITS + 3 * BitsRequired(std::max({ x, y, z }));
   }
+  return bits;
 }
 inline PlayersPositionPacket
-PlayersPositionPacket::Unserialize(const std::vector<uint8_t>& byteArray,
-                                   size_t& offset)
+PlayersPositionPacket::Unserialize(BitReader& reader)
 {
   PlayersPositionPacket packet{};
-  packet.LastInputIndex = Unserialize_u32(byteArray, offset);
-  packet.TickIndex = Unserialize_u32(byteArray, offset);
+  packet.TickIndex = reader.ReadU32();
+  auto baselineDistance = reader.ReadVarUint();
+  if (baselineDistance != 0)
+    packet.BaselineTickIndex = packet.TickIndex - baselineDistance;
 
-  packet.Players.resize(Unserialize_u16(byteArray, offset));
+  auto count = reader.ReadVarUint();
+  if (count > reader.GetBytesRemaining())
+    return packet;
+  packet.Players.resize(count);
+  auto previousIndex = uint16_t();
   for (auto& playerData : packet.Players) {
-    playerData.PlayerIndex = Unserialize_u8(byteArray, offset);
-    playerData.Position.x = Unserialize_f32(byteArray, offset);
-    playerData.Position.y = Unserialize_f32(byteArray, offset);
-    playerData.Position.z = Unserialize_f32(byteArray, offset);
-  }
+    playerData.PlayerIndex = previousIndex + reader.ReadVarUint();
+    previousIndex = playerData.PlayerIndex;
 
-  bool hasCurrentPlayerData = (bool)Unserialize_u8(byteArray, offset);
-  if (hasCurrentPlayerData) {
-    auto& currentPlayerData = packet.CurrentPlayerData.emplace();
-    currentPlayerData.Position.x = Unserialize_f32(byteArray, offset);
-    currentPlayerData.Position.y = Unserialize_f32(byteArray, offset);
-    currentPlayerData.Position.z = Unserialize_f32(byteArray, offset);
+    if (reader.ReadBool()) {
+      playerData.Mask = DELTA_FULL;
+      playerData.Position = Unserialize_position(reader);
+      playerData.Rotation = Unserialize_rotation(reader);
+      playerData.Velocity = Unserialize_velocity(reader);
+      continue;
+    }
+
+    playerData.Mask = reader.ReadBits(3);
+    if (playerData.Mask != 0) {
+      auto width = reader.ReadBits(DELTA_WIDTH_BITS) + 1;
+      if (playerData.Mask & DELTA_X)
+        playerData.Position.x = ZigZagDecode(reader.ReadBits(width));
+      if (playerData.Mask & DELTA_Y)
+        playerData.Position.y = ZigZagDecode(reader.ReadBits(width));
+      if (playerData.Mask & DELTA_Z)
+        playerData.Position.z = ZigZagDecode(reader.ReadBits(width));
+    }
+    if (reader.ReadBool()) {
+      playerData.Mask |= DELTA_ROTATION;
+      playerData.Rotation = Unserialize_rotation(reader);
+    }
+    if (reader.ReadBool()) {
+      playerData.Mask |= DELTA_VELOCITY;
+      auto width = reader.ReadBits(DELTA_WIDTH_BITS) + 1;
+      playerData.Velocity.x = ZigZagDecode(reader.ReadBits(width));
+      playerData.Velocity.y = ZigZagDecode(reader.ReadBits(width));
+      playerData.Velocity.z = ZigZagDecode(reader.ReadBits(width));
+    }
   }
 
+  count = reader.ReadVarUint();
+  if (count > reader.GetBytesRemaining())
+    return packet;
+  packet.RemovedPlayers.resize(count);
+  for (auto& playerIndex : packet.RemovedPlayers)
+    playerIndex = reader.ReadVarUint();
+
   return packet;
 }
 
+// Per client part of the snapshot: input acknowledgement and authoritative
+// state used for reconciliation
+struct PlayerStatePacket
+{
+  struct CurrentPlayerData
+  {
+    Vector3 Position;
+    Vector3 Rotation;
+  };
+
+  std::optional<CurrentPlayerData> CurrentPlayerData;
+  uint32_t LastInputIndex = 0;
+  uint32_t TickIndex = 0;
+
+  static constexpr ::Opcode Opcode = ::Opcode::S_PLAYERSTATE;
+  void Serialize(BitWriter& writer) const;
+  static PlayerStatePacket Unserialize(BitReader& reader);
+};
 inline void
-Serialize_f32(std::vector<uint8_t>& byteArray, float value)
+PlayerStatePacket::Serialize(BitWriter& writer) const
 {
-  size_t offset = byteArray.size();
-  byteArray.resize(offset + sizeof(value));
-  return Serialize_f32(byteArray, offset, value);
+  writer.WriteU32(LastInputIndex);
+  writer.WriteU32(TickIndex);
+  writer.WriteBool(CurrentPlayerData.has_value());
+  if (CurrentPlayerData) {
+    Serialize_position(
+      writer, QuantizedVector3::FromVector3(CurrentPlayerData->Position));
+    Serialize_rotation(
+      writer, QuantizedRotation::FromVector3(CurrentPlayerData->Rotation));
+  }
 }
-inline void
-Serialize_f32(std::vector<uint8_t>& byteArray, size_t offset, float value)
+inline PlayerStatePacket
+PlayerStatePacket::Unserialize(BitReader& reader)
 {
-#ifdef SRV
-  uint32_t v = htonf(value);
-#else
-  float v = NETWORK_ORDERF(value);
-#endif
-  assert(offset + sizeof(v) <= byteArray.size());
-  memcpy(&byteArray[offset], &v, sizeof(v));
+  PlayerStatePacket packet{};
+  packet.LastInputIndex = reader.ReadU32();
+  packet.TickIndex = reader.ReadU32();
+  if (reader.ReadBool()) {
+    auto& currentPlayerData = packet.CurrentPlayerData.emplace();
+    currentPlayerData.Position = Unserialize_position(reader).ToVector3();
+    currentPlayerData.Rotation = Unserialize_rotation(reader).ToVector3();
+  }
+  return packet;
 }
+
+// The shot direction is given by the client, the origin is the shooter's
+// server position. ViewTickIndex and ViewFraction are the snapshots the client
+// was interpolating between when firing, targets are rewound to that time
+struct FirePacket
+{
+  uint32_t ViewTickIndex = 0;
+  float ViewFraction = 0;
+  Vector3 Direction;
+
+  static constexpr ::Opcode Opcode = ::Opcode::C_FIRE;
+  void Serialize(BitWriter& writer) const;
+  static FirePacket Unserialize(BitReader& reader);
+};
 inline void
-Serialize_i8(std::vector<uint8_t>& byteArray, int8_t value)
-{
-  return Serialize_u8(byteArray, static_cast<uint8_t>(value));
+FirePacket::Serialize(BitWriter& writer) const
+{
+  writer.WriteU32(ViewTickIndex);
+  auto fraction = std::lround(std::clamp(ViewFraction, 0.f, 1.f) * 255);
+  writer.WriteU8(static_cast<uint8_t>(fraction));
+  writer.WriteFloat(Direction.x);
+  writer.WriteFloat(Direction.y);
+  writer.WriteFloat(Direction.z);
+}
+inline FirePacket
+FirePacket::Unserialize(BitReader& reader)
+{
+  FirePacket packet{};
+  packet.ViewTickIndex = reader.ReadU32();
+  packet.ViewFraction = reader.ReadU8() / 255.f;
+  packet.Direction.x = reader.ReadFloat();
+  packet.Direction.y = reader.ReadFloat();
+  packet.Direction.z = reader.ReadFloat();
+  return packet;
 }
+
+// ProjectileId is 0 for a hitscan shot
+struct HitPacket
+{
+  uint32_t TickIndex = 0;
+  uint16_t ShooterIndex = 0;
+  uint16_t TargetIndex = 0;
+  uint32_t ProjectileId = 0;
+
+  static constexpr ::Opcode Opcode = ::Opcode::S_HIT;
+  void Serialize(BitWriter& writer) const;
+  static HitPacket Unserialize(BitReader& reader);
+};
 inline void
-Serialize_i8(std::vector<uint8_t>& byteArray, size_t offset, int8_t value)
+HitPacket::Serialize(BitWriter& writer) const
 {
-  return Serialize_u8(byteArray, offset, static_cast<uint8_t>(value));
+  writer.WriteU32(TickIndex);
+  writer.WriteVarUint(ShooterIndex);
+  writer.WriteVarUint(TargetIndex);
+  writer.WriteVarUint(ProjectileId);
 }
-inline void
-Serialize_i16(std::vector<uint8_t>& byteArray, int16_t value)
+inline HitPacket
+HitPacket::Unserialize(BitReader& reader)
 {
-  return Serialize_u16(byteArray, static_cast<uint16_t>(value));
+  HitPacket packet{};
+  packet.TickIndex = reader.ReadU32();
+  packet.ShooterIndex = reader.ReadVarUint();
+  packet.TargetIndex = reader.ReadVarUint();
+  packet.ProjectileId = reader.ReadVarUint();
+  return packet;
 }
+
+// Launches a projectile from the shooter's server position, unlike FirePacket
+// there is no rewind since the projectile is simulated by the server
+struct LaunchPacket
+{
+  Vector3 Direction;
+
+  static constexpr ::Opcode Opcode = ::Opcode::C_LAUNCH;
+  void Serialize(BitWriter& writer) const;
+  static LaunchPacket Unserialize(BitReader& reader);
+};
 inline void
-Serialize_i16(std::vector<uint8_t>& byteArray, size_t offset, int16_t value)
+LaunchPacket::Serialize(BitWriter& writer) const
 {
-  return Serialize_u16(byteArray, offset, static_cast<uint16_t>(value));
+  writer.WriteFloat(Direction.x);
+  writer.WriteFloat(Direction.y);
+  writer.WriteFloat(Direction.z);
 }
-inline void
-Serialize_i32(std::vector<uint8_t>& byteArray, int32_t value)
+inline LaunchPacket
+LaunchPacket::Unserialize(BitReader& reader)
 {
-  return Serialize_u32(byteArray, static_cast<uint32_t>(value));
+  LaunchPacket packet{};
+  packet.Direction.x = reader.ReadFloat();
+  packet.Direction.y = reader.ReadFloat();
+  packet.Direction.z = reader.ReadFloat();
+  return packet;
 }
-inline void
-Serialize_i32(std::vector<uint8_t>& byteArray, size_t offset, int32_t value)
+
+// Projectiles spawned during TickIndex, in increasing id order. Velocities are
+// sent as is so that clients extrapolate from the exact server values
+struct ProjectileSpawnPacket
 {
-  return Serialize_u32(byteArray, offset, static_cast<uint32_t>(value));
+  uint32_t TickIndex = 0;
+  std::vector<ProjectileSpawn> Spawns;
+
+  static constexpr ::Opcode Opcode = ::Opcode::S_PROJECTILESPAWN;
+  void Serialize(BitWriter& writer) const;
+  static ProjectileSpawnPacket Unserialize(BitReader& reader);
+};
+inline void
+ProjectileSpawnPacket::Serialize(BitWriter& writer) const
+{
+  writer.WriteU32(TickIndex);
+  writer.WriteVarUint(Spawns.size());
+  auto previousId = uint32_t();
+  for (const auto& spawn : Spawns) {
+    writer.WriteVarUint(spawn.Id - previousId);
+    previousId = spawn.Id;
+    writer.WriteVarUint(spawn.OwnerIndex);
+    Serialize_position(writer, spawn.Position);
+    writer.WriteFloat(spawn.Velocity.x);
+    writer.WriteFloat(spawn.Velocity.y);
+    writer.WriteFloat(spawn.Velocity.z);
+  }
 }
+inline ProjectileSpawnPacket
+ProjectileSpawnPacket::Unserialize(BitReader& reader)
+{
+  ProjectileSpawnPacket packet{};
+  packet.TickIndex = reader.ReadU32();
+  auto count = reader.ReadVarUint();
+  if (count > reader.GetBytesRemaining())
+    return packet;
+  packet.Spawns.resize(count);
+  auto previousId = uint32_t();
+  for (auto& spawn : packet.Spawns) {
+    spawn.Id = previousId + reader.ReadVarUint();
+    previousId = spawn.Id;
+    spawn.OwnerIndex = reader.ReadVarUint();
+    spawn.Position = Unserialize_position(reader);
+    spawn.Velocity.x = reader.ReadFloat();
+    spawn.Velocity.y = reader.ReadFloat();
+    spawn.Velocity.z = reader.ReadFloat();
+  }
+  return packet;
+}
+
+// Sent unsequenced every CLOCK_PING_INTERVAL_TICKS inputs, ClientTime is a
+// ClockStamp() the pong hands back unchanged
+struct PingPacket
+{
+  uint32_t ClientTime = 0;
+
+  static constexpr ::Opcode Opcode = ::Opcode::C_PING;
+  void Serialize(BitWriter& writer) const;
+  static PingPacket Unserialize(BitReader& reader);
+};
 inline void
-Serialize_u8(std::vector<uint8_t>& byteArray, uint8_t value)
+PingPacket::Serialize(BitWriter& writer) const
 {
-  size_t offset = byteArray.size();
-  byteArray.resize(offset + sizeof(value));
-  return Serialize_u8(byteArray, offset, value);
+  writer.WriteU32(ClientTime);
 }
-inline void
-Serialize_u8(std::vector<uint8_t>& byteArray, size_t offset, uint8_t value)
+inline PingPacket
+PingPacket::Unserialize(BitReader& reader)
 {
-  assert(offset < byteArray.size());
-  byteArray[offset] = value;
+  PingPacket packet{};
+  packet.ClientTime = reader.ReadU32();
+  return packet;
 }
+
+// When the server took the ping and when it sent the answer, on its tick
+// clock: the tick index plus the elapsed fraction of that tick
+struct PongPacket
+{
+  uint32_t ClientTime = 0;
+  double ReceiveTick = 0;
+  double SendTick = 0;
+
+  static constexpr ::Opcode Opcode = ::Opcode::S_PONG;
+  void Serialize(BitWriter& writer) const;
+  static PongPacket Unserialize(BitReader& reader);
+};
 inline void
-Serialize_u16(std::vector<uint8_t>& byteArray, uint16_t value)
+PongPacket::Serialize(BitWriter& writer) const
 {
-  size_t offset = byteArray.size();
-  byteArray.resize(offset + sizeof(value));
-  return Serialize_u16(byteArray, offset, value);
+  writer.WriteU32(ClientTime);
+  Serialize_tick(writer, ReceiveTick);
+  Serialize_tick(writer, SendTick);
 }
-inline void
-Serialize_u16(std::vector<uint8_t>& byteArray, size_t offset, uint16_t value)
+inline PongPacket
+PongPacket::Unserialize(BitReader& reader)
 {
-  value = ENET_HOST_TO_NET_16(value);
-  assert(offset + sizeof(value) <= byteArray.size());
-  memcpy(&byteArray[offset], &value, sizeof(value));
+  PongPacket packet{};
+  packet.ClientTime = reader.ReadU32();
+  packet.ReceiveTick = Unserialize_tick(reader);
+  packet.SendTick = Unserialize_tick(reader);
+  return packet;
 }
-inline void
-Serialize_u32(std::vector<uint8_t>& byteArray, uint32_t value)
+
+inline int32_t
+QuantizeAxis(float value)
 {
-  size_t offset = byteArray.size();
-  byteArray.resize(offset + sizeof(value));
-  return Serialize_u32(byteArray, offset, value);
+  return std::lround(std::clamp(value, -1.f, 1.f) * INPUT_AXIS_STEPS);
 }
-inline void
-Serialize_u32(std::vector<uint8_t>& byteArray, size_t offset, uint32_t value)
+inline float
+DequantizeAxis(int32_t value)
 {
-  value = ENET_HOST_TO_NET_32(value);
-  assert(offset + sizeof(value) <= byteArray.size());
-  memcpy(&byteArray[offset], &value, sizeof(value));
+  value = std::clamp(value, -INPUT_AXIS_STEPS, INPUT_AXIS_STEPS);
+  return value / static_cast<float>(INPUT_AXIS_STEPS);
 }
+inline PlayerInput
+QuantizeInput(const PlayerInput& input)
+{
+  auto quantized = input;
+  quantized.Pitch = DequantizeAxis(QuantizeAxis(input.Pitch));
+  quantized.Yaw = DequantizeAxis(QuantizeAxis(input.Yaw));
+  quantized.Roll = DequantizeAxis(QuantizeAxis(input.Roll));
+  quantized.Throttle = DequantizeAxis(QuantizeAxis(input.Throttle));
+  return quantized;
+}
+
 inline void
-Serialize_str(std::vector<uint8_t>& byteArray, const std::string& value)
+Serialize_axis(BitWriter& writer, float value)
 {
-  size_t offset = byteArray.size();
-  byteArray.resize(offset + sizeof(uint32_t) + value.size());
-  return Serialize_str(byteArray, offset, value);
+  writer.WriteBits(QuantizeAxis(value) + INPUT_AXIS_STEPS, INPUT_AXIS_BITS);
 }
 inline void
-Serialize_str(std::vector<uint8_t>& byteArray,
-              size_t offset,
-              const std::string& value)
+Serialize_position(BitWriter& writer, const QuantizedVector3& value)
 {
-  Serialize_u32(byteArray, offset, static_cast<uint32_t>(value.size()));
-  offset += sizeof(uint32_t);
-  if (!value.empty())
-    memcpy(&byteArray[offset], value.data(), value.size());
+  writer.WriteBits(value.x + MAP_HALF_EXTENT, POSITION_BITS);
+  writer.WriteBits(value.y + MAP_HALF_EXTENT, POSITION_BITS);
+  writer.WriteBits(value.z + MAP_HALF_EXTENT, POSITION_BITS);
 }
-
-inline float
-Unserialize_f32(const std::vector<uint8_t>& byteArray, size_t& offset)
+inline void
+Serialize_rotation(BitWriter& writer, const QuantizedRotation& value)
 {
-#ifdef SRV
-  uint32_t value;
-  memcpy(&value, &byteArray[offset], sizeof(value));
-  float v = ntohf(value);
-#else
-  float value;
-  memcpy(&value, &byteArray[offset], sizeof(value));
-  float v = NETWORK_ORDERF(value);
-#endif
-  offset += sizeof(value);
-  return v;
+  writer.WriteBits(value.roll, ROTATION_BITS);
+  writer.WriteBits(value.pitch, ROTATION_BITS);
+  writer.WriteBits(value.yaw, ROTATION_BITS);
 }
-inline int8_t
-Unserialize_i8(const std::vector<uint8_t>& byteArray, size_t& offset)
+inline void
+Serialize_velocity(BitWriter& writer, const QuantizedVelocity& value)
 {
-  return static_cast<int8_t>(Unserialize_u8(byteArray, offset));
+  writer.WriteBits(value.x + VELOCITY_MAX_STEPS, VELOCITY_BITS);
+  writer.WriteBits(value.y + VELOCITY_MAX_STEPS, VELOCITY_BITS);
+  writer.WriteBits(value.z + VELOCITY_MAX_STEPS, VELOCITY_BITS);
 }
-inline int16_t
-Unserialize_i16(const std::vector<uint8_t>& byteArray, size_t& offset)
+// Whole ticks and 1/65536th of a tick, about a quarter of a microsecond
+inline void
+Serialize_tick(BitWriter& writer, double value)
 {
-  return static_cast<int16_t>(Unserialize_u16(byteArray, offset));
+  auto whole = std::floor(value);
+  auto fraction = std::lround((value - whole) * 65536);
+  writer.WriteU32(static_cast<uint32_t>(whole) + (fraction >> 16));
+  writer.WriteU16(static_cast<uint16_t>(fraction));
 }
-inline int32_t
-Unserialize_i32(const std::vector<uint8_t>& byteArray, size_t& offset)
+
+inline float
+Unserialize_axis(BitReader& reader)
 {
-  return static_cast<int32_t>(Unserialize_u32(byteArray, offset));
+  auto value = static_cast<int32_t>(reader.ReadBits(INPUT_AXIS_BITS));
+  return DequantizeAxis(value - INPUT_AXIS_STEPS);
 }
-inline uint8_t
-Unserialize_u8(const std::vector<uint8_t>& byteArray, size_t& offset)
+inline QuantizedVector3
+Unserialize_position(BitReader& reader)
 {
-  uint8_t value = byteArray[offset];
-  offset += sizeof(value);
+  auto value = QuantizedVector3();
+  value.x = reader.ReadBits(POSITION_BITS) - MAP_HALF_EXTENT;
+  value.y = reader.ReadBits(POSITION_BITS) - MAP_HALF_EXTENT;
+  value.z = reader.ReadBits(POSITION_BITS) - MAP_HALF_EXTENT;
   return value;
 }
-inline uint16_t
-Unserialize_u16(const std::vector<uint8_t>& byteArray, size_t& offset)
+inline QuantizedRotation
+Unserialize_rotation(BitReader& reader)
 {
-  uint16_t value;
-  memcpy(&value, &byteArray[offset], sizeof(value));
-  value = ntohs(value);
-  offset += sizeof(value);
+  auto value = QuantizedRotation();
+  value.roll = reader.ReadBits(ROTATION_BITS);
+  value.pitch = reader.ReadBits(ROTATION_BITS);
+  value.yaw = reader.ReadBits(ROTATION_BITS);
   return value;
 }
-inline uint32_t
-Unserialize_u32(const std::vector<uint8_t>& byteArray, size_t& offset)
+inline QuantizedVelocity
+Unserialize_velocity(BitReader& reader)
 {
-  uint32_t value;
-  memcpy(&value, &byteArray[offset], sizeof(value));
-  value = ntohl(value);
-  offset += sizeof(value);
+  auto value = QuantizedVelocity();
+  value.x = reader.ReadBits(VELOCITY_BITS) - VELOCITY_MAX_STEPS;
+  value.y = reader.ReadBits(VELOCITY_BITS) - VELOCITY_MAX_STEPS;
+  value.z = reader.ReadBits(VELOCITY_BITS) - VELOCITY_MAX_STEPS;
   return value;
 }
-inline std::string
-Unserialize_str(const std::vector<uint8_t>& byteArray, size_t& offset)
+inline double
+Unserialize_tick(BitReader& reader)
 {
-  uint32_t length = Unserialize_u32(byteArray, offset);
-  std::string str(length, ' ');
-  memcpy(&str[0], &byteArray[offset], length);
-  offset += length;
-  return str;
+  auto whole = reader.ReadU32();
+  return whole + reader.ReadU16() / 65536.;
+}
+
+// Opcode and packet into the buffer, which grows until they fit
+template<typename T>
+size_t
+SerializePacket(const T& packet, std::vector<uint8_t>& buffer)
+{
+  while (true) {
+    auto writer = BitWriter(buffer.data(), buffer.size());
+    writer.WriteU8(static_cast<uint8_t>(T::Opcode));
+    packet.Serialize(writer);
+    auto size = writer.Flush();
+    if (!writer.Overflowed())
+      return size;
+    buffer.resize(std::max<size_t>(buffer.size() * 2, NET_MAX_PACKET_SIZE));
+  }
 }
 
 template<typename T>
 ENetPacket*
 BuildPacket(const T& packet, enet_uint32 flags)
 {
-  std::vector<uint8_t> bytes;
-  Serialize_u8(bytes, static_cast<uint8_t>(T::Opcode));
-  packet.Serialize(bytes);
-  return enet_packet_create(bytes.data(), bytes.size(), flags);
+  thread_local auto scratch = std::vector<uint8_t>(NET_MAX_PACKET_SIZE);
+  auto size = SerializePacket(packet, scratch);
+  return enet_packet_create(scratch.data(), size, flags);
+}
+
+inline void
+ComputePhysics(Vector3& position,
+               Vector3& rotation,
+               const PlayerInput& input,
+               float elapsedTime)
+{
+  position.x += 50 * input.Pitch;
+  position.y += 50 * input.Roll;
 }
 
 inline void
 ComputePhysics(Player& player, const PlayerInput& input, float elapsedTime)
 {
-  player.Position.x += 50 * input.Pitch;
-  player.Position.y += 50 * input.Roll;
-}
\ No newline at end of file
+  ComputePhysics(player.Position, player.Rotation, input, elapsedTime);
+}
+
+// Closed form of the server integrator, one semi-implicit Euler step per tick
+// with gravity on Z: after n ticks v = v0 + n g dt and p = p0 + n v0 dt +
+// n (n + 1) / 2 g dt^2. ticks may be fractional to draw between two ticks
+inline Vector3
+ProjectilePosition(const ProjectileSpawn& spawn, float ticks)
+{
+  constexpr auto dt = NET_TICK / 1000.f;
+  auto position = spawn.Position.ToVector3() + spawn.Velocity * (ticks * dt);
+  position.z -= PROJECTILE_GRAVITY * dt * dt * ticks * (ticks + 1) * .5f;
+  return position;
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include "ClockSync.h"
+#include "Compressor.h"
+#include "Metrics.h"
+#include "Protocol.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// The most peers an ENet host takes
+constexpr auto RELAY_MAX_PEERS = ENET_PROTOCOL_MAXIMUM_PEER_ID;
+
+// host, host:port or [IPv6 host]:port, NET_PORT when there is no port
+inline bool
+ParseRelayAddress(const std::string& text, ENetAddress& address)
+{
+  auto host = text;
+  auto port = std::string();
+  auto colon = text.rfind(':');
+  if (!text.empty() && text.front() == '[') {
+    auto bracket = text.find(']');
+    if (bracket == std::string::npos)
+      return false;
+    host = text.substr(1, bracket - 1);
+    if (bracket + 1 < text.size()) {
+      if (text[bracket + 1] != ':')
+        return false;
+      port = text.substr(bracket + 2);
+    }
+  } else if (colon != std::string::npos && text.find(':') == colon) {
+    host = text.substr(0, colon);
+    port = text.substr(colon + 1);
+  }
+
+  address = ENetAddress();
+  if (host.empty() || enet_address_set_host(&address, host.c_str()) < 0)
+    return false;
+  address.port = NET_PORT;
+  if (!port.empty()) {
+    auto value = std::atoi(port.c_str());
+    if (value <= 0 || value > 0xFFFF)
+      return false;
+    address.port = static_cast<enet_uint16>(value);
+  }
+  return true;
+}
+
+// Answers a C_PING on the spot, both of its ticks at tick. False for any other
+// packet
+inline bool
+AnswerPing(ENetPeer* peer, const ENetPacket* packet, double tick)
+{
+  auto reader = BitReader(packet->data, packet->dataLength);
+  if (static_cast<Opcode>(reader.ReadU8()) != Opcode::C_PING)
+    return false;
+  auto ping = PingPacket::Unserialize(reader);
+  if (reader.Overflowed())
+    return false;
+  auto pong = PongPacket();
+  pong.ClientTime = ping.ClientTime;
+  pong.ReceiveTick = tick;
+  pong.SendTick = tick;
+  enet_peer_send(peer, 0, BuildPacket(pong, ENET_PACKET_FLAG_UNSEQUENCED));
+  return true;
+}
+
+// What a spectator joining mid feed is missing, the player list and the world
+// state the next feed packet is encoded against. The feed is a reliable chain
+// of world snapshots each encoded against the previous one, following it
+// packet by packet keeps the state current
+struct SpectatorState
+{
+  std::vector<uint8_t> PlayerList;
+  WorldSnapshot World;
+  WorldSnapshot Next;
+
+  // False for a packet not to forward: the game data is meant for whoever
+  // follows the feed, every peer is sent its own
+  bool Follow(const uint8_t* data, size_t length)
+  {
+    auto reader = BitReader(data, length);
+    auto opcode = static_cast<Opcode>(reader.ReadU8());
+    if (opcode == Opcode::S_GAMEDATA)
+      return false;
+    if (opcode == Opcode::S_PLAYERLIST) {
+      PlayerList.assign(data, data + length);
+      return true;
+    }
+    if (opcode != Opcode::S_PLAYERPOSITION)
+      return true;
+
+    auto positionPacket = PlayersPositionPacket::Unserialize(reader);
+    if (reader.Overflowed())
+      return true;
+    auto baseline = static_cast<const WorldSnapshot*>(nullptr);
+    if (positionPacket.BaselineTickIndex != 0) {
+      // Out of the chain until the next keyframe
+      if (positionPacket.BaselineTickIndex != World.TickIndex) {
+        World = WorldSnapshot();
+        return true;
+      }
+      baseline = &World;
+    }
+    ApplySnapshotDelta(baseline,
+                       positionPacket.Players,
+                       positionPacket.RemovedPlayers,
+                       Next);
+    Next.TickIndex = positionPacket.TickIndex;
+    std::swap(World, Next);
+    return true;
+  }
+
+  // The world state on its own, nullptr before there is one
+  ENetPacket* BuildKeyframe() const
+  {
+    if (World.TickIndex == 0)
+      return nullptr;
+    auto keyframe = PlayersPositionPacket();
+    keyframe.TickIndex = World.TickIndex;
+    EncodeSnapshotDelta(
+      nullptr, World, keyframe.Players, keyframe.RemovedPlayers);
+    return BuildPacket(keyframe, ENET_PACKET_FLAG_RELIABLE);
+  }
+
+  // Without a world state yet the peer syncs on the next keyframe of the feed
+  void Welcome(ENetPeer* peer) const
+  {
+    auto gameDataPacket = GameDataPacket();
+    gameDataPacket.PlayerIndex = SPECTATOR_PLAYER_INDEX;
+    enet_peer_send(
+      peer, 0, BuildPacket(gameDataPacket, ENET_PACKET_FLAG_RELIABLE));
+    if (!PlayerList.empty())
+      enet_peer_send(peer,
+                     0,
+                     enet_packet_create(PlayerList.data(),
+                                        PlayerList.size(),
+                                        ENET_PACKET_FLAG_RELIABLE));
+    if (auto keyframe = BuildKeyframe())
+      enet_peer_send(peer, 0, keyframe);
+  }
+};
+
+// Spectator tier in front of a match server. A relay connects to its upstream,
+// the match server or another relay, as a single spectator and rebroadcasts
+// what it receives to its own peers with enet_host_broadcast, so relays chain
+// into a tree and the match server only ever serves the first level. Packets
+// from upstream are held for the spectator delay before they go out, and
+// followed as they do so that a peer joining mid feed is sent the current
+// state as a keyframe and follows the chain from there. The relay syncs to the
+// tick clock of its upstream the way a client does and answers the pings of
+// its peers itself, on that clock set back by the spectator delay
+class SpectatorRelay
+{
+public:
+  SpectatorRelay() = default;
+  SpectatorRelay(const SpectatorRelay&) = delete;
+  SpectatorRelay& operator=(const SpectatorRelay&) = delete;
+
+  ~SpectatorRelay()
+  {
+    for (const auto& pending : Pending)
+      enet_packet_destroy(pending.Packet);
+    if (Upstream != nullptr)
+      enet_host_destroy(Upstream);
+    if (Host != nullptr)
+      enet_host_destroy(Host);
+  }
+
+  bool Create(const ENetAddress& address,
+              const ENetAddress& upstream,
+              uint64_t delayUs)
+  {
+    UpstreamAddress = upstream;
+    DelayUs = delayUs;
+    Host = enet_host_create(&address, RELAY_MAX_PEERS, NET_CHANNELS, 0, 0);
+    Upstream = enet_host_create(nullptr, 1, NET_CHANNELS, 0, 0);
+    if (Host == nullptr || Upstream == nullptr)
+      return false;
+    auto compressor = DatagramCompressor::Make();
+    enet_host_compress(Host, &compressor);
+    compressor = DatagramCompressor::Make();
+    enet_host_compress(Upstream, &compressor);
+    return Connect();
+  }
+
+  // Upstream is serviced without waiting, a packet waits at most NET_TIMEOUT
+  // on the downstream host to be picked up
+  void Run()
+  {
+    while (true) {
+      auto event = ENetEvent();
+      while (enet_host_service(Upstream, &event, 0) > 0)
+        HandleUpstream(event);
+      auto now = GetMicroseconds();
+      Ping(now);
+      Release(now);
+
+      if (enet_host_service(Host, &event, NET_TIMEOUT) > 0)
+        do
+          HandleDownstream(event);
+        while (enet_host_check_events(Host, &event) > 0);
+    }
+  }
+
+private:
+  struct PendingPacket
+  {
+    uint64_t ReleaseTime = 0;
+    uint8_t Channel = 0;
+    ENetPacket* Packet = nullptr;
+  };
+
+  bool Connect()
+  {
+    return enet_host_connect(
+             Upstream, &UpstreamAddress, NET_CHANNELS, NET_CONNECT_SPECTATOR) !=
+           nullptr;
+  }
+
+  // A lost upstream is reconnected to for as long as the relay runs, the
+  // chain then restarts from the keyframe sent to a new spectator
+  void HandleUpstream(const ENetEvent& event)
+  {
+    switch (event.type) {
+      case ENetEventType::ENET_EVENT_TYPE_CONNECT:
+        std::cout << "Connected to upstream\n";
+        UpstreamPeer = event.peer;
+        Clock = ClockSync();
+        NextPing = 0;
+        break;
+
+      case ENetEventType::ENET_EVENT_TYPE_DISCONNECT:
+      case ENetEventType::ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
+        std::cout << "Disconnected from upstream, reconnecting\n";
+        UpstreamPeer = nullptr;
+        if (!Connect())
+          std::cerr << "Failed to reconnect to upstream\n";
+        break;
+
+      case ENetEventType::ENET_EVENT_TYPE_RECEIVE:
+        if (HandlePong(event.packet)) {
+          enet_packet_destroy(event.packet);
+          break;
+        }
+        Pending.push_back(
+          { GetMicroseconds() + DelayUs, event.channelID, event.packet });
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  // Downstream peers only watch, whatever they send but pings is dropped.
+  // Pings go unanswered until the relay is synchronized itself
+  void HandleDownstream(const ENetEvent& event)
+  {
+    if (event.type == ENetEventType::ENET_EVENT_TYPE_CONNECT)
+      Feed.Welcome(event.peer);
+    else if (event.type == ENetEventType::ENET_EVENT_TYPE_RECEIVE) {
+      if (Clock.IsSynchronized())
+        AnswerPing(event.peer, event.packet, DelayedTick());
+      enet_packet_destroy(event.packet);
+    }
+  }
+
+  void Ping(uint64_t now)
+  {
+    if (UpstreamPeer == nullptr || now < NextPing)
+      return;
+    NextPing = now + CLOCK_PING_INTERVAL_TICKS * NET_TICK * 1000ull;
+    auto ping = PingPacket();
+    ping.ClientTime = ClockStamp(now / 1e6);
+    enet_peer_send(
+      UpstreamPeer, 0, BuildPacket(ping, ENET_PACKET_FLAG_UNSEQUENCED));
+  }
+
+  // Pongs are for the relay, they are not part of the feed
+  bool HandlePong(const ENetPacket* packet)
+  {
+    auto reader = BitReader(packet->data, packet->dataLength);
+    if (static_cast<Opcode>(reader.ReadU8()) != Opcode::S_PONG)
+      return false;
+    auto pong = PongPacket::Unserialize(reader);
+    if (!reader.Overflowed()) {
+      auto now = GetMicroseconds() / 1e6;
+      Clock.AddSample(ClockStampTime(pong.ClientTime, now),
+                      pong.ReceiveTick,
+                      pong.SendTick,
+                      now);
+    }
+    return true;
+  }
+
+  // Upstream tick clock as of the feed going out, what the peers render
+  double DelayedTick() const
+  {
+    auto tick = Clock.ServerTick(GetMicroseconds() / 1e6) -
+                DelayUs / 1e6 * CLOCK_TICKS_PER_SECOND;
+    return std::max(tick, 0.);
+  }
+
+  void Release(uint64_t now)
+  {
+    while (!Pending.empty() && Pending.front().ReleaseTime <= now) {
+      auto pending = Pending.front();
+      Pending.pop_front();
+      auto packet = pending.Packet;
+      if (Feed.Follow(packet->data, packet->dataLength))
+        enet_host_broadcast(Host, pending.Channel, packet);
+      else
+        enet_packet_destroy(packet);
+    }
+  }
+
+  ENetHost* Host = nullptr;
+  ENetHost* Upstream = nullptr;
+  ENetAddress UpstreamAddress = ENetAddress();
+  uint64_t DelayUs = 0;
+  std::deque<PendingPacket> Pending;
+  SpectatorState Feed;
+  ENetPeer* UpstreamPeer = nullptr;
+  ClockSync Clock;
+  uint64_t NextPing = 0;
+};
@@ -0,0 +1,470 @@
+#pragma once
+
+#include "Compressor.h"
+#include "Metrics.h"
+#include "Protocol.h"
+#include "Relay.h"
+#include "TickScheduler.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Recordings grow by whole chunks, the rest of the last one is left sparse
+constexpr auto RECORD_CHUNK_SIZE = size_t(16) << 20;
+// Most frames a seek replays after its keyframe
+constexpr auto RECORD_KEYFRAME_INTERVAL = TICK_RATE;
+constexpr auto RECORD_VERSION = 1u;
+constexpr char RECORD_MAGIC[8] = { 'A', 'C', 'E', 'M', 'A', 'T', 'C', 'H' };
+constexpr char RECORD_INDEX_MAGIC[8] = {
+  'A', 'C', 'E', 'I', 'N', 'D', 'E', 'X'
+};
+
+// Recordings are in host byte order, like the captures
+struct RecordHeader
+{
+  char Magic[8] = {};
+  uint32_t Version = RECORD_VERSION;
+  uint32_t TickRate = TICK_RATE;
+};
+
+// Followed by Length bytes of a protocol packet, Length is never 0
+struct RecordFrameHeader
+{
+  uint32_t TickIndex = 0;
+  uint32_t Length = 0;
+};
+
+// Log offsets of a keyframe and of the player list in effect at that point,
+// an offset of 0 is no frame
+struct RecordKeyframe
+{
+  uint64_t Offset = 0;
+  uint64_t PlayerListOffset = 0;
+  uint32_t TickIndex = 0;
+  uint32_t Reserved = 0;
+};
+
+// File mapped whole into memory, only the pages that are touched are loaded.
+// A file created for writing grows by RECORD_CHUNK_SIZE at a time and is
+// truncated to what was written once closed, until then its tail is zeros.
+// Mapping is only implemented on Linux, elsewhere Create and Open fail
+class MappedFile
+{
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() { Close(); }
+
+  bool Create(const std::string& path)
+  {
+#ifdef __linux__
+    Fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    Writable = true;
+    return Fd >= 0 && Grow(RECORD_CHUNK_SIZE);
+#else
+    return false;
+#endif
+  }
+
+  bool Open(const std::string& path)
+  {
+#ifdef __linux__
+    Fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if (Fd < 0 || fstat(Fd, &status) < 0 || status.st_size <= 0)
+      return false;
+    auto map = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, Fd, 0);
+    if (map == MAP_FAILED)
+      return false;
+    Map = static_cast<uint8_t*>(map);
+    Size = Mapped = static_cast<size_t>(status.st_size);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // Room for length more bytes at the end, nullptr when the file can't grow
+  uint8_t* Extend(size_t length)
+  {
+    if (Size + length > Mapped && !Grow(Size + length))
+      return nullptr;
+    auto out = Map + Size;
+    Size += length;
+    return out;
+  }
+
+  void Close()
+  {
+#ifdef __linux__
+    if (Map != nullptr)
+      munmap(Map, Mapped);
+    if (Fd >= 0) {
+      if (Writable && ftruncate(Fd, static_cast<off_t>(Size)) < 0)
+        std::cerr << "Failed to truncate a recording\n";
+      close(Fd);
+    }
+#endif
+    Fd = -1;
+    Map = nullptr;
+    Mapped = 0;
+    Size = 0;
+    Writable = false;
+  }
+
+  const uint8_t* Data() const { return Map; }
+
+  // Bytes written, the whole file when read
+  size_t GetSize() const { return Size; }
+
+private:
+  // mremap moves the pages rather than the data, a grow costs the same
+  // however long the recording is
+  bool Grow(size_t size)
+  {
+#ifdef __linux__
+    auto mapped = (size + RECORD_CHUNK_SIZE - 1) / RECORD_CHUNK_SIZE *
+                  RECORD_CHUNK_SIZE;
+    if (!Writable || ftruncate(Fd, static_cast<off_t>(mapped)) < 0)
+      return false;
+    auto map = Map == nullptr ? mmap(nullptr,
+                                     mapped,
+                                     PROT_READ | PROT_WRITE,
+                                     MAP_SHARED,
+                                     Fd,
+                                     0)
+                              : mremap(Map, Mapped, mapped, MREMAP_MAYMOVE);
+    if (map == MAP_FAILED)
+      return false;
+    Map = static_cast<uint8_t*>(map);
+    Mapped = mapped;
+    return true;
+#else
+    (void)size;
+    return false;
+#endif
+  }
+
+  int Fd = -1;
+  uint8_t* Map = nullptr;
+  size_t Mapped = 0;
+  size_t Size = 0;
+  bool Writable = false;
+};
+
+// Appends the world state of every tick to a mapped log. A tick is recorded
+// as the world packet against the tick before, every RECORD_KEYFRAME_INTERVAL
+// ticks as a keyframe listed in a mapped index next to the log, at
+// <path>.index. Player lists go in the log as they change. Frames are protocol
+// packets so that a replay sends them as they are. The packet buffers are
+// reused from tick to tick and the write is a memcpy of at most a keyframe,
+// growing the file only remaps it
+class MatchRecorder
+{
+public:
+  bool Create(const std::string& path)
+  {
+    if (!Log.Create(path) || !Index.Create(path + ".index"))
+      return false;
+    auto header = RecordHeader();
+    std::memcpy(header.Magic, RECORD_MAGIC, sizeof(header.Magic));
+    auto indexHeader = RecordHeader();
+    std::memcpy(indexHeader.Magic, RECORD_INDEX_MAGIC, sizeof(header.Magic));
+    return Write(Log, &header, sizeof(header)) &&
+           Write(Index, &indexHeader, sizeof(indexHeader));
+  }
+
+  // previous is the world of the tick before, nullptr makes a keyframe
+  void RecordWorld(const WorldSnapshot* previous, const WorldSnapshot& current)
+  {
+    if (current.TickIndex - KeyframeTickIndex >= RECORD_KEYFRAME_INTERVAL)
+      previous = nullptr;
+    Packet.TickIndex = current.TickIndex;
+    Packet.BaselineTickIndex = previous ? previous->TickIndex : 0;
+    Packet.Players.clear();
+    Packet.RemovedPlayers.clear();
+    EncodeSnapshotDelta(
+      previous, current, Packet.Players, Packet.RemovedPlayers);
+
+    auto offset = Log.GetSize();
+    auto length = SerializePacket(Packet, Buffer);
+    if (!RecordFrame(current.TickIndex, Buffer.data(), length) ||
+        previous != nullptr)
+      return;
+    auto keyframe = RecordKeyframe();
+    keyframe.Offset = offset;
+    keyframe.PlayerListOffset = PlayerListOffset;
+    keyframe.TickIndex = current.TickIndex;
+    if (Write(Index, &keyframe, sizeof(keyframe)))
+      KeyframeTickIndex = current.TickIndex;
+  }
+
+  // Bytes of a player list packet, in effect from the end of the tick
+  void RecordPlayerList(uint32_t tickIndex, const uint8_t* data, size_t length)
+  {
+    auto offset = Log.GetSize();
+    if (RecordFrame(tickIndex, data, length))
+      PlayerListOffset = offset;
+  }
+
+private:
+  bool RecordFrame(uint32_t tickIndex, const uint8_t* data, size_t length)
+  {
+    auto header = RecordFrameHeader{ tickIndex, static_cast<uint32_t>(length) };
+    auto out = Log.Extend(sizeof(header) + length);
+    if (out == nullptr)
+      return false;
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), data, length);
+    return true;
+  }
+
+  static bool Write(MappedFile& file, const void* data, size_t length)
+  {
+    auto out = file.Extend(length);
+    if (out != nullptr)
+      std::memcpy(out, data, length);
+    return out != nullptr;
+  }
+
+  MappedFile Log;
+  MappedFile Index;
+  PlayersPositionPacket Packet;
+  std::vector<uint8_t> Buffer = std::vector<uint8_t>(NET_MAX_PACKET_SIZE);
+  uint64_t PlayerListOffset = 0;
+  uint32_t KeyframeTickIndex = 0;
+};
+
+// A frame of a recording, the bytes of a protocol packet
+struct RecordedFrame
+{
+  uint32_t TickIndex = 0;
+  const uint8_t* Data = nullptr;
+  size_t Length = 0;
+};
+
+// Random access to a recording through its mappings, a match is never read
+// whole. A seek finds the last keyframe at or before the tick by binary search
+// over the index, then follows at most RECORD_KEYFRAME_INTERVAL frames from
+// there. A recording the server did not close ends in zeros, which end the
+// log and the index alike
+class MatchReader
+{
+public:
+  bool Open(const std::string& path)
+  {
+    if (!Log.Open(path) || !Index.Open(path + ".index") ||
+        !HasHeader(Log, RECORD_MAGIC) || !HasHeader(Index, RECORD_INDEX_MAGIC))
+      return false;
+    // Entries then zeros at most, the count is searched for as well
+    auto low = size_t();
+    auto high =
+      (Index.GetSize() - sizeof(RecordHeader)) / sizeof(RecordKeyframe);
+    while (low < high) {
+      auto middle = low + (high - low) / 2;
+      if (Keyframe(middle).Offset != 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+    KeyframeCount = low;
+    return KeyframeCount > 0;
+  }
+
+  // Leaves the state at the tick, or at the first keyframe for a tick before
+  // it, and the cursor on the frames that follow
+  bool Seek(uint32_t tickIndex, SpectatorState& state)
+  {
+    auto low = size_t(1);
+    auto high = KeyframeCount;
+    while (low < high) {
+      auto middle = low + (high - low) / 2;
+      if (Keyframe(middle).TickIndex <= tickIndex)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+    auto keyframe = Keyframe(low - 1);
+
+    state = SpectatorState();
+    auto frame = RecordedFrame();
+    if (keyframe.PlayerListOffset != 0 &&
+        Read(keyframe.PlayerListOffset, frame))
+      state.Follow(frame.Data, frame.Length);
+    Cursor = keyframe.Offset;
+    while (Next(std::max(tickIndex, keyframe.TickIndex), frame))
+      state.Follow(frame.Data, frame.Length);
+    return state.World.TickIndex != 0;
+  }
+
+  // The frame at the cursor if it is of untilTickIndex or earlier
+  bool Next(uint32_t untilTickIndex, RecordedFrame& frame)
+  {
+    if (!Read(Cursor, frame) || frame.TickIndex > untilTickIndex)
+      return false;
+    Cursor += sizeof(RecordFrameHeader) + frame.Length;
+    return true;
+  }
+
+  bool AtEnd() const
+  {
+    auto frame = RecordedFrame();
+    return !Read(Cursor, frame);
+  }
+
+  uint32_t GetFirstTickIndex() const { return Keyframe(0).TickIndex; }
+  uint32_t GetLastKeyframeTickIndex() const
+  {
+    return Keyframe(KeyframeCount - 1).TickIndex;
+  }
+
+private:
+  static bool HasHeader(const MappedFile& file, const char* magic)
+  {
+    auto header = RecordHeader();
+    if (file.GetSize() < sizeof(header))
+      return false;
+    std::memcpy(&header, file.Data(), sizeof(header));
+    return std::memcmp(header.Magic, magic, sizeof(header.Magic)) == 0 &&
+           header.Version == RECORD_VERSION && header.TickRate == TICK_RATE;
+  }
+
+  RecordKeyframe Keyframe(size_t index) const
+  {
+    auto keyframe = RecordKeyframe();
+    std::memcpy(&keyframe,
+                Index.Data() + sizeof(RecordHeader) + index * sizeof(keyframe),
+                sizeof(keyframe));
+    return keyframe;
+  }
+
+  bool Read(uint64_t offset, RecordedFrame& frame) const
+  {
+    auto header = RecordFrameHeader();
+    if (offset < sizeof(RecordHeader) ||
+        offset + sizeof(header) > Log.GetSize())
+      return false;
+    std::memcpy(&header, Log.Data() + offset, sizeof(header));
+    if (header.Length == 0 ||
+        header.Length > Log.GetSize() - offset - sizeof(header))
+      return false;
+    frame.TickIndex = header.TickIndex;
+    frame.Data = Log.Data() + offset + sizeof(header);
+    frame.Length = header.Length;
+    return true;
+  }
+
+  MappedFile Log;
+  MappedFile Index;
+  size_t KeyframeCount = 0;
+  uint64_t Cursor = 0;
+};
+
+// Plays a recording from a tick to its end at the tick rate, to spectators
+// over the normal protocol. Recorded frames are broadcast as they are and a
+// peer that joins is sent the state as a keyframe, like by a relay
+class ReplayPlayer
+{
+public:
+  ReplayPlayer() = default;
+  ReplayPlayer(const ReplayPlayer&) = delete;
+  ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+
+  ~ReplayPlayer()
+  {
+    if (Host != nullptr)
+      enet_host_destroy(Host);
+  }
+
+  bool Create(const ENetAddress& address,
+              const std::string& path,
+              uint32_t fromTickIndex)
+  {
+    Host = enet_host_create(&address, RELAY_MAX_PEERS, NET_CHANNELS, 0, 0);
+    if (Host == nullptr || !Reader.Open(path) ||
+        !Reader.Seek(fromTickIndex, Feed))
+      return false;
+    auto compressor = DatagramCompressor::Make();
+    enet_host_compress(Host, &compressor);
+    TickIndex = Feed.World.TickIndex;
+    TickStart = GetMicroseconds();
+    return true;
+  }
+
+  uint32_t GetTickIndex() const { return TickIndex; }
+
+  // Returns once the recording ended and the peers were let go
+  void Run()
+  {
+    auto scheduler = TickScheduler(Host->socket, NET_TICK * 1000);
+    while (!Reader.AtEnd()) {
+      scheduler.Wait();
+      Service();
+      while (scheduler.NextTick())
+        Play();
+      enet_host_flush(Host);
+    }
+
+    for (auto peer = Host->peers; peer < Host->peers + Host->peerCount; ++peer)
+      if (peer->state == ENET_PEER_STATE_CONNECTED)
+        enet_peer_disconnect_later(peer, 0);
+    auto deadline = GetMicroseconds() + NET_MAX_WAIT * 1000ull;
+    while (Host->connectedPeers > 0 && GetMicroseconds() < deadline)
+      Service(NET_TIMEOUT);
+  }
+
+private:
+  // Peers only watch, whatever they send but pings is dropped. Pings are
+  // answered on the tick clock of the replay, as the match server would
+  void Service(uint32_t timeout = 0)
+  {
+    auto event = ENetEvent();
+    if (enet_host_service(Host, &event, timeout) <= 0)
+      return;
+    do {
+      if (event.type == ENetEventType::ENET_EVENT_TYPE_CONNECT)
+        Feed.Welcome(event.peer);
+      else if (event.type == ENetEventType::ENET_EVENT_TYPE_RECEIVE) {
+        AnswerPing(event.peer, event.packet, TickClock());
+        enet_packet_destroy(event.packet);
+      }
+    } while (enet_host_check_events(Host, &event) > 0);
+  }
+
+  double TickClock() const
+  {
+    auto elapsed = GetMicroseconds() - TickStart;
+    return TickIndex + elapsed / (NET_TICK * 1000.);
+  }
+
+  void Play()
+  {
+    TickIndex++;
+    TickStart = GetMicroseconds();
+    auto frame = RecordedFrame();
+    while (Reader.Next(TickIndex, frame))
+      if (Feed.Follow(frame.Data, frame.Length))
+        enet_host_broadcast(
+          Host,
+          0,
+          enet_packet_create(
+            frame.Data, frame.Length, ENET_PACKET_FLAG_RELIABLE));
+  }
+
+  ENetHost* Host = nullptr;
+  MatchReader Reader;
+  SpectatorState Feed;
+  uint32_t TickIndex = 0;
+  uint64_t TickStart = 0;
+};
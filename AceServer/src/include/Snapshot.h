@@ -0,0 +1,375 @@
+#pragma once
+
+#include "math/vector3.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+constexpr auto SNAPSHOT_HISTORY = 64;
+constexpr auto POSITION_PRECISION = 1.f;
+constexpr auto MAP_HALF_EXTENT = int32_t(1) << 21;
+constexpr auto ROTATION_BITS = 10;
+// Velocities are in units per tick
+constexpr auto VELOCITY_PRECISION = 1.f / 16;
+constexpr auto VELOCITY_BITS = 18;
+constexpr auto VELOCITY_MAX_STEPS = (1 << (VELOCITY_BITS - 1)) - 1;
+// Past the newest snapshot, entities are dead reckoned for a quarter of a
+// second at most and then stop
+constexpr auto EXTRAPOLATION_MAX_TICKS = 15.f;
+
+enum SnapshotDeltaMask : uint8_t
+{
+  DELTA_X = 1 << 0,
+  DELTA_Y = 1 << 1,
+  DELTA_Z = 1 << 2,
+  DELTA_FULL = 1 << 3,
+  DELTA_ROTATION = 1 << 4,
+  DELTA_VELOCITY = 1 << 5
+};
+
+struct QuantizedVector3
+{
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t z = 0;
+
+  static int32_t Quantize(float value)
+  {
+    auto quantized = std::lround(value / POSITION_PRECISION);
+    return static_cast<int32_t>(std::clamp<long>(
+      quantized, -MAP_HALF_EXTENT, MAP_HALF_EXTENT));
+  }
+
+  static QuantizedVector3 FromVector3(const Vector3& vec)
+  {
+    return { Quantize(vec.x), Quantize(vec.y), Quantize(vec.z) };
+  }
+
+  Vector3 ToVector3() const
+  {
+    return Vector3(x * POSITION_PRECISION,
+                   y * POSITION_PRECISION,
+                   z * POSITION_PRECISION);
+  }
+
+  bool operator==(const QuantizedVector3& vec) const
+  {
+    return x == vec.x && y == vec.y && z == vec.z;
+  }
+
+  bool operator!=(const QuantizedVector3& vec) const
+  {
+    return !operator==(vec);
+  }
+};
+
+// Signed steps of VELOCITY_PRECISION on VELOCITY_BITS
+struct QuantizedVelocity
+{
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t z = 0;
+
+  static int32_t Quantize(float value)
+  {
+    auto quantized = std::lround(value / VELOCITY_PRECISION);
+    return static_cast<int32_t>(std::clamp<long>(
+      quantized, -VELOCITY_MAX_STEPS, VELOCITY_MAX_STEPS));
+  }
+
+  static QuantizedVelocity FromVector3(const Vector3& vec)
+  {
+    return { Quantize(vec.x), Quantize(vec.y), Quantize(vec.z) };
+  }
+
+  Vector3 ToVector3() const
+  {
+    return Vector3(x * VELOCITY_PRECISION,
+                   y * VELOCITY_PRECISION,
+                   z * VELOCITY_PRECISION);
+  }
+
+  bool operator==(const QuantizedVelocity& vec) const
+  {
+    return x == vec.x && y == vec.y && z == vec.z;
+  }
+
+  bool operator!=(const QuantizedVelocity& vec) const
+  {
+    return !operator==(vec);
+  }
+};
+
+// Roll, pitch and yaw in degrees wrapped on ROTATION_BITS, rotations are small
+// enough to always be sent whole rather than as a delta
+struct QuantizedRotation
+{
+  uint16_t roll = 0;
+  uint16_t pitch = 0;
+  uint16_t yaw = 0;
+
+  static uint16_t Quantize(float degrees)
+  {
+    auto steps = std::lround(degrees / 360.f * (1 << ROTATION_BITS));
+    return static_cast<uint16_t>(steps & ((1 << ROTATION_BITS) - 1));
+  }
+
+  static float Dequantize(uint16_t value)
+  {
+    auto degrees = value * 360.f / (1 << ROTATION_BITS);
+    return degrees >= 180.f ? degrees - 360.f : degrees;
+  }
+
+  static QuantizedRotation FromVector3(const Vector3& rotation)
+  {
+    return { Quantize(rotation.x), Quantize(rotation.y), Quantize(rotation.z) };
+  }
+
+  Vector3 ToVector3() const
+  {
+    return Vector3(Dequantize(roll), Dequantize(pitch), Dequantize(yaw));
+  }
+
+  bool operator==(const QuantizedRotation& rotation) const
+  {
+    return roll == rotation.roll && pitch == rotation.pitch &&
+           yaw == rotation.yaw;
+  }
+
+  bool operator!=(const QuantizedRotation& rotation) const
+  {
+    return !operator==(rotation);
+  }
+};
+
+struct EntitySnapshot
+{
+  uint16_t PlayerIndex = 0;
+  QuantizedVector3 Position;
+  QuantizedRotation Rotation;
+  QuantizedVelocity Velocity;
+
+  bool operator==(const EntitySnapshot& entity) const
+  {
+    return PlayerIndex == entity.PlayerIndex && Position == entity.Position &&
+           Rotation == entity.Rotation && Velocity == entity.Velocity;
+  }
+};
+
+// Position and velocity are differences to the baseline unless DELTA_FULL
+struct EntityDelta
+{
+  uint16_t PlayerIndex = 0;
+  uint8_t Mask = 0;
+  QuantizedVector3 Position;
+  QuantizedRotation Rotation;
+  QuantizedVelocity Velocity;
+};
+
+// Players are kept sorted by PlayerIndex so that two snapshots can be diffed
+// with a single merge pass
+struct WorldSnapshot
+{
+  uint32_t TickIndex = 0;
+  std::vector<EntitySnapshot> Players;
+
+  const EntitySnapshot* Find(uint16_t playerIndex) const
+  {
+    auto it = std::lower_bound(
+      Players.begin(),
+      Players.end(),
+      playerIndex,
+      [](const auto& p, uint16_t index) { return p.PlayerIndex < index; });
+    if (it == Players.end() || it->PlayerIndex != playerIndex)
+      return nullptr;
+    return &*it;
+  }
+
+  // FNV-1a over the players, used to find identical client views quickly
+  uint64_t Hash() const
+  {
+    auto hash = 14695981039346656037ull;
+    auto mix = [&](uint32_t value) {
+      hash = (hash ^ value) * 1099511628211ull;
+    };
+    for (const auto& player : Players) {
+      mix(player.PlayerIndex);
+      mix(player.Position.x);
+      mix(player.Position.y);
+      mix(player.Position.z);
+      mix(player.Rotation.roll | player.Rotation.pitch << 16);
+      mix(player.Rotation.yaw);
+      mix(player.Velocity.x);
+      mix(player.Velocity.y);
+      mix(player.Velocity.z);
+    }
+    return hash;
+  }
+};
+
+struct SnapshotHistory
+{
+  std::array<WorldSnapshot, SNAPSHOT_HISTORY> Snapshots;
+
+  WorldSnapshot& Push(uint32_t tickIndex)
+  {
+    auto& snapshot = Snapshots[tickIndex % SNAPSHOT_HISTORY];
+    snapshot.TickIndex = tickIndex;
+    snapshot.Players.clear();
+    return snapshot;
+  }
+
+  const WorldSnapshot* Find(uint32_t tickIndex) const
+  {
+    if (tickIndex == 0)
+      return nullptr;
+    const auto& snapshot = Snapshots[tickIndex % SNAPSHOT_HISTORY];
+    return snapshot.TickIndex == tickIndex ? &snapshot : nullptr;
+  }
+};
+
+// Mask is 0 when the entity did not change, it is then left out of the packet
+inline EntityDelta
+DiffEntity(const EntitySnapshot* base, const EntitySnapshot& entity)
+{
+  auto delta = EntityDelta();
+  delta.PlayerIndex = entity.PlayerIndex;
+  if (base == nullptr) {
+    delta.Mask = DELTA_FULL;
+    delta.Position = entity.Position;
+    delta.Rotation = entity.Rotation;
+    delta.Velocity = entity.Velocity;
+    return delta;
+  }
+
+  const auto& from = base->Position;
+  const auto& to = entity.Position;
+  delta.Position = { to.x - from.x, to.y - from.y, to.z - from.z };
+  if (delta.Position.x != 0)
+    delta.Mask |= DELTA_X;
+  if (delta.Position.y != 0)
+    delta.Mask |= DELTA_Y;
+  if (delta.Position.z != 0)
+    delta.Mask |= DELTA_Z;
+  if (base->Rotation != entity.Rotation)
+    delta.Mask |= DELTA_ROTATION;
+  delta.Rotation = entity.Rotation;
+  if (base->Velocity != entity.Velocity)
+    delta.Mask |= DELTA_VELOCITY;
+  delta.Velocity = { entity.Velocity.x - base->Velocity.x,
+                     entity.Velocity.y - base->Velocity.y,
+                     entity.Velocity.z - base->Velocity.z };
+  if (std::abs(delta.Position.x) > MAP_HALF_EXTENT ||
+      std::abs(delta.Position.y) > MAP_HALF_EXTENT ||
+      std::abs(delta.Position.z) > MAP_HALF_EXTENT) {
+    delta.Mask = DELTA_FULL;
+    delta.Position = to;
+    delta.Velocity = entity.Velocity;
+  }
+  return delta;
+}
+
+inline void
+EncodeSnapshotDelta(const WorldSnapshot* baseline,
+                    const WorldSnapshot& current,
+                    std::vector<EntityDelta>& deltas,
+                    std::vector<uint16_t>& removedPlayers)
+{
+  static const auto emptySnapshot = WorldSnapshot();
+  const auto& base = baseline ? *baseline : emptySnapshot;
+
+  auto baseIt = base.Players.begin();
+  for (const auto& player : current.Players) {
+    while (baseIt != base.Players.end() &&
+           baseIt->PlayerIndex < player.PlayerIndex) {
+      removedPlayers.push_back(baseIt->PlayerIndex);
+      ++baseIt;
+    }
+
+    const EntitySnapshot* from = nullptr;
+    if (baseIt != base.Players.end() &&
+        baseIt->PlayerIndex == player.PlayerIndex)
+      from = &*baseIt++;
+    auto delta = DiffEntity(from, player);
+    if (delta.Mask != 0)
+      deltas.push_back(delta);
+  }
+  for (; baseIt != base.Players.end(); ++baseIt)
+    removedPlayers.push_back(baseIt->PlayerIndex);
+}
+
+inline void
+ApplySnapshotDelta(const WorldSnapshot* baseline,
+                   const std::vector<EntityDelta>& deltas,
+                   const std::vector<uint16_t>& removedPlayers,
+                   WorldSnapshot& result)
+{
+  result.Players.clear();
+  if (baseline)
+    for (const auto& player : baseline->Players)
+      if (std::find(removedPlayers.begin(),
+                    removedPlayers.end(),
+                    player.PlayerIndex) == removedPlayers.end())
+        result.Players.push_back(player);
+
+  for (const auto& delta : deltas) {
+    auto it = std::lower_bound(
+      result.Players.begin(),
+      result.Players.end(),
+      delta.PlayerIndex,
+      [](const auto& p, uint16_t index) { return p.PlayerIndex < index; });
+    if (it == result.Players.end() || it->PlayerIndex != delta.PlayerIndex) {
+      it = result.Players.insert(it, EntitySnapshot());
+      it->PlayerIndex = delta.PlayerIndex;
+    }
+    if (delta.Mask & DELTA_FULL) {
+      it->Position = delta.Position;
+      it->Rotation = delta.Rotation;
+      it->Velocity = delta.Velocity;
+      continue;
+    }
+    if (delta.Mask & DELTA_ROTATION)
+      it->Rotation = delta.Rotation;
+    if (delta.Mask & DELTA_VELOCITY) {
+      it->Velocity.x += delta.Velocity.x;
+      it->Velocity.y += delta.Velocity.y;
+      it->Velocity.z += delta.Velocity.z;
+    }
+    if (delta.Mask & DELTA_X)
+      it->Position.x += delta.Position.x;
+    if (delta.Mask & DELTA_Y)
+      it->Position.y += delta.Position.y;
+    if (delta.Mask & DELTA_Z)
+      it->Position.z += delta.Position.z;
+  }
+}
+
+// Cubic Hermite between two states span ticks apart, alpha from 0 to 1. The
+// curve leaves and reaches each state with its velocity, so a turning aircraft
+// follows an arc rather than the chord and there is no kink at each snapshot
+inline Vector3
+HermitePosition(const EntitySnapshot& from,
+                const EntitySnapshot& to,
+                float span,
+                float alpha)
+{
+  auto alpha2 = alpha * alpha;
+  auto alpha3 = alpha2 * alpha;
+  auto h00 = 2 * alpha3 - 3 * alpha2 + 1;
+  auto h10 = alpha3 - 2 * alpha2 + alpha;
+  auto h01 = -2 * alpha3 + 3 * alpha2;
+  auto h11 = alpha3 - alpha2;
+  return from.Position.ToVector3() * h00 +
+         from.Velocity.ToVector3() * (h10 * span) +
+         to.Position.ToVector3() * h01 + to.Velocity.ToVector3() * (h11 * span);
+}
+
+// Dead reckoning ticks past a state, bounded by EXTRAPOLATION_MAX_TICKS
+inline Vector3
+ExtrapolatePosition(const EntitySnapshot& entity, float ticks)
+{
+  ticks = std::clamp(ticks, 0.f, EXTRAPOLATION_MAX_TICKS);
+  return entity.Position.ToVector3() + entity.Velocity.ToVector3() * ticks;
+}
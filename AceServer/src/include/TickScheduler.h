@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Metrics.h"
+#include "enet/enet.h"
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+constexpr auto TICK_MAX_CATCH_UP = 4;
+
+// Fixed timestep scheduler. Wait() sleeps until the socket is readable or the
+// next tick is due, on Linux with epoll and a timerfd armed on the absolute
+// deadline, elsewhere with enet_socket_wait rounded up to the millisecond.
+// Deadlines advance by exactly one period per tick so that there is no drift,
+// after a stall at most TICK_MAX_CATCH_UP late ticks run back to back and the
+// rest of the backlog is skipped. Without a socket, ENET_SOCKET_NULL, Wait()
+// only waits for the next tick
+class TickScheduler
+{
+public:
+  TickScheduler(ENetSocket socket, uint64_t periodUs)
+    : Socket(socket)
+    , PeriodUs(periodUs)
+    , NextDeadline(GetMicroseconds())
+  {
+#ifdef __linux__
+    Epoll = epoll_create1(EPOLL_CLOEXEC);
+    TimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    auto socketEvent = epoll_event{ EPOLLIN, { .fd = Socket } };
+    auto timerEvent = epoll_event{ EPOLLIN, { .fd = TimerFd } };
+    if (Epoll < 0 || TimerFd < 0 ||
+        (Socket != ENET_SOCKET_NULL &&
+         epoll_ctl(Epoll, EPOLL_CTL_ADD, Socket, &socketEvent) < 0) ||
+        epoll_ctl(Epoll, EPOLL_CTL_ADD, TimerFd, &timerEvent) < 0)
+      CloseEpoll();
+#endif
+  }
+
+  TickScheduler(const TickScheduler&) = delete;
+  TickScheduler& operator=(const TickScheduler&) = delete;
+
+  ~TickScheduler()
+  {
+#ifdef __linux__
+    CloseEpoll();
+#endif
+  }
+
+  bool UsesEpoll() const
+  {
+#ifdef __linux__
+    return Epoll >= 0;
+#else
+    return false;
+#endif
+  }
+
+  void Wait()
+  {
+    auto now = GetMicroseconds();
+    if (now >= NextDeadline)
+      return;
+
+#ifdef __linux__
+    if (Epoll >= 0) {
+      if (ArmedDeadline != NextDeadline) {
+        auto spec = itimerspec();
+        spec.it_value.tv_sec = NextDeadline / 1000000;
+        spec.it_value.tv_nsec = NextDeadline % 1000000 * 1000;
+        timerfd_settime(TimerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+        ArmedDeadline = NextDeadline;
+      }
+      epoll_event events[2];
+      auto count = epoll_wait(Epoll, events, 2, -1);
+      for (auto i = 0; i < count; i++)
+        if (events[i].data.fd == TimerFd) {
+          auto expirations = uint64_t();
+          if (read(TimerFd, &expirations, sizeof(expirations)) < 0)
+            continue;
+        }
+      return;
+    }
+#endif
+
+    if (Socket == ENET_SOCKET_NULL) {
+      std::this_thread::sleep_for(
+        std::chrono::microseconds(NextDeadline - now));
+      return;
+    }
+    auto condition =
+      static_cast<enet_uint32>(ENET_SOCKET_WAIT_RECEIVE |
+                               ENET_SOCKET_WAIT_INTERRUPT);
+    enet_socket_wait(Socket, &condition, (NextDeadline - now + 999) / 1000);
+  }
+
+  // Returns true while a tick is due, Lateness then holds how late it starts
+  bool NextTick()
+  {
+    auto now = GetMicroseconds();
+    if (now < NextDeadline) {
+      CatchUp = 0;
+      return false;
+    }
+    if (CatchUp >= TICK_MAX_CATCH_UP) {
+      auto missed = (now - NextDeadline) / PeriodUs + 1;
+      SkippedTicks += missed;
+      NextDeadline += missed * PeriodUs;
+      CatchUp = 0;
+      return false;
+    }
+    Lateness = now - NextDeadline;
+    NextDeadline += PeriodUs;
+    CatchUp++;
+    return true;
+  }
+
+  uint64_t Lateness = 0;
+  uint64_t SkippedTicks = 0;
+
+private:
+#ifdef __linux__
+  void CloseEpoll()
+  {
+    if (Epoll >= 0)
+      close(Epoll);
+    if (TimerFd >= 0)
+      close(TimerFd);
+    Epoll = -1;
+    TimerFd = -1;
+  }
+
+  int Epoll = -1;
+  int TimerFd = -1;
+  uint64_t ArmedDeadline = 0;
+#endif
+
+  ENetSocket Socket;
+  uint64_t PeriodUs;
+  uint64_t NextDeadline;
+  unsigned CatchUp = 0;
+};
@@ -205,6 +205,13 @@
 #define ENET_BUFFER_MAXIMUM (1 + 2 * ENET_PROTOCOL_MAXIMUM_PACKET_COMMANDS)
 #endif
 
+/* recvmmsg/sendmmsg are Linux only and declared by glibc under _GNU_SOURCE */
+#if defined(__linux__) && defined(_GNU_SOURCE)
+#define ENET_HAS_MMSG 1
+#endif
+
+#define ENET_HOST_BATCH_MAXIMUM 64
+
 #define ENET_UNUSED(x) (void)x;
 
 #define ENET_MAX(x, y) ((x) > (y) ? (x) : (y))
@@ -492,6 +499,7 @@ extern "C" {
         ENET_SOCKOPT_ERROR     = 8,
         ENET_SOCKOPT_NODELAY   = 9,
         ENET_SOCKOPT_IPV6_V6ONLY = 10,
+        ENET_SOCKOPT_REUSEPORT = 11,
     } ENetSocketOption;
 
     typedef enum _ENetSocketShutdown {
@@ -792,6 +800,7 @@ extern "C" {
         size_t                duplicatePeers;     /**< optional number of allowed peers from duplicate IPs, defaults to ENET_PROTOCOL_MAXIMUM_PEER_ID */
         size_t                maximumPacketSize;  /**< the maximum allowable packet size that may be sent or received on a peer */
         size_t                maximumWaitingData; /**< the maximum aggregate amount of buffer space a peer may use waiting for packets to be delivered */
+        struct _ENetHostBatch * batch;            /**< batched datagram I/O state, NULL unless enabled with enet_host_set_batching */
     } ENetHost;
 
     /**
@@ -980,6 +989,7 @@ extern "C" {
     ENET_API enet_uint32  enet_crc32(const ENetBuffer *, size_t);
 
     ENET_API ENetHost * enet_host_create(const ENetAddress *, size_t, size_t, enet_uint32, enet_uint32);
+    ENET_API ENetHost * enet_host_create_shared(const ENetAddress *, size_t, size_t, enet_uint32, enet_uint32);
     ENET_API void       enet_host_destroy(ENetHost *);
     ENET_API ENetPeer * enet_host_connect(ENetHost *, const ENetAddress *, size_t, enet_uint32);
     ENET_API int        enet_host_check_events(ENetHost *, ENetEvent *);
@@ -990,6 +1000,7 @@ extern "C" {
     ENET_API void       enet_host_flush(ENetHost *);
     ENET_API void       enet_host_broadcast(ENetHost *, enet_uint8, ENetPacket *);    
     ENET_API void       enet_host_compress(ENetHost *, const ENetCompressor *);
+    ENET_API int        enet_host_set_batching(ENetHost *, size_t);
     ENET_API void       enet_host_channel_limit(ENetHost *, size_t);
     ENET_API void       enet_host_bandwidth_limit(ENetHost *, enet_uint32, enet_uint32);
     extern   void       enet_host_bandwidth_throttle(ENetHost *);
@@ -2677,6 +2688,156 @@ extern "C" {
         return 0;
     } /* enet_protocol_handle_incoming_commands */
 
+#ifdef ENET_HAS_MMSG
+    /** Datagrams received by one recvmmsg call are handed out one at a time,
+     *  outgoing datagrams are copied in and sent by one sendmmsg call. */
+    typedef struct _ENetHostBatch {
+        size_t              capacity;
+        size_t              receivedCount;
+        size_t              receivedIndex;
+        size_t              sendCount;
+        struct mmsghdr      receiveHeaders[ENET_HOST_BATCH_MAXIMUM];
+        struct iovec        receiveVectors[ENET_HOST_BATCH_MAXIMUM];
+        struct sockaddr_in6 receiveAddresses[ENET_HOST_BATCH_MAXIMUM];
+        enet_uint8          receiveData[ENET_HOST_BATCH_MAXIMUM][ENET_PROTOCOL_MAXIMUM_MTU];
+        struct mmsghdr      sendHeaders[ENET_HOST_BATCH_MAXIMUM];
+        struct iovec        sendVectors[ENET_HOST_BATCH_MAXIMUM];
+        struct sockaddr_in6 sendAddresses[ENET_HOST_BATCH_MAXIMUM];
+        enet_uint8          sendData[ENET_HOST_BATCH_MAXIMUM][ENET_PROTOCOL_MAXIMUM_MTU];
+    } ENetHostBatch;
+
+    static int enet_protocol_receive_batch(ENetHost *host) {
+        ENetHostBatch *batch = host->batch;
+        struct sockaddr_in6 *sin;
+        struct mmsghdr *header;
+        size_t i;
+        int count;
+
+        if (batch->receivedIndex >= batch->receivedCount) {
+            for (i = 0; i < batch->capacity; ++i) {
+                batch->receiveVectors[i].iov_base = batch->receiveData[i];
+                batch->receiveVectors[i].iov_len  = host->mtu;
+
+                memset(&batch->receiveHeaders[i], 0, sizeof(struct mmsghdr));
+                batch->receiveHeaders[i].msg_hdr.msg_name    = &batch->receiveAddresses[i];
+                batch->receiveHeaders[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+                batch->receiveHeaders[i].msg_hdr.msg_iov     = &batch->receiveVectors[i];
+                batch->receiveHeaders[i].msg_hdr.msg_iovlen  = 1;
+            }
+
+            count = recvmmsg(host->socket, batch->receiveHeaders, (unsigned int) batch->capacity, 0, NULL);
+            batch->receivedIndex = 0;
+            batch->receivedCount = 0;
+
+            if (count == -1) {
+                if (errno == EWOULDBLOCK) {
+                    return 0;
+                }
+
+                return -1;
+            }
+
+            batch->receivedCount = (size_t) count;
+            if (count == 0) {
+                return 0;
+            }
+        }
+
+        header = &batch->receiveHeaders[batch->receivedIndex];
+        sin    = &batch->receiveAddresses[batch->receivedIndex];
+        host->receivedData = batch->receiveData[batch->receivedIndex];
+        ++batch->receivedIndex;
+
+        if (header->msg_hdr.msg_flags & MSG_TRUNC) {
+            return -1;
+        }
+
+        host->receivedAddress.host          = sin->sin6_addr;
+        host->receivedAddress.port          = ENET_NET_TO_HOST_16(sin->sin6_port);
+        host->receivedAddress.sin6_scope_id = (enet_uint16) sin->sin6_scope_id;
+
+        return (int) header->msg_len;
+    }
+
+    static int enet_protocol_flush_batch(ENetHost *host) {
+        ENetHostBatch *batch = host->batch;
+        size_t sent = 0;
+        int count;
+
+        if (batch == NULL) {
+            return 0;
+        }
+
+        while (sent < batch->sendCount) {
+            count = sendmmsg(host->socket, &batch->sendHeaders[sent], (unsigned int) (batch->sendCount - sent), MSG_NOSIGNAL);
+
+            if (count == -1) {
+                batch->sendCount = 0;
+
+                /* Same as enet_socket_send: a full socket buffer drops the datagrams */
+                return errno == EWOULDBLOCK ? 0 : -1;
+            }
+
+            sent += (size_t) count;
+        }
+
+        batch->sendCount = 0;
+        return 0;
+    }
+
+    static int enet_protocol_queue_batch(ENetHost *host, const ENetAddress *address) {
+        ENetHostBatch *batch = host->batch;
+        struct sockaddr_in6 *sin;
+        struct mmsghdr *header;
+        enet_uint8 *data;
+        size_t i, length = 0;
+
+        if (batch->sendCount >= batch->capacity && enet_protocol_flush_batch(host) < 0) {
+            return -1;
+        }
+
+        /* The buffers point into packets that are released right after sending */
+        data = batch->sendData[batch->sendCount];
+        for (i = 0; i < host->bufferCount; ++i) {
+            if (length + host->buffers[i].dataLength > ENET_PROTOCOL_MAXIMUM_MTU) {
+                return -1;
+            }
+
+            memcpy(data + length, host->buffers[i].data, host->buffers[i].dataLength);
+            length += host->buffers[i].dataLength;
+        }
+
+        sin = &batch->sendAddresses[batch->sendCount];
+        memset(sin, 0, sizeof(struct sockaddr_in6));
+        sin->sin6_family   = AF_INET6;
+        sin->sin6_port     = ENET_HOST_TO_NET_16(address->port);
+        sin->sin6_addr     = address->host;
+        sin->sin6_scope_id = address->sin6_scope_id;
+
+        batch->sendVectors[batch->sendCount].iov_base = data;
+        batch->sendVectors[batch->sendCount].iov_len  = length;
+
+        header = &batch->sendHeaders[batch->sendCount];
+        memset(header, 0, sizeof(struct mmsghdr));
+        header->msg_hdr.msg_name    = sin;
+        header->msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+        header->msg_hdr.msg_iov     = &batch->sendVectors[batch->sendCount];
+        header->msg_hdr.msg_iovlen  = 1;
+
+        ++batch->sendCount;
+        return (int) length;
+    }
+#else
+    typedef struct _ENetHostBatch {
+        size_t capacity;
+    } ENetHostBatch;
+
+    static int enet_protocol_flush_batch(ENetHost *host) {
+        ENET_UNUSED(host)
+        return 0;
+    }
+#endif
+
     static int enet_protocol_receive_incoming_commands(ENetHost *host, ENetEvent *event) {
         int packets;
 
@@ -2684,11 +2845,19 @@ extern "C" {
             int receivedLength;
             ENetBuffer buffer;
 
-            buffer.data       = host->packetData[0];
-            // buffer.dataLength = sizeof (host->packetData[0]);
-            buffer.dataLength = host->mtu;
+            #ifdef ENET_HAS_MMSG
+            if (host->batch != NULL) {
+                receivedLength = enet_protocol_receive_batch(host);
+            } else
+            #endif
+            {
+                buffer.data       = host->packetData[0];
+                // buffer.dataLength = sizeof (host->packetData[0]);
+                buffer.dataLength = host->mtu;
 
-            receivedLength    = enet_socket_receive(host->socket, &host->receivedAddress, &buffer, 1);
+                receivedLength    = enet_socket_receive(host->socket, &host->receivedAddress, &buffer, 1);
+                host->receivedData = host->packetData[0];
+            }
 
             if (receivedLength == -2)
                 continue;
@@ -2701,7 +2870,6 @@ extern "C" {
                 return 0;
             }
 
-            host->receivedData       = host->packetData[0];
             host->receivedDataLength = receivedLength;
 
             host->totalReceivedData += receivedLength;
@@ -3075,7 +3243,8 @@ extern "C" {
                     enet_protocol_check_timeouts(host, currentPeer, event) == 1
                 ) {
                     if (event != NULL && event->type != ENET_EVENT_TYPE_NONE) {
-                        return 1;
+                        host->buffers[0].data = NULL;
+                        return enet_protocol_flush_batch(host) < 0 ? -1 : 1;
                     } else {
                         continue;
                     }
@@ -3171,13 +3340,23 @@ extern "C" {
                 }
 
                 currentPeer->lastSendTime = host->serviceTime;
-                sentLength = enet_socket_send(host->socket, &currentPeer->address, host->buffers, host->bufferCount);
+                #ifdef ENET_HAS_MMSG
+                if (host->batch != NULL) {
+                    sentLength = enet_protocol_queue_batch(host, &currentPeer->address);
+                } else
+                #endif
+                {
+                    sentLength = enet_socket_send(host->socket, &currentPeer->address, host->buffers, host->bufferCount);
+                }
                 enet_protocol_remove_sent_unreliable_commands(currentPeer);
 
                 if (sentLength < 0) {
                     // The local 'headerData' array (to which 'data' is assigned) goes out
                     // of scope on return from this function, so ensure we no longer point to it.
                     host->buffers[0].data = NULL;
+                    if (host->batch != NULL) {
+                        host->batch->sendCount = 0;
+                    }
                     return -1;
                 }
 
@@ -3190,7 +3369,7 @@ extern "C" {
         // of scope on return from this function, so ensure we no longer point to it.
         host->buffers[0].data = NULL;
 
-        return 0;
+        return enet_protocol_flush_batch(host);
     } /* enet_protocol_send_outgoing_commands */
 
     /** Sends any queued packets on the host specified to its designated peers.
@@ -4395,7 +4574,7 @@ extern "C" {
      *  the window size of a connection which limits the amount of reliable packets that may be in transit
      *  at any given time.
      */
-    ENetHost * enet_host_create(const ENetAddress *address, size_t peerCount, size_t channelLimit, enet_uint32 incomingBandwidth, enet_uint32 outgoingBandwidth) {
+    static ENetHost * enet_host_create_socket(const ENetAddress *address, size_t peerCount, size_t channelLimit, enet_uint32 incomingBandwidth, enet_uint32 outgoingBandwidth, int reusePort) {
         ENetHost *host;
         ENetPeer *currentPeer;
 
@@ -4418,6 +4597,12 @@ extern "C" {
         host->socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
         if (host->socket != ENET_SOCKET_NULL) {
             enet_socket_set_option (host->socket, ENET_SOCKOPT_IPV6_V6ONLY, 0);
+
+            /* Has to be set before the bind */
+            if (reusePort && enet_socket_set_option(host->socket, ENET_SOCKOPT_REUSEPORT, 1) < 0) {
+                enet_socket_destroy(host->socket);
+                host->socket = ENET_SOCKET_NULL;
+            }
         }
 
         if (host->socket == ENET_SOCKET_NULL || (address != NULL && enet_socket_bind(host->socket, address) < 0)) {
@@ -4476,6 +4661,7 @@ extern "C" {
         host->compressor.decompress         = NULL;
         host->compressor.destroy            = NULL;
         host->intercept                     = NULL;
+        host->batch                         = NULL;
 
         enet_list_clear(&host->dispatchQueue);
 
@@ -4496,8 +4682,22 @@ extern "C" {
         }
 
         return host;
+    } /* enet_host_create_socket */
+
+    ENetHost * enet_host_create(const ENetAddress *address, size_t peerCount, size_t channelLimit, enet_uint32 incomingBandwidth, enet_uint32 outgoingBandwidth) {
+        return enet_host_create_socket(address, peerCount, channelLimit, incomingBandwidth, outgoingBandwidth, 0);
     } /* enet_host_create */
 
+    /** Creates a host like enet_host_create whose socket shares its port with the other hosts created this way.
+     *  The kernel spreads the remote addresses across them, each remote address always reaching the same host,
+     *  so that every host can be serviced by its own thread.
+     *
+     *  @returns the host on success and NULL on failure, always NULL where SO_REUSEPORT is unavailable
+     */
+    ENetHost * enet_host_create_shared(const ENetAddress *address, size_t peerCount, size_t channelLimit, enet_uint32 incomingBandwidth, enet_uint32 outgoingBandwidth) {
+        return enet_host_create_socket(address, peerCount, channelLimit, incomingBandwidth, outgoingBandwidth, 1);
+    } /* enet_host_create_shared */
+
     /** Destroys the host and all resources associated with it.
      *  @param host pointer to the host to destroy
      */
@@ -4518,6 +4718,7 @@ extern "C" {
             (*host->compressor.destroy)(host->compressor.context);
         }
 
+        enet_free(host->batch);
         enet_free(host->peers);
         enet_free(host);
     }
@@ -4687,6 +4888,37 @@ extern "C" {
         }
     }
 
+    /** Enables batched datagram I/O on the host: incoming datagrams are drained
+     *  with recvmmsg and the datagrams of every peer are sent with sendmmsg.
+     *  @param host host to enable or disable batching for
+     *  @param batchSize maximum number of datagrams per system call, clamped to ENET_HOST_BATCH_MAXIMUM; if 0, then batching is disabled
+     *  @returns 0 on success, -1 if batching is not available on this platform, in which case the host keeps one system call per datagram
+     */
+    int enet_host_set_batching(ENetHost *host, size_t batchSize) {
+        if (host->batch != NULL) {
+            enet_protocol_flush_batch(host);
+            enet_free(host->batch);
+            host->batch = NULL;
+        }
+
+        if (batchSize == 0) {
+            return 0;
+        }
+
+        #ifdef ENET_HAS_MMSG
+        host->batch = (ENetHostBatch *) enet_malloc(sizeof(ENetHostBatch));
+        if (host->batch == NULL) {
+            return -1;
+        }
+
+        memset(host->batch, 0, sizeof(ENetHostBatch));
+        host->batch->capacity = ENET_MIN(batchSize, ENET_HOST_BATCH_MAXIMUM);
+        return 0;
+        #else
+        return -1;
+        #endif
+    }
+
     /** Limits the maximum allowed channels of future incoming connections.
      *  @param host host to limit
      *  @param channelLimit the maximum number of channels allowed; if 0, then this is equivalent to ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT
@@ -5453,6 +5685,12 @@ extern "C" {
                 result = setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, (char *)&value, sizeof(int));
                 break;
 
+#ifdef SO_REUSEPORT
+            case ENET_SOCKOPT_REUSEPORT:
+                result = setsockopt(socket, SOL_SOCKET, SO_REUSEPORT, (char *)&value, sizeof(int));
+                break;
+#endif
+
             case ENET_SOCKOPT_RCVBUF:
                 result = setsockopt(socket, SOL_SOCKET, SO_RCVBUF, (char *)&value, sizeof(int));
                 break;
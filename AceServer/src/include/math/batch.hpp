@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <math/box.hpp>
+#include <math/capsule.hpp>
+#include <math/ray.hpp>
+#include <math/simd.hpp>
+#include <math/sphere.hpp>
+#include <math/utils.hpp>
+#include <math/vector3.hpp>
+#include <vector>
+
+// Sphères rangées par composante (SoA) pour les tests par lot
+struct SphereSoA
+{
+  std::vector<float> cx, cy, cz, radius;
+
+  void Clear()
+  {
+    cx.clear();
+    cy.clear();
+    cz.clear();
+    radius.clear();
+  }
+
+  void Push(const Sphere& s)
+  {
+    cx.push_back(s.center.x);
+    cy.push_back(s.center.y);
+    cz.push_back(s.center.z);
+    radius.push_back(s.radius);
+  }
+
+  size_t Size() const { return cx.size(); }
+};
+
+// Segments rangés par composante (SoA)
+struct SegmentSoA
+{
+  std::vector<float> sx, sy, sz, ex, ey, ez;
+
+  void Clear()
+  {
+    sx.clear();
+    sy.clear();
+    sz.clear();
+    ex.clear();
+    ey.clear();
+    ez.clear();
+  }
+
+  void Push(const Vector3& start, const Vector3& end)
+  {
+    sx.push_back(start.x);
+    sy.push_back(start.y);
+    sz.push_back(start.z);
+    ex.push_back(end.x);
+    ey.push_back(end.y);
+    ez.push_back(end.z);
+  }
+
+  size_t Size() const { return sx.size(); }
+};
+
+// Capsules rangées par composante (SoA), un segment et un rayon
+struct CapsuleSoA : SegmentSoA
+{
+  std::vector<float> radius;
+
+  void Clear()
+  {
+    SegmentSoA::Clear();
+    radius.clear();
+  }
+
+  void Push(const Capsule& c)
+  {
+    SegmentSoA::Push(c.start, c.end);
+    radius.push_back(c.radius);
+  }
+};
+
+// Boites alignées rangées par composante (SoA), stockées en mins/maxs
+struct BoxSoA
+{
+  std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+
+  void Clear()
+  {
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+  }
+
+  void Push(const Box& b)
+  {
+    auto mins = b.Mins();
+    auto maxs = b.Maxs();
+    minX.push_back(mins.x);
+    minY.push_back(mins.y);
+    minZ.push_back(mins.z);
+    maxX.push_back(maxs.x);
+    maxY.push_back(maxs.y);
+    maxZ.push_back(maxs.z);
+  }
+
+  size_t Size() const { return minX.size(); }
+};
+
+// Tests d'un rayon, d'une boite ou d'un segment contre N cibles SoA, 4 ou 8
+// cibles par instruction selon le paquet F (voir math/simd.hpp), les cibles
+// restantes passent par FloatX1. Mêmes conventions que les versions AoS de
+// Ray, Box et Vector3, la direction du rayon doit être normalisée
+struct Batch
+{
+  // Distance d'entrée du rayon dans chaque sphère, 0 si l'origine est à
+  // l'intérieur, infini si elle est manquée: Batch::Intersects(r, spheres, t)
+  template<typename F = FloatXN>
+  static void Intersects(const Ray& r, const SphereSoA& spheres, float* t)
+  {
+    Run<F>(spheres.Size(), [&]<typename P>(size_t i) {
+      auto ox = P::Set(r.origin.x) - P::Load(&spheres.cx[i]);
+      auto oy = P::Set(r.origin.y) - P::Load(&spheres.cy[i]);
+      auto oz = P::Set(r.origin.z) - P::Load(&spheres.cz[i]);
+      auto radius = P::Load(&spheres.radius[i]);
+      SphereEntry(r, ox, oy, oz, radius * radius).Store(t + i);
+    });
+  }
+
+  // Distance d'entrée du rayon dans chaque capsule, 0 si l'origine est à
+  // l'intérieur, infini si elle est manquée: Batch::Intersects(r, caps, t)
+  template<typename F = FloatXN>
+  static void Intersects(const Ray& r, const CapsuleSoA& capsules, float* t)
+  {
+    Run<F>(capsules.Size(), [&]<typename P>(size_t i) {
+      auto zero = P::Set(0.f);
+      auto one = P::Set(1.f);
+      auto epsilon = P::Set(Epsilon<float>);
+      auto dx = P::Set(r.direction.x);
+      auto dy = P::Set(r.direction.y);
+      auto dz = P::Set(r.direction.z);
+      auto sx = P::Load(&capsules.sx[i]);
+      auto sy = P::Load(&capsules.sy[i]);
+      auto sz = P::Load(&capsules.sz[i]);
+      auto abx = P::Load(&capsules.ex[i]) - sx;
+      auto aby = P::Load(&capsules.ey[i]) - sy;
+      auto abz = P::Load(&capsules.ez[i]) - sz;
+      auto aox = P::Set(r.origin.x) - sx;
+      auto aoy = P::Set(r.origin.y) - sy;
+      auto aoz = P::Set(r.origin.z) - sz;
+      auto radius = P::Load(&capsules.radius[i]);
+      auto radiusSq = radius * radius;
+
+      // Même résolution que Ray::Intersects(r, capsule, ...): t' = t * m + n
+      // le long de AB, puis l'équation du cylindre infini en t
+      auto abDotAb = abx * abx + aby * aby + abz * abz;
+      auto invAbDotAb = one / Max(abDotAb, epsilon);
+      auto m = (abx * dx + aby * dy + abz * dz) * invAbDotAb;
+      auto n = (abx * aox + aby * aoy + abz * aoz) * invAbDotAb;
+      auto qx = dx - abx * m;
+      auto qy = dy - aby * m;
+      auto qz = dz - abz * m;
+      auto rx = aox - abx * n;
+      auto ry = aoy - aby * n;
+      auto rz = aoz - abz * n;
+      auto a = qx * qx + qy * qy + qz * qz;
+      auto b = P::Set(2.f) * (qx * rx + qy * ry + qz * rz);
+      auto c = rx * rx + ry * ry + rz * rz - radiusSq;
+      auto discriminant = b * b - P::Set(4.f) * a * c;
+      auto tCylinder = (zero - b - Sqrt(Max(discriminant, zero))) /
+                       (P::Set(2.f) * Max(a, epsilon));
+      auto k = tCylinder * m + n;
+      auto onCylinder = (a >= epsilon) & (discriminant >= zero) &
+                        (tCylinder >= zero) & (k >= zero) & (k <= one);
+
+      // Les extrémités sont deux sphères, parallèle ou non
+      auto bx = aox - abx;
+      auto by = aoy - aby;
+      auto bz = aoz - abz;
+      auto tEnds = Min(SphereEntry(r, aox, aoy, aoz, radiusSq),
+                       SphereEntry(r, bx, by, bz, radiusSq));
+      auto tEntry =
+        Min(Select(onCylinder, tCylinder, P::Set(Infinity)), tEnds);
+
+      // Origine à l'intérieur du cylindre, les sphères sont traitées avant
+      auto along = Min(Max(n, zero), one);
+      auto px = aox - abx * along;
+      auto py = aoy - aby * along;
+      auto pz = aoz - abz * along;
+      auto inside = px * px + py * py + pz * pz <= radiusSq;
+      Select(inside, zero, tEntry).Store(t + i);
+    });
+  }
+
+  // Renvoie le nombre de boites en intersection avec b, hits[i] vaut 1 pour
+  // chacune d'elles (intersection stricte comme Box::Intersects): size_t n =
+  // Batch::Intersects(b, boxes, hits)
+  template<typename F = FloatXN>
+  static size_t Intersects(const Box& b, const BoxSoA& boxes, uint8_t* hits)
+  {
+    auto mins = b.Mins();
+    auto maxs = b.Maxs();
+    auto count = size_t(0);
+    Run<F>(boxes.Size(), [&]<typename P>(size_t i) {
+      auto x = Max(P::Set(mins.x), P::Load(&boxes.minX[i])) <
+               Min(P::Set(maxs.x), P::Load(&boxes.maxX[i]));
+      auto y = Max(P::Set(mins.y), P::Load(&boxes.minY[i])) <
+               Min(P::Set(maxs.y), P::Load(&boxes.maxY[i]));
+      auto z = Max(P::Set(mins.z), P::Load(&boxes.minZ[i])) <
+               Min(P::Set(maxs.z), P::Load(&boxes.maxZ[i]));
+      auto bits = P::Bits(x & y & z);
+      for (auto lane = 0; lane < P::Width; lane++) {
+        hits[i + lane] = (bits >> lane) & 1;
+        count += (bits >> lane) & 1;
+      }
+    });
+    return count;
+  }
+
+  // Distance au carré entre le segment [start, end] et chaque segment, avec
+  // de façon optionnelle les paramètres des points les plus proches sur les
+  // deux segments, comme Vector3::ClosestPoint: Batch::ClosestPoint(s, e,
+  // segments, distSq, dist1, dist2)
+  template<typename F = FloatXN>
+  static void ClosestPoint(const Vector3& start,
+                           const Vector3& end,
+                           const SegmentSoA& segments,
+                           float* distSq,
+                           float* dist1 = nullptr,
+                           float* dist2 = nullptr)
+  {
+    auto d1 = end - start;
+    auto a = Vector3::DotProduct(d1, d1);
+    auto firstIsPoint = a <= Epsilon<float>;
+
+    Run<F>(segments.Size(), [&]<typename P>(size_t i) {
+      auto zero = P::Set(0.f);
+      auto one = P::Set(1.f);
+      auto epsilon = P::Set(Epsilon<float>);
+      auto d1x = P::Set(d1.x);
+      auto d1y = P::Set(d1.y);
+      auto d1z = P::Set(d1.z);
+      auto sx = P::Load(&segments.sx[i]);
+      auto sy = P::Load(&segments.sy[i]);
+      auto sz = P::Load(&segments.sz[i]);
+      auto d2x = P::Load(&segments.ex[i]) - sx;
+      auto d2y = P::Load(&segments.ey[i]) - sy;
+      auto d2z = P::Load(&segments.ez[i]) - sz;
+      auto rx = P::Set(start.x) - sx;
+      auto ry = P::Set(start.y) - sy;
+      auto rz = P::Set(start.z) - sz;
+      auto e = d2x * d2x + d2y * d2y + d2z * d2z;
+      auto f = d2x * rx + d2y * ry + d2z * rz;
+      auto secondIsPoint = e <= epsilon;
+      auto safeE = Select(secondIsPoint, one, e);
+      auto clamp = [&](P value) { return Min(Max(value, zero), one); };
+
+      // Les deux branches de Vector3::ClosestPoint sont calculées puis
+      // sélectionnées voie par voie, seul le premier segment est commun
+      auto s = zero;
+      auto u = zero;
+      if (firstIsPoint)
+        u = Select(secondIsPoint, zero, clamp(f / safeE));
+      else {
+        auto invA = P::Set(1.f / a);
+        auto c = d1x * rx + d1y * ry + d1z * rz;
+        auto b = d1x * d2x + d1y * d2y + d1z * d2z;
+        auto denom = P::Set(a) * e - b * b;
+        auto parallel = (denom >= zero) & (denom <= zero);
+        s = Select(parallel,
+                   zero,
+                   clamp((b * f - c * e) / Select(parallel, one, denom)));
+        u = (b * s + f) / safeE;
+        auto fromStart = clamp((zero - c) * invA);
+        auto fromEnd = clamp((b - c) * invA);
+        s = Select(u < zero, fromStart, Select(u > one, fromEnd, s));
+        u = clamp(u);
+        s = Select(secondIsPoint, fromStart, s);
+        u = Select(secondIsPoint, zero, u);
+      }
+
+      auto px = rx + d1x * s - d2x * u;
+      auto py = ry + d1y * s - d2y * u;
+      auto pz = rz + d1z * s - d2z * u;
+      (px * px + py * py + pz * pz).Store(distSq + i);
+      if (dist1 != nullptr)
+        s.Store(dist1 + i);
+      if (dist2 != nullptr)
+        u.Store(dist2 + i);
+    });
+  }
+
+  // Renvoie l'indice de la plus petite distance finie, ou count si aucune:
+  // size_t i = Batch::Closest(t, n)
+  static size_t Closest(const float* t, size_t count)
+  {
+    auto best = count;
+    auto distance = Infinity;
+    for (size_t i = 0; i < count; i++)
+      if (t[i] < distance) {
+        distance = t[i];
+        best = i;
+      }
+    return best;
+  }
+
+  static constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+private:
+  // Appelle le noyau par paquets de F::Width puis termine en scalaire
+  template<typename F, typename K>
+  static void Run(size_t count, K&& kernel)
+  {
+    auto i = size_t(0);
+    for (; i + F::Width <= count; i += F::Width)
+      kernel.template operator()<F>(i);
+    for (; i < count; i++)
+      kernel.template operator()<FloatX1>(i);
+  }
+
+  // Entrée du rayon dans une sphère, o étant origine - centre, comme
+  // Ray::Intersects(r, s, &intersection)
+  template<typename P>
+  static P SphereEntry(const Ray& r, P ox, P oy, P oz, P radiusSq)
+  {
+    auto zero = P::Set(0.f);
+    auto b = ox * P::Set(r.direction.x) + oy * P::Set(r.direction.y) +
+             oz * P::Set(r.direction.z);
+    auto c = ox * ox + oy * oy + oz * oz - radiusSq;
+    auto discriminant = b * b - c;
+    auto hit = (discriminant >= zero) & ((c <= zero) | (b <= zero));
+    auto t = Max(zero - b - Sqrt(Max(discriminant, zero)), zero);
+    return Select(hit, t, P::Set(Infinity));
+  }
+};
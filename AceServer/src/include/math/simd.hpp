@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ACE_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define ACE_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Paquets de flottants utilisés par les noyaux de math/batch.hpp: un même
+// noyau est écrit une seule fois puis instancié en scalaire (FloatX1), SSE
+// (FloatX4) ou AVX2 (FloatX8). Les masques sont le résultat des comparaisons
+// et servent à sélectionner les voies: Select(a < b, x, y)
+
+// Scalaire, sert de repli et de référence
+struct FloatX1
+{
+  static constexpr int Width = 1;
+  using Mask = bool;
+
+  float v;
+
+  static FloatX1 Load(const float* p) { return { *p }; }
+  static FloatX1 Set(float value) { return { value }; }
+  void Store(float* p) const { *p = v; }
+
+  friend FloatX1 operator+(FloatX1 a, FloatX1 b) { return { a.v + b.v }; }
+  friend FloatX1 operator-(FloatX1 a, FloatX1 b) { return { a.v - b.v }; }
+  friend FloatX1 operator*(FloatX1 a, FloatX1 b) { return { a.v * b.v }; }
+  friend FloatX1 operator/(FloatX1 a, FloatX1 b) { return { a.v / b.v }; }
+  friend Mask operator<(FloatX1 a, FloatX1 b) { return a.v < b.v; }
+  friend Mask operator<=(FloatX1 a, FloatX1 b) { return a.v <= b.v; }
+  friend Mask operator>(FloatX1 a, FloatX1 b) { return a.v > b.v; }
+  friend Mask operator>=(FloatX1 a, FloatX1 b) { return a.v >= b.v; }
+
+  friend FloatX1 Min(FloatX1 a, FloatX1 b) { return { std::min(a.v, b.v) }; }
+  friend FloatX1 Max(FloatX1 a, FloatX1 b) { return { std::max(a.v, b.v) }; }
+  friend FloatX1 Sqrt(FloatX1 a) { return { std::sqrt(a.v) }; }
+  friend FloatX1 Select(Mask m, FloatX1 a, FloatX1 b) { return m ? a : b; }
+
+  static uint32_t Bits(Mask m) { return m ? 1u : 0u; }
+};
+
+#ifdef ACE_SIMD_SSE
+struct MaskX4
+{
+  __m128 v;
+
+  friend MaskX4 operator&(MaskX4 a, MaskX4 b)
+  {
+    return { _mm_and_ps(a.v, b.v) };
+  }
+  friend MaskX4 operator|(MaskX4 a, MaskX4 b)
+  {
+    return { _mm_or_ps(a.v, b.v) };
+  }
+};
+
+// SSE2 uniquement, pas de blendv ni de FMA
+struct FloatX4
+{
+  static constexpr int Width = 4;
+  using Mask = MaskX4;
+
+  __m128 v;
+
+  static FloatX4 Load(const float* p) { return { _mm_loadu_ps(p) }; }
+  static FloatX4 Set(float value) { return { _mm_set1_ps(value) }; }
+  void Store(float* p) const { _mm_storeu_ps(p, v); }
+
+  friend FloatX4 operator+(FloatX4 a, FloatX4 b)
+  {
+    return { _mm_add_ps(a.v, b.v) };
+  }
+  friend FloatX4 operator-(FloatX4 a, FloatX4 b)
+  {
+    return { _mm_sub_ps(a.v, b.v) };
+  }
+  friend FloatX4 operator*(FloatX4 a, FloatX4 b)
+  {
+    return { _mm_mul_ps(a.v, b.v) };
+  }
+  friend FloatX4 operator/(FloatX4 a, FloatX4 b)
+  {
+    return { _mm_div_ps(a.v, b.v) };
+  }
+  friend Mask operator<(FloatX4 a, FloatX4 b)
+  {
+    return { _mm_cmplt_ps(a.v, b.v) };
+  }
+  friend Mask operator<=(FloatX4 a, FloatX4 b)
+  {
+    return { _mm_cmple_ps(a.v, b.v) };
+  }
+  friend Mask operator>(FloatX4 a, FloatX4 b)
+  {
+    return { _mm_cmpgt_ps(a.v, b.v) };
+  }
+  friend Mask operator>=(FloatX4 a, FloatX4 b)
+  {
+    return { _mm_cmpge_ps(a.v, b.v) };
+  }
+
+  friend FloatX4 Min(FloatX4 a, FloatX4 b) { return { _mm_min_ps(a.v, b.v) }; }
+  friend FloatX4 Max(FloatX4 a, FloatX4 b) { return { _mm_max_ps(a.v, b.v) }; }
+  friend FloatX4 Sqrt(FloatX4 a) { return { _mm_sqrt_ps(a.v) }; }
+  friend FloatX4 Select(Mask m, FloatX4 a, FloatX4 b)
+  {
+    return { _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)) };
+  }
+
+  static uint32_t Bits(Mask m)
+  {
+    return static_cast<uint32_t>(_mm_movemask_ps(m.v));
+  }
+};
+#endif
+
+#ifdef ACE_SIMD_AVX2
+struct MaskX8
+{
+  __m256 v;
+
+  friend MaskX8 operator&(MaskX8 a, MaskX8 b)
+  {
+    return { _mm256_and_ps(a.v, b.v) };
+  }
+  friend MaskX8 operator|(MaskX8 a, MaskX8 b)
+  {
+    return { _mm256_or_ps(a.v, b.v) };
+  }
+};
+
+struct FloatX8
+{
+  static constexpr int Width = 8;
+  using Mask = MaskX8;
+
+  __m256 v;
+
+  static FloatX8 Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+  static FloatX8 Set(float value) { return { _mm256_set1_ps(value) }; }
+  void Store(float* p) const { _mm256_storeu_ps(p, v); }
+
+  friend FloatX8 operator+(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_add_ps(a.v, b.v) };
+  }
+  friend FloatX8 operator-(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_sub_ps(a.v, b.v) };
+  }
+  friend FloatX8 operator*(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_mul_ps(a.v, b.v) };
+  }
+  friend FloatX8 operator/(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_div_ps(a.v, b.v) };
+  }
+  friend Mask operator<(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) };
+  }
+  friend Mask operator<=(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) };
+  }
+  friend Mask operator>(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) };
+  }
+  friend Mask operator>=(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) };
+  }
+
+  friend FloatX8 Min(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_min_ps(a.v, b.v) };
+  }
+  friend FloatX8 Max(FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_max_ps(a.v, b.v) };
+  }
+  friend FloatX8 Sqrt(FloatX8 a) { return { _mm256_sqrt_ps(a.v) }; }
+  friend FloatX8 Select(Mask m, FloatX8 a, FloatX8 b)
+  {
+    return { _mm256_blendv_ps(b.v, a.v, m.v) };
+  }
+
+  static uint32_t Bits(Mask m)
+  {
+    return static_cast<uint32_t>(_mm256_movemask_ps(m.v));
+  }
+};
+#endif
+
+// Paquet le plus large disponible pour la cible de compilation
+#if defined(ACE_SIMD_AVX2)
+using FloatXN = FloatX8;
+#elif defined(ACE_SIMD_SSE)
+using FloatXN = FloatX4;
+#else
+using FloatXN = FloatX1;
+#endif
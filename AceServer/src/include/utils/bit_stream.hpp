@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+constexpr int
+BitsRequired(uint32_t maxValue)
+{
+  auto bits = 0;
+  while (maxValue > 0) {
+    bits++;
+    maxValue >>= 1;
+  }
+  return bits;
+}
+
+// Size of WriteVarUint's output, in bits
+constexpr int
+VarUintBits(uint32_t value)
+{
+  auto bits = 8;
+  for (; value >= 0x80; value >>= 7)
+    bits += 8;
+  return bits;
+}
+
+constexpr uint32_t
+ZigZagEncode(int32_t value)
+{
+  return (static_cast<uint32_t>(value) << 1) ^
+         static_cast<uint32_t>(value >> 31);
+}
+
+constexpr int32_t
+ZigZagDecode(uint32_t value)
+{
+  return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+inline uint32_t
+QuantizeFloat(float value, float min, float max, int bits)
+{
+  auto steps = static_cast<float>((1ull << bits) - 1);
+  auto normalized = (std::clamp(value, min, max) - min) / (max - min);
+  return static_cast<uint32_t>(std::lround(normalized * steps));
+}
+
+inline float
+DequantizeFloat(uint32_t value, float min, float max, int bits)
+{
+  auto steps = static_cast<float>((1ull << bits) - 1);
+  return min + (max - min) * (static_cast<float>(value) / steps);
+}
+
+// Bits are packed LSB first and flushed byte by byte, so the stream layout
+// does not depend on the host endianness
+class BitWriter
+{
+public:
+  BitWriter(uint8_t* data, size_t capacity)
+    : Data(data)
+    , Capacity(capacity)
+  {
+  }
+
+  void WriteBits(uint32_t value, int bits)
+  {
+    if (bits < 32)
+      value &= (1u << bits) - 1;
+    Scratch |= static_cast<uint64_t>(value) << ScratchBits;
+    ScratchBits += bits;
+    while (ScratchBits >= 8) {
+      PutByte(static_cast<uint8_t>(Scratch));
+      Scratch >>= 8;
+      ScratchBits -= 8;
+    }
+  }
+
+  void WriteBool(bool value) { WriteBits(value ? 1 : 0, 1); }
+  void WriteU8(uint8_t value) { WriteBits(value, 8); }
+  void WriteU16(uint16_t value) { WriteBits(value, 16); }
+  void WriteU32(uint32_t value) { WriteBits(value, 32); }
+  void WriteI32(int32_t value) { WriteBits(static_cast<uint32_t>(value), 32); }
+
+  void WriteVarUint(uint32_t value)
+  {
+    while (value >= 0x80) {
+      WriteBits((value & 0x7F) | 0x80, 8);
+      value >>= 7;
+    }
+    WriteBits(value, 8);
+  }
+
+  void WriteVarInt(int32_t value) { WriteVarUint(ZigZagEncode(value)); }
+
+  void WriteFloat(float value)
+  {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteBits(bits, 32);
+  }
+
+  void WriteQuantizedFloat(float value, float min, float max, int bits)
+  {
+    WriteBits(QuantizeFloat(value, min, max, bits), bits);
+  }
+
+  void WriteString(const std::string& value)
+  {
+    WriteVarUint(static_cast<uint32_t>(value.size()));
+    for (auto c : value)
+      WriteBits(static_cast<uint8_t>(c), 8);
+  }
+
+  void AlignToByte()
+  {
+    if (ScratchBits > 0)
+      WriteBits(0, 8 - ScratchBits);
+  }
+
+  // Pads the last partial byte and returns the number of bytes written
+  size_t Flush()
+  {
+    AlignToByte();
+    return Size;
+  }
+
+  size_t GetBitsWritten() const { return Size * 8 + ScratchBits; }
+  bool Overflowed() const { return Overflow; }
+
+private:
+  void PutByte(uint8_t byte)
+  {
+    if (Size >= Capacity) {
+      Overflow = true;
+      return;
+    }
+    Data[Size++] = byte;
+  }
+
+  uint8_t* Data;
+  size_t Capacity;
+  size_t Size = 0;
+  uint64_t Scratch = 0;
+  int ScratchBits = 0;
+  bool Overflow = false;
+};
+
+// Reading past the end of the buffer yields zeros and latches Overflowed(),
+// callers validate once after unserializing instead of after every field
+class BitReader
+{
+public:
+  BitReader(const uint8_t* data, size_t size)
+    : Data(data)
+    , Size(size)
+  {
+  }
+
+  uint32_t ReadBits(int bits)
+  {
+    while (ScratchBits < bits) {
+      uint8_t byte = 0;
+      if (Offset < Size)
+        byte = Data[Offset++];
+      else
+        Overflow = true;
+      Scratch |= static_cast<uint64_t>(byte) << ScratchBits;
+      ScratchBits += 8;
+    }
+    auto value = static_cast<uint32_t>(Scratch);
+    if (bits < 32)
+      value &= (1u << bits) - 1;
+    Scratch >>= bits;
+    ScratchBits -= bits;
+    return value;
+  }
+
+  bool ReadBool() { return ReadBits(1) != 0; }
+  uint8_t ReadU8() { return static_cast<uint8_t>(ReadBits(8)); }
+  uint16_t ReadU16() { return static_cast<uint16_t>(ReadBits(16)); }
+  uint32_t ReadU32() { return ReadBits(32); }
+  int32_t ReadI32() { return static_cast<int32_t>(ReadBits(32)); }
+
+  uint32_t ReadVarUint()
+  {
+    auto value = uint32_t();
+    for (auto shift = 0; shift < 35; shift += 7) {
+      auto byte = ReadBits(8);
+      value |= (byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    Overflow = true;
+    return value;
+  }
+
+  int32_t ReadVarInt() { return ZigZagDecode(ReadVarUint()); }
+
+  float ReadFloat()
+  {
+    auto bits = ReadBits(32);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  float ReadQuantizedFloat(float min, float max, int bits)
+  {
+    return DequantizeFloat(ReadBits(bits), min, max, bits);
+  }
+
+  std::string ReadString()
+  {
+    auto length = ReadVarUint();
+    if (length > GetBytesRemaining()) {
+      Overflow = true;
+      return {};
+    }
+    auto value = std::string(length, ' ');
+    for (auto& c : value)
+      c = static_cast<char>(ReadBits(8));
+    return value;
+  }
+
+  void AlignToByte()
+  {
+    Scratch >>= ScratchBits % 8;
+    ScratchBits -= ScratchBits % 8;
+  }
+
+  size_t GetBytesRemaining() const
+  {
+    return Size - Offset + ScratchBits / 8;
+  }
+  bool Overflowed() const { return Overflow; }
+
+private:
+  const uint8_t* Data;
+  size_t Size;
+  size_t Offset = 0;
+  uint64_t Scratch = 0;
+  int ScratchBits = 0;
+  bool Overflow = false;
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork/join job system with one deque per thread. Owners pop from the back of
+// their own deque while idle threads steal from the front of the others. The
+// thread calling ParallelFor takes part in the work and only returns once
+// every job of the batch has completed, which makes each call a full barrier
+class JobSystem
+{
+public:
+  explicit JobSystem(unsigned threadCount)
+  {
+    threadCount = std::max(threadCount, 1u);
+    for (auto i = 0u; i < threadCount; i++)
+      Queues.push_back(std::make_unique<WorkerQueue>());
+    for (auto i = 1u; i < threadCount; i++)
+      Workers.emplace_back([this, i] { WorkerLoop(i); });
+  }
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  ~JobSystem()
+  {
+    {
+      auto lock = std::lock_guard(SleepMutex);
+      Stopping = true;
+    }
+    WakeUp.notify_all();
+    for (auto& worker : Workers)
+      worker.join();
+  }
+
+  unsigned GetThreadCount() const
+  {
+    return static_cast<unsigned>(Queues.size());
+  }
+
+  // Calls func(begin, end) over [0, count) split in chunks of grainSize
+  template<typename F>
+  void ParallelFor(size_t count, size_t grainSize, F func)
+  {
+    if (count == 0)
+      return;
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (Queues.size() == 1 || count <= grainSize) {
+      func(size_t(0), count);
+      return;
+    }
+
+    auto invoke = [](void* context, size_t begin, size_t end) {
+      (*static_cast<F*>(context))(begin, end);
+    };
+    auto pending = std::atomic<size_t>((count + grainSize - 1) / grainSize);
+    auto queueIndex = size_t();
+    for (auto begin = size_t(); begin < count; begin += grainSize) {
+      auto end = std::min(begin + grainSize, count);
+      auto job = Job{ invoke, &func, begin, end, &pending };
+      auto& queue = *Queues[queueIndex++ % Queues.size()];
+      auto lock = std::lock_guard(queue.Mutex);
+      queue.Jobs.push_back(job);
+    }
+    {
+      auto lock = std::lock_guard(SleepMutex);
+      Generation++;
+    }
+    WakeUp.notify_all();
+
+    while (pending.load(std::memory_order_acquire) > 0)
+      if (!RunOne(0))
+        std::this_thread::yield();
+  }
+
+private:
+  struct Job
+  {
+    void (*Invoke)(void*, size_t, size_t);
+    void* Context;
+    size_t Begin;
+    size_t End;
+    std::atomic<size_t>* Pending;
+  };
+
+  struct WorkerQueue
+  {
+    std::mutex Mutex;
+    std::deque<Job> Jobs;
+  };
+
+  bool PopOwn(size_t index, Job& job)
+  {
+    auto& queue = *Queues[index];
+    auto lock = std::lock_guard(queue.Mutex);
+    if (queue.Jobs.empty())
+      return false;
+    job = queue.Jobs.back();
+    queue.Jobs.pop_back();
+    return true;
+  }
+
+  bool Steal(size_t thief, Job& job)
+  {
+    for (auto i = size_t(1); i < Queues.size(); i++) {
+      auto& queue = *Queues[(thief + i) % Queues.size()];
+      auto lock = std::unique_lock(queue.Mutex, std::try_to_lock);
+      if (!lock.owns_lock() || queue.Jobs.empty())
+        continue;
+      job = queue.Jobs.front();
+      queue.Jobs.pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  bool RunOne(size_t index)
+  {
+    auto job = Job();
+    if (!PopOwn(index, job) && !Steal(index, job))
+      return false;
+    job.Invoke(job.Context, job.Begin, job.End);
+    job.Pending->fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+
+  void WorkerLoop(size_t index)
+  {
+    while (true) {
+      auto generation = uint64_t();
+      {
+        auto lock = std::lock_guard(SleepMutex);
+        if (Stopping)
+          return;
+        generation = Generation;
+      }
+      if (RunOne(index))
+        continue;
+      auto lock = std::unique_lock(SleepMutex);
+      WakeUp.wait(lock,
+                  [&] { return Stopping || Generation != generation; });
+    }
+  }
+
+  std::vector<std::unique_ptr<WorkerQueue>> Queues;
+  std::vector<std::thread> Workers;
+  std::mutex SleepMutex;
+  std::condition_variable WakeUp;
+  uint64_t Generation = 0;
+  bool Stopping = false;
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+enum class RingOverflow
+{
+  // Push fails and the new item is lost
+  Reject,
+  // The oldest queued item is evicted to make room for the new one
+  DropOldest,
+  // Overflowing items collapse into a single pending item (newest wins) that
+  // is published by the next Push or Flush once the consumer made room
+  Coalesce
+};
+
+// Fixed capacity single producer / single consumer ring buffer. The producer
+// only writes Tail and the consumer only writes Head, except for DropOldest
+// evictions which race the consumer on Head with a CAS. A consumer copy torn
+// by a concurrent eviction is thrown away when its CAS fails, so DropOldest
+// across threads is only meant for trivially copyable items
+template<typename T,
+         size_t Capacity,
+         RingOverflow Policy = RingOverflow::Reject>
+class RingBuffer
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  RingBuffer() = default;
+
+  // Copies are not synchronized, they are only meant for containers of
+  // buffers being reallocated while neither side is running
+  RingBuffer(const RingBuffer& other) { *this = other; }
+
+  RingBuffer& operator=(const RingBuffer& other)
+  {
+    if (this == &other)
+      return *this;
+    auto head = other.Head.load(std::memory_order_acquire);
+    auto tail = other.Tail.load(std::memory_order_acquire);
+    for (auto i = head; i != tail; i++)
+      Slots[i & Mask] = other.Slots[i & Mask];
+    Pending = other.Pending;
+    Head.store(head, std::memory_order_relaxed);
+    Tail.store(tail, std::memory_order_release);
+    return *this;
+  }
+
+  // Producer side
+
+  bool Push(const T& item) { return Emplace(item); }
+  bool Push(T&& item) { return Emplace(std::move(item)); }
+
+  // Publishes the coalesced item if there is room for it
+  bool Flush()
+  {
+    if constexpr (Policy == RingOverflow::Coalesce) {
+      if (!Pending)
+        return true;
+      auto tail = Tail.load(std::memory_order_relaxed);
+      if (tail - Head.load(std::memory_order_acquire) >= Capacity)
+        return false;
+      Slots[tail & Mask] = std::move(*Pending);
+      Pending.reset();
+      Tail.store(tail + 1, std::memory_order_release);
+    }
+    return true;
+  }
+
+  // Consumer side
+
+  size_t Size() const
+  {
+    return Tail.load(std::memory_order_acquire) -
+           Head.load(std::memory_order_acquire);
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+  // Index 0 is the oldest item, valid for i < Size()
+  T& operator[](size_t i)
+  {
+    return Slots[(Head.load(std::memory_order_relaxed) + i) & Mask];
+  }
+  const T& operator[](size_t i) const
+  {
+    return Slots[(Head.load(std::memory_order_relaxed) + i) & Mask];
+  }
+
+  T& Front() { return (*this)[0]; }
+  const T& Front() const { return (*this)[0]; }
+
+  bool Pop() { return Pop(nullptr); }
+  bool Pop(T& item) { return Pop(&item); }
+
+  void Clear()
+  {
+    while (Pop()) {
+    }
+  }
+
+private:
+  static constexpr size_t Mask = Capacity - 1;
+
+  template<typename U>
+  bool Emplace(U&& item)
+  {
+    if (!Flush()) {
+      Pending = std::forward<U>(item);
+      return true;
+    }
+
+    auto tail = Tail.load(std::memory_order_relaxed);
+    auto head = Head.load(std::memory_order_acquire);
+    if (tail - head >= Capacity) {
+      if constexpr (Policy == RingOverflow::Reject)
+        return false;
+      else if constexpr (Policy == RingOverflow::Coalesce) {
+        Pending = std::forward<U>(item);
+        return true;
+      } else {
+        // Losing the CAS means the consumer just made room itself
+        Head.compare_exchange_strong(
+          head, head + 1, std::memory_order_acq_rel);
+      }
+    }
+    Slots[tail & Mask] = std::forward<U>(item);
+    Tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Pop(T* item)
+  {
+    auto head = Head.load(std::memory_order_relaxed);
+    while (true) {
+      if (head == Tail.load(std::memory_order_acquire))
+        return false;
+      if constexpr (Policy != RingOverflow::DropOldest) {
+        if (item != nullptr)
+          *item = std::move(Slots[head & Mask]);
+        Head.store(head + 1, std::memory_order_release);
+        return true;
+      } else {
+        auto value = std::optional<T>();
+        if (item != nullptr)
+          value = Slots[head & Mask];
+        if (Head.compare_exchange_weak(
+              head, head + 1, std::memory_order_acq_rel)) {
+          if (item != nullptr)
+            *item = std::move(*value);
+          return true;
+        }
+      }
+    }
+  }
+
+  std::array<T, Capacity> Slots{};
+  std::optional<T> Pending;
+  alignas(64) std::atomic<size_t> Head = 0;
+  alignas(64) std::atomic<size_t> Tail = 0;
+};